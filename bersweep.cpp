@@ -0,0 +1,759 @@
+#include "bersweep.h"
+
+#include "channelmodule.h"
+#include "nco.h"
+
+#include <QMutexLocker>
+#include <QRandomGenerator>
+#include <QtMath>
+#include <QWaitCondition>
+#include <atomic>
+#include <deque>
+#include <limits>
+#include <map>
+#include <thread>
+#include <vector>
+
+// 星座归一化系数, 与 Modulator 相同
+static const double QPSK_SCALE = 0.70710678118654752440;
+static const double QAM16_SCALE = 0.31622776601683793320;
+
+// 无噪声时判决点的信噪比至少要达到这个值, 否则成形滤波器截断引入的码间干扰会影响误码率
+static const double MIN_CLEAN_SNR_DB = 25.0;
+
+// 比特源位置的种子与噪声种子取自不同的序列
+static const quint64 BIT_SEED_SALT = Q_UINT64_C(0xD1B54A32D192ED03);
+
+// SplitMix64, 由扫描种子和点的序号得到该点的噪声种子
+static quint64 mixSeed(quint64 seed, quint64 index)
+{
+    quint64 z = seed + (index + 1) * Q_UINT64_C(0x9E3779B97F4A7C15);
+    z = (z ^ (z >> 30)) * Q_UINT64_C(0xBF58476D1CE4E5B9);
+    z = (z ^ (z >> 27)) * Q_UINT64_C(0x94D049BB133111EB);
+    return z ^ (z >> 31);
+}
+
+// 四路累加, 编译器可以向量化
+static double dotProduct(const double *a, const double *b, int length)
+{
+    double sum0 = 0.0;
+    double sum1 = 0.0;
+    double sum2 = 0.0;
+    double sum3 = 0.0;
+    int i = 0;
+    for (; i + 4 <= length; i += 4) {
+        sum0 += a[i] * b[i];
+        sum1 += a[i + 1] * b[i + 1];
+        sum2 += a[i + 2] * b[i + 2];
+        sum3 += a[i + 3] * b[i + 3];
+    }
+    for (; i < length; ++i) {
+        sum0 += a[i] * b[i];
+    }
+    return (sum0 + sum1) + (sum2 + sum3);
+}
+
+// 16-QAM 每个分量2比特格雷码: 00 -> -3, 01 -> -1, 11 -> +1, 10 -> +3 (第一个比特为符号)
+static quint8 decideQam16(double value)
+{
+    const double u = value / QAM16_SCALE;
+    return static_cast<quint8>((u > 0.0 ? 1 : 0) | (std::fabs(u) < 2.0 ? 2 : 0));
+}
+
+static double qam16Level(quint8 bits)
+{
+    return ((bits & 1) ? 1.0 : -1.0) * ((bits & 2) ? 1.0 : 3.0) * QAM16_SCALE;
+}
+
+// 判决: 按 Modulator::nextSymbol 的映射得到比特, 第一个比特在最低位
+static quint8 decide(Modulator::Scheme scheme, double i, double q)
+{
+    switch (scheme) {
+        case Modulator::QPSK:
+            return static_cast<quint8>((i < 0.0 ? 1 : 0) | (q < 0.0 ? 2 : 0));
+        case Modulator::QAM16:
+            return static_cast<quint8>(decideQam16(i) | (decideQam16(q) << 2));
+        default:
+            return i < 0.0 ? 1 : 0;
+    }
+}
+
+// 比特对应的理想星座点
+static void constellationPoint(Modulator::Scheme scheme, quint8 bits, double &i, double &q)
+{
+    switch (scheme) {
+        case Modulator::QPSK:
+            i = (bits & 1) ? -QPSK_SCALE : QPSK_SCALE;
+            q = (bits & 2) ? -QPSK_SCALE : QPSK_SCALE;
+            break;
+        case Modulator::QAM16:
+            i = qam16Level(bits & 3);
+            q = qam16Level(bits >> 2);
+            break;
+        default:
+            i = (bits & 1) ? -1.0 : 1.0;
+            q = 0.0;
+            break;
+    }
+}
+
+// Wilson 置信区间
+static void wilsonInterval(qint64 errors, qint64 trials, double z, double &lower, double &upper)
+{
+    if (trials <= 0) {
+        lower = 0.0;
+        upper = 1.0;
+        return;
+    }
+    const double n = static_cast<double>(trials);
+    const double p = errors / n;
+    const double z2 = z * z;
+    const double denominator = 1.0 + z2 / n;
+    const double center = (p + z2 / (2.0 * n)) / denominator;
+    const double halfWidth = z * std::sqrt(p * (1.0 - p) / n + z2 / (4.0 * n * n)) / denominator;
+    lower = qMax(0.0, center - halfWidth);
+    upper = qMin(1.0, center + halfWidth);
+}
+
+// 双侧置信水平对应的标准正态分位数, 二分求解 erfc(z / sqrt(2)) = 1 - confidence
+static double zScore(double confidence)
+{
+    double low = 0.0;
+    double high = 10.0;
+    for (int i = 0; i < 64; ++i) {
+        const double middle = 0.5 * (low + high);
+        if (std::erfc(middle / std::sqrt(2.0)) > 1.0 - confidence) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+    }
+    return 0.5 * (low + high);
+}
+
+static double toDb(double ratio)
+{
+    return ratio > 0.0 ? 10.0 * std::log10(ratio) : -std::numeric_limits<double>::infinity();
+}
+
+namespace {
+
+// 一次试验: 某个点的第 trial 次
+struct Task {
+    int point;
+    qint64 trial;
+};
+
+// 工作窃取队列: 每个线程一个双端队列, 自己从尾部取 (后进先出, 刚派发的试验对应的波形还在缓存中),
+// 窃取时从其他线程队列的头部取
+class TaskQueues
+{
+public:
+    explicit TaskQueues(int count) : m_queues(static_cast<size_t>(count)) {}
+
+    void push(int owner, const Task &task)
+    {
+        Queue &queue = m_queues[static_cast<size_t>(owner)];
+        QMutexLocker locker(&queue.mutex);
+        queue.tasks.push_back(task);
+    }
+
+    bool isEmpty()
+    {
+        for (Queue &queue : m_queues) {
+            QMutexLocker locker(&queue.mutex);
+            if (!queue.tasks.empty()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool pop(int owner, Task &task)
+    {
+        const int count = static_cast<int>(m_queues.size());
+        for (int k = 0; k < count; ++k) {
+            const int index = (owner + k) % count;
+            Queue &queue = m_queues[static_cast<size_t>(index)];
+            QMutexLocker locker(&queue.mutex);
+            if (queue.tasks.empty()) {
+                continue;
+            }
+            if (k == 0) {
+                task = queue.tasks.back();
+                queue.tasks.pop_back();
+            } else {
+                task = queue.tasks.front();
+                queue.tasks.pop_front();
+            }
+            return true;
+        }
+        return false;
+    }
+
+private:
+    struct Queue {
+        QMutex mutex;
+        std::deque<Task> tasks;
+    };
+    std::vector<Queue> m_queues;
+};
+
+} // namespace
+
+BerSweep::Settings::Settings() :
+    schemes({ Modulator::BPSK }),
+    symbolRates({ 100.0 }),
+    noiseAmplitudes({ 1000.0 }),
+    samplingRate(1000.0),
+    carrierFrequency(100.0),
+    amplitude(1000.0),
+    rollOff(0.35),
+    filterSpan(8),
+    bitSource(Modulator::PRBS15),
+    symbolsPerTrial(4096),
+    minBitErrors(100),
+    relativePrecision(0.2),
+    confidence(0.95),
+    maxBitsPerPoint(100000000),
+    seed(QRandomGenerator::global()->generate64()),
+    threadCount(0)
+{
+}
+
+BerSweep::PointResult::PointResult() :
+    scheme(Modulator::BPSK),
+    symbolRate(0.0),
+    noiseAmplitude(0.0),
+    snrDb(0.0),
+    ebN0Db(0.0),
+    measuredSnrDb(0.0),
+    trials(0),
+    bits(0),
+    bitErrors(0),
+    symbols(0),
+    symbolErrors(0),
+    ber(0.0),
+    berLower(0.0),
+    berUpper(1.0),
+    converged(false)
+{
+}
+
+BerSweep::BerSweep(QObject *parent) : QThread(parent),
+    m_zScore(zScore(0.95))
+{
+}
+
+BerSweep::~BerSweep()
+{
+    requestInterruption();
+    wait();
+}
+
+bool BerSweep::setSettings(const Settings &settings)
+{
+    if (isRunning()) {
+        m_errorString = "扫描正在运行";
+        return false;
+    }
+    if (settings.schemes.isEmpty() || settings.symbolRates.isEmpty() || settings.noiseAmplitudes.isEmpty()) {
+        m_errorString = "调制方式, 符号率和噪声幅度都至少需要一个取值";
+        return false;
+    }
+    for (Modulator::Scheme scheme : settings.schemes) {
+        if (scheme != Modulator::BPSK && scheme != Modulator::QPSK && scheme != Modulator::QAM16) {
+            m_errorString = "误码率扫描只支持 BPSK, QPSK 和 16-QAM";
+            return false;
+        }
+    }
+    for (double amplitude : settings.noiseAmplitudes) {
+        if (amplitude < 0.0) {
+            m_errorString = "噪声幅度不能为负";
+            return false;
+        }
+    }
+    if (settings.samplingRate <= 0.0 || settings.symbolsPerTrial <= 0 || settings.maxBitsPerPoint <= 0 ||
+        settings.relativePrecision <= 0.0 || settings.confidence <= 0.0 || settings.confidence >= 1.0) {
+        m_errorString = "扫描参数超出范围";
+        return false;
+    }
+
+    m_settings = settings;
+    m_zScore = zScore(settings.confidence);
+    m_waveforms.clear();
+    for (Modulator::Scheme scheme : settings.schemes) {
+        for (double symbolRate : settings.symbolRates) {
+            Waveform waveform;
+            if (!prepareWaveform(scheme, symbolRate, waveform)) {
+                m_waveforms.clear();
+                return false;
+            }
+            m_waveforms.append(waveform);
+        }
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_results.resize(getPointCount());
+    for (int point = 0; point < m_results.size(); ++point) {
+        m_results[point] = makeResult(point, 0, TrialResult{ 0, 0, 0.0, 0.0 }, false);
+    }
+    m_errorString.clear();
+    return true;
+}
+
+BerSweep::Settings BerSweep::getSettings() const
+{
+    return m_settings;
+}
+
+QString BerSweep::errorString() const
+{
+    return m_errorString;
+}
+
+int BerSweep::getPointCount() const
+{
+    return m_waveforms.size() * m_settings.noiseAmplitudes.size();
+}
+
+BerSweep::PointResult BerSweep::getResult(int index) const
+{
+    QMutexLocker locker(&m_mutex);
+    return index >= 0 && index < m_results.size() ? m_results[index] : PointResult();
+}
+
+QVector<BerSweep::PointResult> BerSweep::getResults() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_results;
+}
+
+QString BerSweep::schemeName(Modulator::Scheme scheme)
+{
+    switch (scheme) {
+        case Modulator::AM: return "AM";
+        case Modulator::FM: return "FM";
+        case Modulator::BPSK: return "BPSK";
+        case Modulator::QPSK: return "QPSK";
+        case Modulator::QAM16: return "16-QAM";
+    }
+    return QString();
+}
+
+bool BerSweep::prepareWaveform(Modulator::Scheme scheme, double symbolRate, Waveform &waveform)
+{
+    const Settings &settings = m_settings;
+
+    // 已调信号占据 [fc - B, fc + B], B = (1 + 滚降) * 符号率 / 2; 下变频后 2fc 处的镜像由匹配滤波器滤除
+    const double halfBandwidth = (1.0 + settings.rollOff) * symbolRate / 2.0;
+    if (symbolRate <= 0.0 || settings.carrierFrequency - halfBandwidth <= 0.0 ||
+        settings.carrierFrequency + halfBandwidth >= settings.samplingRate / 2.0) {
+        m_errorString = QString("载波 %1 Hz 容纳不下符号率 %2 Hz 的已调信号 (采样率 %3 Hz)")
+                            .arg(settings.carrierFrequency).arg(symbolRate).arg(settings.samplingRate);
+        return false;
+    }
+
+    Modulator modulator;
+    configureModulator(modulator, scheme, symbolRate);
+
+    const int sps = modulator.getSamplesPerSymbol();
+    waveform.scheme = scheme;
+    waveform.symbolRate = modulator.getSymbolRate();
+    waveform.samplesPerSymbol = sps;
+    waveform.taps = modulator.getFilterTaps();
+
+    // 最后一个符号的判决点在 (symbolsPerTrial - 1) * sps + 滤波器长度 - 1
+    const int numSamples = settings.symbolsPerTrial * sps + waveform.taps.size();
+    waveform.numSamples = numSamples;
+
+    // 用第0次试验的波形估计信号功率, 判决点的幅度和无噪声时的信噪比
+    QVector<double> signal(numSamples);
+    modulate(modulator, waveform, 0, signal.data());
+
+    double power = 0.0;
+    for (double sample : signal) {
+        power += sample * sample;
+    }
+    waveform.signalPower = power / numSamples;
+
+    // 调制器的载波相位从0开始, 每个样本前进相同的整数相位
+    const quint64 increment = cyclesToPhase(settings.carrierFrequency / settings.samplingRate);
+    waveform.carrierI.resize(numSamples);
+    waveform.carrierQ.resize(numSamples);
+    quint64 phase = 0;
+    for (int n = 0; n < numSamples; ++n) {
+        const double angle = phaseToRadians(phase);
+        waveform.carrierI[n] = 2.0 * std::cos(angle);
+        waveform.carrierQ[n] = -2.0 * std::sin(angle);
+        phase += increment;
+    }
+
+    // 无噪声接收: 星座平均功率为1, 由此得到判决点的幅度, 判决结果作为参考比特
+    QVector<double> mixedI(numSamples);
+    QVector<double> mixedQ(numSamples);
+    QVector<double> symbolI(settings.symbolsPerTrial);
+    QVector<double> symbolQ(settings.symbolsPerTrial);
+    waveform.gain = 1.0;
+    receiveSymbols(waveform, signal.constData(), mixedI.data(), mixedQ.data(),
+                   symbolI.data(), symbolQ.data());
+
+    double energy = 0.0;
+    for (int j = 0; j < settings.symbolsPerTrial; ++j) {
+        energy += symbolI[j] * symbolI[j] + symbolQ[j] * symbolQ[j];
+    }
+    waveform.gain = std::sqrt(energy / settings.symbolsPerTrial);
+    if (!(waveform.gain > 0.0)) {
+        m_errorString = "信号幅度为0";
+        return false;
+    }
+
+    // 与自身的判决比较, 误差能量就是码间干扰
+    QVector<quint8> reference(settings.symbolsPerTrial);
+    decideSymbols(waveform, symbolI.constData(), symbolQ.constData(), reference.data());
+    TrialResult clean;
+    countErrors(waveform, reference.constData(), symbolI.constData(), symbolQ.constData(), clean);
+
+    const double cleanSnrDb = clean.errorEnergy > 0.0 ? toDb(clean.referenceEnergy / clean.errorEnergy)
+                                                      : std::numeric_limits<double>::infinity();
+    if (cleanSnrDb < MIN_CLEAN_SNR_DB) {
+        m_errorString = QString("%1 符号率 %2 Hz: 无噪声时判决点信噪比只有 %3 dB, 请增大滤波器长度, 降低符号率或减小幅度")
+                            .arg(schemeName(scheme)).arg(symbolRate).arg(cleanSnrDb, 0, 'f', 1);
+        return false;
+    }
+    return true;
+}
+
+void BerSweep::configureModulator(Modulator &modulator, Modulator::Scheme scheme, double symbolRate) const
+{
+    modulator.setScheme(scheme);
+    modulator.setCarrier(m_settings.carrierFrequency, m_settings.samplingRate);
+    modulator.setSymbolRate(symbolRate);
+    modulator.setRollOff(m_settings.rollOff);
+    modulator.setFilterSpan(m_settings.filterSpan);
+    modulator.setBitSource(m_settings.bitSource);
+}
+
+void BerSweep::modulate(Modulator &modulator, const Waveform &waveform, qint64 trial, double *signal) const
+{
+    // 载波相位从0开始, 与 carrierI/carrierQ 对齐
+    modulator.reset();
+    modulator.setBitSourceState(mixSeed(m_settings.seed ^ BIT_SEED_SALT, static_cast<quint64>(trial)));
+    modulator.generate(signal, waveform.numSamples, m_settings.amplitude, 0.0);
+}
+
+void BerSweep::receiveSymbols(const Waveform &waveform, const double *received, double *mixedI, double *mixedQ,
+                              double *symbolI, double *symbolQ) const
+{
+    const int numSamples = waveform.numSamples;
+    const int numSymbols = m_settings.symbolsPerTrial;
+    const int sps = waveform.samplesPerSymbol;
+    const int length = waveform.taps.size();
+    const double *taps = waveform.taps.constData();
+    const double *carrierI = waveform.carrierI.constData();
+    const double *carrierQ = waveform.carrierQ.constData();
+    const bool quadrature = waveform.scheme != Modulator::BPSK;
+
+    for (int n = 0; n < numSamples; ++n) {
+        mixedI[n] = received[n] * carrierI[n];
+    }
+    if (quadrature) {
+        for (int n = 0; n < numSamples; ++n) {
+            mixedQ[n] = received[n] * carrierQ[n];
+        }
+    }
+
+    // 符号 j 的脉冲从第 j * sps 个样本开始, 发送和匹配滤波器级联后在 j * sps + length - 1 处达到峰值;
+    // 滤波器对称, 判决点的输出就是窗口 [j * sps, j * sps + length) 与系数的内积
+    for (int j = 0; j < numSymbols; ++j) {
+        symbolI[j] = dotProduct(taps, mixedI + j * sps, length);
+        symbolQ[j] = quadrature ? dotProduct(taps, mixedQ + j * sps, length) : 0.0;
+    }
+}
+
+void BerSweep::decideSymbols(const Waveform &waveform, const double *symbolI, const double *symbolQ,
+                             quint8 *bits) const
+{
+    const double scale = 1.0 / waveform.gain;
+    for (int j = 0; j < m_settings.symbolsPerTrial; ++j) {
+        bits[j] = decide(waveform.scheme, symbolI[j] * scale, symbolQ[j] * scale);
+    }
+}
+
+void BerSweep::countErrors(const Waveform &waveform, const quint8 *reference, const double *symbolI,
+                           const double *symbolQ, TrialResult &result) const
+{
+    const double scale = 1.0 / waveform.gain;
+    result = TrialResult{ 0, 0, 0.0, 0.0 };
+    for (int j = 0; j < m_settings.symbolsPerTrial; ++j) {
+        const double i = symbolI[j] * scale;
+        const double q = symbolQ[j] * scale;
+        const quint8 bits = decide(waveform.scheme, i, q);
+        result.bitErrors += qPopulationCount(static_cast<quint8>(bits ^ reference[j]));
+        result.symbolErrors += bits != reference[j] ? 1 : 0;
+
+        double idealI;
+        double idealQ;
+        constellationPoint(waveform.scheme, reference[j], idealI, idealQ);
+        result.referenceEnergy += idealI * idealI + idealQ * idealQ;
+        result.errorEnergy += (i - idealI) * (i - idealI) + (q - idealQ) * (q - idealQ);
+    }
+}
+
+BerSweep::PointResult BerSweep::makeResult(int point, qint64 trials, const TrialResult &total, bool converged) const
+{
+    const int noiseCount = m_settings.noiseAmplitudes.size();
+    const Waveform &waveform = m_waveforms[point / noiseCount];
+    const double noiseAmplitude = m_settings.noiseAmplitudes[point % noiseCount];
+    const int bitsPerSymbol = Modulator::bitsPerSymbol(waveform.scheme);
+
+    PointResult result;
+    result.scheme = waveform.scheme;
+    result.symbolRate = waveform.symbolRate;
+    result.noiseAmplitude = noiseAmplitude;
+
+    // 实信号噪声方差 sigma^2 对应单边功率谱密度 N0 = 2 * sigma^2 / fs, Eb = P * sps / (fs * 比特数)
+    const double noisePower = noiseAmplitude * noiseAmplitude;
+    result.snrDb = noisePower > 0.0 ? toDb(waveform.signalPower / noisePower) : std::numeric_limits<double>::infinity();
+    result.ebN0Db = result.snrDb + toDb(waveform.samplesPerSymbol / (2.0 * bitsPerSymbol));
+    result.measuredSnrDb = total.errorEnergy > 0.0 ? toDb(total.referenceEnergy / total.errorEnergy)
+                                                   : std::numeric_limits<double>::infinity();
+
+    result.trials = trials;
+    result.symbols = trials * m_settings.symbolsPerTrial;
+    result.bits = result.symbols * bitsPerSymbol;
+    result.bitErrors = total.bitErrors;
+    result.symbolErrors = total.symbolErrors;
+    result.ber = result.bits > 0 ? static_cast<double>(total.bitErrors) / result.bits : 0.0;
+    wilsonInterval(total.bitErrors, result.bits, m_zScore, result.berLower, result.berUpper);
+    result.converged = converged;
+    return result;
+}
+
+void BerSweep::run()
+{
+    const int pointCount = getPointCount();
+    if (pointCount == 0) {
+        return;
+    }
+
+    const Settings &settings = m_settings;
+    const int noiseCount = settings.noiseAmplitudes.size();
+    const int threadCount = qMax(1, settings.threadCount > 0 ? settings.threadCount : QThread::idealThreadCount());
+
+    // 每个点的统计状态: 乱序完成的试验先放在 completed 中, 按序号连续后再计入 total
+    struct PointState {
+        qint64 dispatched = 0;
+        qint64 committed = 0;
+        qint64 maxTrials = 0;
+        TrialResult total = TrialResult{ 0, 0, 0.0, 0.0 };
+        std::map<qint64, TrialResult> completed;
+        bool finished = false;
+    };
+    std::vector<PointState> points(static_cast<size_t>(pointCount));
+    int maxSamples = 0;
+    for (int point = 0; point < pointCount; ++point) {
+        const Waveform &waveform = m_waveforms[point / noiseCount];
+        const qint64 bitsPerTrial = static_cast<qint64>(settings.symbolsPerTrial) * Modulator::bitsPerSymbol(waveform.scheme);
+        points[static_cast<size_t>(point)].maxTrials = qMax<qint64>(1, (settings.maxBitsPerPoint + bitsPerTrial - 1) / bitsPerTrial);
+        maxSamples = qMax(maxSamples, waveform.numSamples);
+    }
+    {
+        QMutexLocker locker(&m_mutex);
+        for (int point = 0; point < pointCount; ++point) {
+            m_results[point] = makeResult(point, 0, TrialResult{ 0, 0, 0.0, 0.0 }, false);
+        }
+    }
+
+    QMutex stateMutex;
+    int cursor = 0;
+
+    // 取下一次试验: 优先继续同一个点 (波形已在缓存中), 否则轮流选择未结束的点
+    auto nextTask = [&](int preferredPoint, Task &task) {
+        QMutexLocker locker(&stateMutex);
+        for (int k = -1; k < pointCount; ++k) {
+            const int point = k < 0 ? preferredPoint : (cursor + k) % pointCount;
+            if (point < 0) {
+                continue;
+            }
+            PointState &state = points[static_cast<size_t>(point)];
+            if (!state.finished && state.dispatched < state.maxTrials) {
+                task.point = point;
+                task.trial = state.dispatched++;
+                if (k >= 0) {
+                    cursor = (point + 1) % pointCount;
+                }
+                return true;
+            }
+        }
+        return false;
+    };
+
+    // 记录一次试验, 返回是否使该点结束
+    auto record = [&](const Task &task, const TrialResult &result, PointResult &finalResult) {
+        QMutexLocker locker(&stateMutex);
+        PointState &state = points[static_cast<size_t>(task.point)];
+        if (state.finished) {
+            return false;
+        }
+        state.completed[task.trial] = result;
+
+        const int bitsPerSymbol = Modulator::bitsPerSymbol(m_waveforms[task.point / noiseCount].scheme);
+        auto it = state.completed.find(state.committed);
+        while (it != state.completed.end()) {
+            state.total.bitErrors += it->second.bitErrors;
+            state.total.symbolErrors += it->second.symbolErrors;
+            state.total.errorEnergy += it->second.errorEnergy;
+            state.total.referenceEnergy += it->second.referenceEnergy;
+            state.committed++;
+            state.completed.erase(it);
+
+            const qint64 bits = state.committed * settings.symbolsPerTrial * bitsPerSymbol;
+            double lower;
+            double upper;
+            wilsonInterval(state.total.bitErrors, bits, m_zScore, lower, upper);
+            const double ber = static_cast<double>(state.total.bitErrors) / bits;
+            const bool converged = state.total.bitErrors >= settings.minBitErrors &&
+                                   (upper - lower) / 2.0 <= settings.relativePrecision * ber;
+            if (converged || state.committed == state.maxTrials) {
+                state.finished = true;
+                state.completed.clear();
+                finalResult = makeResult(task.point, state.committed, state.total, converged);
+                return true;
+            }
+            it = state.completed.find(state.committed);
+        }
+        return false;
+    };
+
+    TaskQueues queues(threadCount);
+    std::atomic<int> outstanding(0);
+
+    // 空闲的线程在 workAvailable 上等待; 状态 (队列, outstanding) 先修改再在 idleMutex 下唤醒,
+    // 等待方在 idleMutex 下检查状态, 不会错过唤醒
+    QMutex idleMutex;
+    QWaitCondition workAvailable;
+    auto wakeIdle = [&]() {
+        QMutexLocker locker(&idleMutex);
+        workAvailable.wakeAll();
+    };
+
+    // 先派发 TRIALS_PER_THREAD * threadCount 次试验, 之后每完成一次再派发一次, 在途的试验数保持不变
+    for (int k = 0; k < TRIALS_PER_THREAD * threadCount; ++k) {
+        Task task;
+        if (!nextTask(-1, task)) {
+            break;
+        }
+        outstanding++;
+        queues.push(k % threadCount, task);
+    }
+
+    auto worker = [&](int id) {
+        ChannelModule channel;
+        channel.setThreadCount(1);
+        std::vector<Modulator> modulators(static_cast<size_t>(m_waveforms.size()));
+        for (int index = 0; index < m_waveforms.size(); ++index) {
+            configureModulator(modulators[static_cast<size_t>(index)], m_waveforms[index].scheme,
+                               settings.symbolRates[index % settings.symbolRates.size()]);
+        }
+        QVector<double> transmitted(maxSamples);
+        QVector<quint8> reference(settings.symbolsPerTrial);
+        QVector<double> received(maxSamples);
+        QVector<double> mixedI(maxSamples);
+        QVector<double> mixedQ(maxSamples);
+        QVector<double> symbolI(settings.symbolsPerTrial);
+        QVector<double> symbolQ(settings.symbolsPerTrial);
+
+        for (;;) {
+            Task task;
+            if (!queues.pop(id, task)) {
+                // 其他线程还有试验在运行, 完成后可能派发新的试验
+                QMutexLocker locker(&idleMutex);
+                while (outstanding.load() > 0 && queues.isEmpty()) {
+                    workAvailable.wait(&idleMutex);
+                }
+                if (outstanding.load() == 0) {
+                    break;
+                }
+                continue;
+            }
+
+            bool skip;
+            {
+                QMutexLocker locker(&stateMutex);
+                skip = points[static_cast<size_t>(task.point)].finished;
+            }
+
+            bool finished = false;
+            PointResult finalResult;
+            if (!skip && !isInterruptionRequested()) {
+                // 第 k 次试验的比特, 以无噪声时的判决为参考
+                const int index = task.point / noiseCount;
+                const Waveform &waveform = m_waveforms[index];
+                const int numSamples = waveform.numSamples;
+                modulate(modulators[static_cast<size_t>(index)], waveform, task.trial, transmitted.data());
+                receiveSymbols(waveform, transmitted.constData(), mixedI.data(), mixedQ.data(),
+                               symbolI.data(), symbolQ.data());
+                decideSymbols(waveform, symbolI.constData(), symbolQ.constData(), reference.data());
+
+                // 每个点一个噪声序列, 第 k 次试验使用其中第 k 段
+                channel.setNoiseAmplitude(settings.noiseAmplitudes[task.point % noiseCount]);
+                channel.setNoiseSeed(mixSeed(settings.seed, static_cast<quint64>(task.point)));
+                channel.setNoisePosition(static_cast<quint64>(task.trial) * numSamples);
+                channel.processSignal(transmitted.constData(), numSamples, received.data());
+
+                receiveSymbols(waveform, received.constData(), mixedI.data(), mixedQ.data(),
+                               symbolI.data(), symbolQ.data());
+                TrialResult result;
+                countErrors(waveform, reference.constData(), symbolI.constData(), symbolQ.constData(), result);
+                finished = record(task, result, finalResult);
+            }
+
+            bool dispatched = false;
+            if (!isInterruptionRequested()) {
+                Task next;
+                if (nextTask(task.point, next)) {
+                    outstanding++;
+                    queues.push(id, next);
+                    dispatched = true;
+                }
+            }
+            // 新的试验可以被空闲的线程窃取; 最后一次试验完成时让所有线程退出
+            if (--outstanding == 0 || dispatched) {
+                wakeIdle();
+            }
+
+            if (finished) {
+                {
+                    QMutexLocker locker(&m_mutex);
+                    m_results[task.point] = finalResult;
+                }
+                emit pointFinished(task.point);
+            }
+        }
+    };
+
+    // 第一个工作线程就是当前线程
+    std::vector<std::thread> threads;
+    threads.reserve(static_cast<size_t>(threadCount - 1));
+    for (int id = 1; id < threadCount; ++id) {
+        threads.emplace_back(worker, id);
+    }
+    worker(0);
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    // 被取消时未结束的点按已完成的试验给出结果
+    for (int point = 0; point < pointCount; ++point) {
+        PointState &state = points[static_cast<size_t>(point)];
+        if (state.finished) {
+            continue;
+        }
+        {
+            QMutexLocker locker(&m_mutex);
+            m_results[point] = makeResult(point, state.committed, state.total, false);
+        }
+        emit pointFinished(point);
+    }
+}
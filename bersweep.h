@@ -0,0 +1,132 @@
+#ifndef BERSWEEP_H
+#define BERSWEEP_H
+
+#include <QMutex>
+#include <QString>
+#include <QThread>
+#include <QVector>
+
+#include "modulator.h"
+
+// 蒙特卡洛误码率扫描
+// 在 (调制方式 x 符号率 x 噪声幅度) 网格的每个点上重复独立试验: 调制信号经过 ChannelModule 叠加噪声,
+// 再相干解调 (下变频, RRC匹配滤波, 在最佳采样点判决), 与无噪声时的判决比较, 统计误比特数和误符号数.
+// 试验分派到工作窃取线程池: 每个线程优先处理自己队列尾部的试验, 空闲时从其他线程队列的头部窃取.
+// 每个点按试验序号顺序累计结果, 误比特数达到下限且置信区间 (Wilson) 的相对半宽小于要求时停止该点,
+// 线程转去处理其他点. 第 k 次试验使用该点噪声序列中 [k * n, (k + 1) * n) 位置的样本,
+// 比特源从由种子和 k 决定的位置开始 (所有点的第 k 次试验发送相同的比特), 每次试验重新调制并以
+// 无噪声时的判决为参考. 停止判据只作用在按序号连续完成的试验上, 因此结果 (包括停止时的试验次数)
+// 与线程数和调度无关. 没有可执行的试验时工作线程在条件变量上等待, 有新的试验派发或全部完成时被唤醒.
+class BerSweep : public QThread
+{
+    Q_OBJECT
+public:
+    struct Settings {
+        QVector<Modulator::Scheme> schemes;     // 只支持相干解调的 BPSK / QPSK / QAM16
+        QVector<double> symbolRates;            // 符号率 (Hz), 每个符号的样本数取整
+        QVector<double> noiseAmplitudes;        // 噪声标准差, 与 ChannelModule::setNoiseAmplitude 相同
+        double samplingRate;
+        double carrierFrequency;
+        double amplitude;
+        double rollOff;
+        int filterSpan;                         // 成形/匹配滤波器长度 (符号数)
+        Modulator::BitSource bitSource;
+        int symbolsPerTrial;                    // 每次试验判决的符号数
+        qint64 minBitErrors;                    // 停止前至少需要的误比特数
+        double relativePrecision;               // 置信区间半宽 / 误码率 小于该值时停止
+        double confidence;                      // 置信水平
+        qint64 maxBitsPerPoint;                 // 每个点最多统计的比特数, 误码率很低时以此结束
+        quint64 seed;
+        int threadCount;                        // 0 表示按CPU核数自动选择
+
+        Settings();
+    };
+
+    struct PointResult {
+        Modulator::Scheme scheme;
+        double symbolRate;
+        double noiseAmplitude;
+        double snrDb;               // 信号功率 / 噪声方差 (采样点上)
+        double ebN0Db;
+        double measuredSnrDb;       // 判决点上测得的信噪比 (调制误差比)
+        qint64 trials;
+        qint64 bits;
+        qint64 bitErrors;
+        qint64 symbols;
+        qint64 symbolErrors;
+        double ber;
+        double berLower;            // 置信区间
+        double berUpper;
+        bool converged;             // false 表示达到比特数上限或扫描被取消
+
+        PointResult();
+    };
+
+    explicit BerSweep(QObject *parent = nullptr);
+    ~BerSweep();
+
+    // 检查参数并生成各 (调制方式, 符号率) 组合的发送波形和无噪声参考, 只能在扫描未运行时调用
+    bool setSettings(const Settings &settings);
+    Settings getSettings() const;
+    QString errorString() const;
+
+    // 网格点按 调制方式, 符号率, 噪声幅度 的顺序排列 (噪声幅度变化最快)
+    int getPointCount() const;
+    PointResult getResult(int index) const;
+    QVector<PointResult> getResults() const;
+
+    static QString schemeName(Modulator::Scheme scheme);
+
+    // 试验分派的目标并发数: 每个线程在途的试验数
+    static const int TRIALS_PER_THREAD = 2;
+
+signals:
+    // 某个点统计完成 (可能在任意线程发出)
+    void pointFinished(int index);
+
+protected:
+    void run() override;
+
+private:
+    // 一种 (调制方式, 符号率) 组合的解调参数, 扫描期间所有线程只读共享
+    struct Waveform {
+        Modulator::Scheme scheme;
+        double symbolRate;          // 取整后的实际符号率
+        int samplesPerSymbol;
+        int numSamples;             // 每次试验的样本数, 末尾多出一个滤波器长度使最后一个符号可以判决
+        QVector<double> carrierI;   // 2*cos, 下变频到同相支路
+        QVector<double> carrierQ;   // -2*sin, 下变频到正交支路
+        QVector<double> taps;       // 匹配滤波器
+        double gain;                // 判决点上单位功率星座对应的幅度
+        double signalPower;
+    };
+
+    struct TrialResult {
+        qint64 bitErrors;
+        qint64 symbolErrors;
+        double errorEnergy;         // 判决点上 |r/gain - 理想星座点|^2 之和
+        double referenceEnergy;     // 参考判决对应的理想星座点的能量之和
+    };
+
+    bool prepareWaveform(Modulator::Scheme scheme, double symbolRate, Waveform &waveform);
+    void configureModulator(Modulator &modulator, Modulator::Scheme scheme, double symbolRate) const;
+    // 第 trial 次试验的发送波形: 载波和成形滤波器从0开始, 比特源从由种子和 trial 决定的位置开始
+    void modulate(Modulator &modulator, const Waveform &waveform, qint64 trial, double *signal) const;
+    // 下变频后在每个符号的最佳采样点做匹配滤波, 得到判决点上的同相/正交分量 (未归一化)
+    void receiveSymbols(const Waveform &waveform, const double *received, double *mixedI, double *mixedQ,
+                        double *symbolI, double *symbolQ) const;
+    void decideSymbols(const Waveform &waveform, const double *symbolI, const double *symbolQ, quint8 *bits) const;
+    void countErrors(const Waveform &waveform, const quint8 *reference, const double *symbolI, const double *symbolQ,
+                     TrialResult &result) const;
+    PointResult makeResult(int point, qint64 trials, const TrialResult &total, bool converged) const;
+
+    Settings m_settings;
+    QVector<Waveform> m_waveforms;
+    double m_zScore;
+
+    mutable QMutex m_mutex;             // 保护 m_results
+    QVector<PointResult> m_results;
+    QString m_errorString;
+};
+
+#endif // BERSWEEP_H
@@ -0,0 +1,162 @@
+#include "biquadcascade.h"
+
+#include <QtMath>
+#include <algorithm>
+#include <complex>
+
+// 模拟原型左半平面的极点 (虚部 >= 0 的一半, 实极点在最后) 转换为数字二阶节/一阶节, 各节直流增益为1
+// 双线性变换 s = K * (1 - z^-1) / (1 + z^-1), K = 2 * fs
+static QVector<BiquadCascade::Section> bilinearSections(const QVector<std::complex<double>> &poles,
+                                                        double samplingRate)
+{
+    const double k = 2.0 * samplingRate;
+    QVector<BiquadCascade::Section> sections;
+    for (const std::complex<double> &pole : poles) {
+        BiquadCascade::Section section;
+        if (pole.imag() > 0.0) {
+            // H(s) = w0^2 / (s^2 + a*s + w0^2), a = -2*Re(p), w0^2 = |p|^2
+            const double a = -2.0 * pole.real();
+            const double w2 = std::norm(pole);
+            const double d0 = k * k + a * k + w2;
+            section.b0 = w2 / d0;
+            section.b1 = 2.0 * section.b0;
+            section.b2 = section.b0;
+            section.a1 = 2.0 * (w2 - k * k) / d0;
+            section.a2 = (k * k - a * k + w2) / d0;
+        } else {
+            // H(s) = w / (s + w), w = -p
+            const double w = -pole.real();
+            const double d0 = k + w;
+            section.b0 = w / d0;
+            section.b1 = section.b0;
+            section.b2 = 0.0;
+            section.a1 = (w - k) / d0;
+            section.a2 = 0.0;
+        }
+        sections.append(section);
+    }
+    return sections;
+}
+
+// 预畸变后的模拟截止角频率, 截止频率限制在 (0, 0.49 * fs)
+static double prewarp(double cutoffFrequency, double samplingRate)
+{
+    const double fc = qBound(1e-6 * samplingRate, cutoffFrequency, 0.49 * samplingRate);
+    return 2.0 * samplingRate * std::tan(M_PI * fc / samplingRate);
+}
+
+BiquadCascade::BiquadCascade()
+{
+}
+
+void BiquadCascade::setSections(const QVector<Section> &sections)
+{
+    const bool keepState = sections.size() == m_sections.size();
+    m_sections = sections;
+    if (!keepState) {
+        reset();
+    }
+}
+
+QVector<BiquadCascade::Section> BiquadCascade::getSections() const
+{
+    return m_sections;
+}
+
+void BiquadCascade::reset()
+{
+    m_state.fill(0.0, 2 * m_sections.size());
+}
+
+void BiquadCascade::saveState(QVector<double> &state) const
+{
+    state.resize(m_state.size());
+    std::copy(m_state.constData(), m_state.constData() + m_state.size(), state.data());
+}
+
+void BiquadCascade::restoreState(const QVector<double> &state)
+{
+    if (state.size() != 2 * m_sections.size()) {
+        reset();
+        return;
+    }
+    std::copy(state.constData(), state.constData() + state.size(), m_state.data());
+}
+
+void BiquadCascade::process(const double *input, double *output, int numSamples)
+{
+    if (numSamples <= 0) {
+        return;
+    }
+    if (m_sections.isEmpty()) {
+        if (output != input) {
+            std::copy(input, input + numSamples, output);
+        }
+        return;
+    }
+
+    // 第一节从 input 读, 之后各节在 output 上原地进行
+    const double *source = input;
+    for (int s = 0; s < m_sections.size(); ++s) {
+        const Section &section = m_sections[s];
+        double s1 = m_state[2 * s];
+        double s2 = m_state[2 * s + 1];
+        for (int i = 0; i < numSamples; ++i) {
+            const double x = source[i];
+            const double y = section.b0 * x + s1;
+            s1 = section.b1 * x - section.a1 * y + s2;
+            s2 = section.b2 * x - section.a2 * y;
+            output[i] = y;
+        }
+        m_state[2 * s] = s1;
+        m_state[2 * s + 1] = s2;
+        source = output;
+    }
+}
+
+QVector<BiquadCascade::Section> BiquadCascade::butterworthLowPass(int order, double cutoffFrequency,
+                                                                 double samplingRate)
+{
+    order = qBound(1, order, MAX_ORDER);
+    const double wc = prewarp(cutoffFrequency, samplingRate);
+
+    // 极点均匀分布在半径 wc 的左半圆上: p_k = wc * e^(j*pi*(2k + N + 1) / (2N))
+    QVector<std::complex<double>> poles;
+    for (int k = 0; k < order / 2; ++k) {
+        poles.append(std::polar(wc, M_PI * (2 * k + order + 1) / (2.0 * order)));
+    }
+    if (order % 2 != 0) {
+        poles.append(std::complex<double>(-wc, 0.0));
+    }
+    return bilinearSections(poles, samplingRate);
+}
+
+QVector<BiquadCascade::Section> BiquadCascade::chebyshevLowPass(int order, double rippleDb, double cutoffFrequency,
+                                                               double samplingRate)
+{
+    order = qBound(1, order, MAX_ORDER);
+    const double wc = prewarp(cutoffFrequency, samplingRate);
+    const double epsilon = std::sqrt(std::pow(10.0, qMax(rippleDb, 1e-3) / 10.0) - 1.0);
+    const double mu = std::asinh(1.0 / epsilon) / order;
+
+    // p_k = wc * (-sinh(mu) * sin(theta_k) + j * cosh(mu) * cos(theta_k)), theta_k = pi * (2k + 1) / (2N)
+    QVector<std::complex<double>> poles;
+    for (int k = 0; k < order / 2; ++k) {
+        const double theta = M_PI * (2 * k + 1) / (2.0 * order);
+        poles.append(std::complex<double>(-wc * std::sinh(mu) * std::sin(theta),
+                                          wc * std::cosh(mu) * std::cos(theta)));
+    }
+    if (order % 2 != 0) {
+        poles.append(std::complex<double>(-wc * std::sinh(mu), 0.0));
+    }
+
+    // 偶数阶在直流处位于波纹谷底, 增益为 1/sqrt(1 + eps^2)
+    QVector<Section> sections = bilinearSections(poles, samplingRate);
+    if (order % 2 == 0) {
+        const double gain = 1.0 / std::sqrt(1.0 + epsilon * epsilon);
+        sections[0].b0 *= gain;
+        sections[0].b1 *= gain;
+        sections[0].b2 *= gain;
+    }
+    return sections;
+}
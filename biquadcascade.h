@@ -0,0 +1,45 @@
+#ifndef BIQUADCASCADE_H
+#define BIQUADCASCADE_H
+
+#include <QVector>
+
+// 二阶节 (biquad) 级联IIR滤波器, 每节为转置直接II型:
+//   y = b0*x + s1,  s1 = b1*x - a1*y + s2,  s2 = b2*x - a2*y
+// 每节依次处理整块数据, 状态在块之间保留. 更换系数 (例如改变截止频率) 时保留各节状态, 不重新起振.
+// 低通设计: 模拟原型的极点两两配成二阶节 (奇数阶多一个一阶节), 经预畸变的双线性变换得到数字滤波器.
+class BiquadCascade
+{
+public:
+    struct Section {
+        double b0, b1, b2;
+        double a1, a2;      // a0 已归一化为1
+    };
+
+    BiquadCascade();
+
+    // 节数不变时保留状态, 否则清空
+    void setSections(const QVector<Section> &sections);
+    QVector<Section> getSections() const;
+
+    void reset();
+    // 状态快照 (与当前设计对应), 写入 state 时复用它的内存; 恢复时长度不符 (设计已改变) 则清空状态
+    void saveState(QVector<double> &state) const;
+    void restoreState(const QVector<double> &state);
+
+    // output 可以与 input 相同
+    void process(const double *input, double *output, int numSamples);
+
+    // order 阶巴特沃斯低通, 截止频率处衰减3dB
+    static QVector<Section> butterworthLowPass(int order, double cutoffFrequency, double samplingRate);
+    // order 阶切比雪夫I型低通, 通带波纹 rippleDb, 截止频率为波纹带边缘; 通带最大增益为1
+    static QVector<Section> chebyshevLowPass(int order, double rippleDb, double cutoffFrequency,
+                                             double samplingRate);
+
+    static const int MAX_ORDER = 16;
+
+private:
+    QVector<Section> m_sections;
+    QVector<double> m_state;    // 每节 (s1, s2)
+};
+
+#endif // BIQUADCASCADE_H
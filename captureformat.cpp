@@ -0,0 +1,231 @@
+#include "captureformat.h"
+
+#include <QtEndian>
+#include <climits>
+#include <cstring>
+
+namespace CaptureFormat {
+
+static const char MAGIC[8] = {'S', 'G', 'C', 'A', 'P', 'T', 'U', 'R'};
+static const char CHUNK_MAGIC[4] = {'C', 'H', 'N', 'K'};
+static const quint16 FLAG_COMPRESSED = 0x1;
+
+Header::Header() :
+    sampleFormat(Float64),
+    channelCount(1),
+    samplingRate(0.0),
+    startTime(0),
+    creationTime(0),
+    frameCount(0),
+    indexOffset(0),
+    chunkCount(0),
+    chunkFrames(0),
+    compressed(false)
+{
+}
+
+int bytesPerSample(SampleFormat format)
+{
+    switch (format) {
+    case Int16:
+        return 2;
+    case Float32:
+        return 4;
+    default:
+        return 8;
+    }
+}
+
+static void writeDouble(double value, uchar *data)
+{
+    quint64 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    qToLittleEndian<quint64>(bits, data);
+}
+
+static double readDouble(const uchar *data)
+{
+    const quint64 bits = qFromLittleEndian<quint64>(data);
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+void writeHeader(const Header &header, uchar *data)
+{
+    std::memcpy(data, MAGIC, sizeof(MAGIC));
+    qToLittleEndian<quint16>(VERSION, data + 8);
+    qToLittleEndian<quint16>(header.sampleFormat, data + 10);
+    qToLittleEndian<quint16>(header.channelCount, data + 12);
+    qToLittleEndian<quint16>(header.compressed ? FLAG_COMPRESSED : 0, data + 14);
+    writeDouble(header.samplingRate, data + 16);
+    qToLittleEndian<qint64>(header.startTime, data + 24);
+    qToLittleEndian<qint64>(header.creationTime, data + 32);
+    qToLittleEndian<qint64>(header.frameCount, data + 40);
+    qToLittleEndian<qint64>(header.indexOffset, data + 48);
+    qToLittleEndian<quint32>(header.chunkCount, data + 56);
+    qToLittleEndian<quint32>(header.chunkFrames, data + 60);
+}
+
+bool hasMagic(const uchar *data, qint64 size)
+{
+    return size >= static_cast<qint64>(sizeof(MAGIC)) && std::memcmp(data, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+bool readHeader(const uchar *data, qint64 size, Header &header, QString *errorString)
+{
+    QString error;
+    if (size < HEADER_SIZE || !hasMagic(data, size)) {
+        error = "不是有效的采集文件";
+    } else if (qFromLittleEndian<quint16>(data + 8) > VERSION) {
+        error = QString("不支持的采集文件版本: %1").arg(qFromLittleEndian<quint16>(data + 8));
+    } else {
+        const quint16 format = qFromLittleEndian<quint16>(data + 10);
+        const quint32 chunkCount = qFromLittleEndian<quint32>(data + 56);
+        const quint32 chunkFrames = qFromLittleEndian<quint32>(data + 60);
+        header.sampleFormat = static_cast<SampleFormat>(format);
+        header.channelCount = qFromLittleEndian<quint16>(data + 12);
+        header.compressed = (qFromLittleEndian<quint16>(data + 14) & FLAG_COMPRESSED) != 0;
+        header.samplingRate = readDouble(data + 16);
+        header.startTime = qFromLittleEndian<qint64>(data + 24);
+        header.creationTime = qFromLittleEndian<qint64>(data + 32);
+        header.frameCount = qFromLittleEndian<qint64>(data + 40);
+        header.indexOffset = qFromLittleEndian<qint64>(data + 48);
+        header.chunkCount = static_cast<int>(qMin<quint32>(chunkCount, INT_MAX));
+        header.chunkFrames = static_cast<int>(qMin<quint32>(chunkFrames, INT_MAX));
+
+        if (format > Float64) {
+            error = QString("不支持的采样格式: %1").arg(format);
+        } else if (header.channelCount <= 0 || !(header.samplingRate >= 0.0) ||
+                   header.frameCount < 0 || header.indexOffset < 0 || header.chunkFrames <= 0) {
+            error = "采集文件头中的参数无效";
+        }
+    }
+
+    if (errorString) {
+        *errorString = error;
+    }
+    return error.isEmpty();
+}
+
+void writeChunkHeader(const ChunkInfo &chunk, uchar *data)
+{
+    std::memcpy(data, CHUNK_MAGIC, sizeof(CHUNK_MAGIC));
+    qToLittleEndian<quint32>(chunk.frames, data + 4);
+    qToLittleEndian<quint32>(chunk.storedBytes, data + 8);
+    qToLittleEndian<quint16>(chunk.encoding, data + 12);
+    qToLittleEndian<quint16>(0, data + 14);
+}
+
+bool readChunkHeader(const uchar *data, ChunkInfo &chunk)
+{
+    const quint32 frames = qFromLittleEndian<quint32>(data + 4);
+    const quint32 storedBytes = qFromLittleEndian<quint32>(data + 8);
+    const quint16 encoding = qFromLittleEndian<quint16>(data + 12);
+    if (std::memcmp(data, CHUNK_MAGIC, sizeof(CHUNK_MAGIC)) != 0 || frames == 0 ||
+            frames > INT_MAX || storedBytes > INT_MAX || encoding > Gap) {
+        return false;
+    }
+
+    chunk.frames = static_cast<int>(frames);
+    chunk.storedBytes = static_cast<int>(storedBytes);
+    chunk.encoding = static_cast<Encoding>(encoding);
+    return true;
+}
+
+void writeIndexEntry(const ChunkInfo &chunk, uchar *data)
+{
+    qToLittleEndian<qint64>(chunk.offset, data);
+    qToLittleEndian<qint64>(chunk.firstFrame, data + 8);
+    qToLittleEndian<quint32>(chunk.frames, data + 16);
+    qToLittleEndian<quint32>(chunk.storedBytes, data + 20);
+}
+
+void readIndexEntry(const uchar *data, ChunkInfo &chunk)
+{
+    chunk.offset = qFromLittleEndian<qint64>(data);
+    chunk.firstFrame = qFromLittleEndian<qint64>(data + 8);
+    chunk.frames = static_cast<int>(qMin<quint32>(qFromLittleEndian<quint32>(data + 16), INT_MAX));
+    chunk.storedBytes = static_cast<int>(qMin<quint32>(qFromLittleEndian<quint32>(data + 20), INT_MAX));
+    chunk.encoding = Raw;
+}
+
+// 与同一通道前一个样本的差 (整数) 或异或 (浮点的位模式), 按字节拆成 sizeof(T) 个平面
+template <typename T>
+static void deltaShuffle(const uchar *samples, int count, int channels, bool integer, uchar *planes)
+{
+    const int width = sizeof(T);
+    for (int i = 0; i < count; ++i) {
+        const T value = qFromLittleEndian<T>(samples + i * width);
+        const T previous = i >= channels ? qFromLittleEndian<T>(samples + (i - channels) * width) : T(0);
+        const T residual = integer ? T(value - previous) : T(value ^ previous);
+        for (int b = 0; b < width; ++b) {
+            planes[b * count + i] = static_cast<uchar>(residual >> (8 * b));
+        }
+    }
+}
+
+template <typename T>
+static void unshuffleDelta(const uchar *planes, int count, int channels, bool integer, uchar *samples)
+{
+    const int width = sizeof(T);
+    for (int i = 0; i < count; ++i) {
+        T residual = 0;
+        for (int b = 0; b < width; ++b) {
+            residual |= static_cast<T>(static_cast<T>(planes[b * count + i]) << (8 * b));
+        }
+        const T previous = i >= channels ? qFromLittleEndian<T>(samples + (i - channels) * width) : T(0);
+        const T value = integer ? T(previous + residual) : T(previous ^ residual);
+        qToLittleEndian<T>(value, samples + i * width);
+    }
+}
+
+bool compressChunk(const uchar *samples, int sampleCount, SampleFormat format, int channelCount,
+                   int level, QByteArray &output)
+{
+    const int bytes = sampleCount * bytesPerSample(format);
+    QByteArray planes(bytes, Qt::Uninitialized);
+    uchar *p = reinterpret_cast<uchar *>(planes.data());
+    switch (format) {
+    case Int16:
+        deltaShuffle<quint16>(samples, sampleCount, channelCount, true, p);
+        break;
+    case Float32:
+        deltaShuffle<quint32>(samples, sampleCount, channelCount, false, p);
+        break;
+    default:
+        deltaShuffle<quint64>(samples, sampleCount, channelCount, false, p);
+        break;
+    }
+
+    output = qCompress(planes, level);
+    return !output.isEmpty() && output.size() < bytes;
+}
+
+bool decompressChunk(const uchar *stored, int storedBytes, int sampleCount, SampleFormat format,
+                     int channelCount, QByteArray &output)
+{
+    const QByteArray planes = qUncompress(stored, storedBytes);
+    const int bytes = sampleCount * bytesPerSample(format);
+    if (planes.size() != bytes) {
+        return false;
+    }
+
+    output.resize(bytes);
+    const uchar *p = reinterpret_cast<const uchar *>(planes.constData());
+    uchar *samples = reinterpret_cast<uchar *>(output.data());
+    switch (format) {
+    case Int16:
+        unshuffleDelta<quint16>(p, sampleCount, channelCount, true, samples);
+        break;
+    case Float32:
+        unshuffleDelta<quint32>(p, sampleCount, channelCount, false, samples);
+        break;
+    default:
+        unshuffleDelta<quint64>(p, sampleCount, channelCount, false, samples);
+        break;
+    }
+    return true;
+}
+
+} // namespace CaptureFormat
@@ -0,0 +1,89 @@
+#ifndef CAPTUREFORMAT_H
+#define CAPTUREFORMAT_H
+
+#include <QByteArray>
+#include <QString>
+#include <QtGlobal>
+
+// 分块索引的二进制采集文件格式 (.sgc), 所有数值为小端
+//
+//   文件头 (64字节)  magic "SGCAPTUR", 版本, 采样格式, 通道数, 压缩标志, 采样率,
+//                    第一个样本的时间, 文件写完的时间, 总帧数, 索引位置, 块数, 每块帧数
+//   数据块 ...       块头 (16字节: "CHNK", 帧数, 存储字节数, 编码) + 交织样本
+//   索引             每块一项 (24字节: 块头的文件偏移, 第一帧的序号, 帧数, 存储字节数)
+//
+// 块的编码:
+//  - Raw: 小端交织样本, 读取时直接从映射内存转换
+//  - Deflate: 无损压缩. 每个样本先与同一通道的前一个样本求差 (int16 为回绕减法, 浮点为按位异或),
+//    再把各样本的同一字节依次排在一起 (字节重排), 最后 zlib 压缩 (qCompress). 压缩后不变小的块按 Raw 存储
+//  - Gap: 没有样本数据 (存储字节数为0), 表示录制时丢弃的帧数, 读取时填0. 帧序号包括缺口, 文件中的时间线
+//    与采集时一致: 第 n 帧的时间总是 startTime + n / samplingRate (版本2起)
+// 索引在文件关闭时写入, 文件头中的索引位置为0表示写入中断 (例如程序崩溃), 读取时顺序扫描块头重建索引.
+namespace CaptureFormat {
+
+enum SampleFormat {
+    Int16 = 0,
+    Float32 = 1,
+    Float64 = 2
+};
+
+enum Encoding {
+    Raw = 0,
+    Deflate = 1,
+    Gap = 2
+};
+
+struct Header {
+    SampleFormat sampleFormat;
+    int channelCount;
+    double samplingRate;
+    qint64 startTime;           // 第一个样本的时间, 自1970年起的毫秒数 (UTC)
+    qint64 creationTime;        // 文件写完的时间
+    qint64 frameCount;          // 包括缺口的帧
+    qint64 indexOffset;         // 0 表示没有索引
+    int chunkCount;
+    int chunkFrames;            // 每块的帧数 (缺口前的块和最后一块可以较少)
+    bool compressed;
+
+    Header();
+};
+
+// 一个数据块 (索引项)
+struct ChunkInfo {
+    qint64 offset;              // 块头的文件偏移
+    qint64 firstFrame;
+    int frames;
+    int storedBytes;            // 块头之后的存储字节数
+    Encoding encoding;
+};
+
+const int VERSION = 2;
+const int HEADER_SIZE = 64;
+const int CHUNK_HEADER_SIZE = 16;
+const int INDEX_ENTRY_SIZE = 24;
+
+int bytesPerSample(SampleFormat format);
+
+// 文件头读写; readHeader 检查 magic, 版本和各字段的范围
+void writeHeader(const Header &header, uchar *data);
+bool readHeader(const uchar *data, qint64 size, Header &header, QString *errorString = nullptr);
+// 文件开头是否为采集文件的 magic
+bool hasMagic(const uchar *data, qint64 size);
+
+// 块头读写 (offset 和 firstFrame 不在块头中, readChunkHeader 不修改它们)
+void writeChunkHeader(const ChunkInfo &chunk, uchar *data);
+bool readChunkHeader(const uchar *data, ChunkInfo &chunk);
+
+void writeIndexEntry(const ChunkInfo &chunk, uchar *data);
+void readIndexEntry(const uchar *data, ChunkInfo &chunk);
+
+// 压缩 sampleCount 个小端交织样本, 结果写入 output. 压缩后不比原始数据小时返回 false
+bool compressChunk(const uchar *samples, int sampleCount, SampleFormat format, int channelCount,
+                   int level, QByteArray &output);
+// 解压为 sampleCount 个小端交织样本, 数据损坏时返回 false
+bool decompressChunk(const uchar *stored, int storedBytes, int sampleCount, SampleFormat format,
+                     int channelCount, QByteArray &output);
+
+} // namespace CaptureFormat
+
+#endif // CAPTUREFORMAT_H
@@ -0,0 +1,344 @@
+#include "capturereader.h"
+
+#include <QtEndian>
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+// 映射内存不保证按样本类型对齐, 统一通过 qFromLittleEndian 读取
+static inline double readFloat32(const uchar *p)
+{
+    const quint32 bits = qFromLittleEndian<quint32>(p);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static inline double readFloat64(const uchar *p)
+{
+    const quint64 bits = qFromLittleEndian<quint64>(p);
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+CaptureReader::CaptureReader() :
+    m_mapping(nullptr),
+    m_mappingSize(0),
+    m_complete(false),
+    m_missingFrames(0),
+    m_position(0),
+    m_decodedChunk(-1)
+{
+}
+
+CaptureReader::~CaptureReader()
+{
+    close();
+}
+
+bool CaptureReader::isCaptureFile(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    char magic[8];
+    return file.read(magic, sizeof(magic)) == sizeof(magic) &&
+           CaptureFormat::hasMagic(reinterpret_cast<const uchar *>(magic), sizeof(magic));
+}
+
+bool CaptureReader::open(const QString &filePath)
+{
+    close();
+
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_errorString = QString("无法打开文件: %1").arg(m_file.errorString());
+        return false;
+    }
+
+    m_mappingSize = m_file.size();
+    m_mapping = m_mappingSize > 0 ? m_file.map(0, m_mappingSize) : nullptr;
+    if (!m_mapping) {
+        m_errorString = QString("无法映射文件: %1").arg(m_file.errorString());
+        close();
+        return false;
+    }
+
+    if (!CaptureFormat::readHeader(m_mapping, m_mappingSize, m_header, &m_errorString)) {
+        close();
+        return false;
+    }
+
+    m_complete = loadIndex();
+    if (!m_complete) {
+        scanChunks();
+    }
+    updateFrameCount();
+
+    // 第一个有数据的块解压失败时整个文件不可读; 后面的块在第一次读取时检查
+    for (int i = 0; i < m_chunks.size(); ++i) {
+        if (m_chunks[i].encoding == CaptureFormat::Gap) {
+            continue;
+        }
+        if (!chunkSamples(i)) {
+            close();
+            return false;
+        }
+        break;
+    }
+    m_position = 0;
+    return true;
+}
+
+void CaptureReader::updateFrameCount()
+{
+    m_header.chunkCount = m_chunks.size();
+    m_header.frameCount = m_chunks.isEmpty() ? 0 : m_chunks.last().firstFrame + m_chunks.last().frames;
+    m_missingFrames = 0;
+    for (const CaptureFormat::ChunkInfo &chunk : m_chunks) {
+        if (chunk.encoding == CaptureFormat::Gap) {
+            m_missingFrames += chunk.frames;
+        }
+    }
+}
+
+void CaptureReader::close()
+{
+    if (m_mapping) {
+        m_file.unmap(m_mapping);
+    }
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+
+    m_mapping = nullptr;
+    m_mappingSize = 0;
+    m_chunks.clear();
+    m_complete = false;
+    m_missingFrames = 0;
+    m_position = 0;
+    m_decodedChunk = -1;
+    m_decoded.clear();
+}
+
+bool CaptureReader::isOpen() const
+{
+    return m_mapping != nullptr;
+}
+
+QString CaptureReader::errorString() const
+{
+    return m_errorString;
+}
+
+CaptureFormat::Header CaptureReader::getHeader() const
+{
+    return m_header;
+}
+
+CaptureFormat::SampleFormat CaptureReader::getSampleFormat() const
+{
+    return m_header.sampleFormat;
+}
+
+int CaptureReader::getChannelCount() const
+{
+    return m_header.channelCount;
+}
+
+double CaptureReader::getSamplingRate() const
+{
+    return m_header.samplingRate;
+}
+
+qint64 CaptureReader::getFrameCount() const
+{
+    return m_header.frameCount;
+}
+
+QDateTime CaptureReader::getStartTime() const
+{
+    return QDateTime::fromMSecsSinceEpoch(m_header.startTime);
+}
+
+int CaptureReader::getChunkCount() const
+{
+    return m_chunks.size();
+}
+
+qint64 CaptureReader::getMissingFrames() const
+{
+    return m_missingFrames;
+}
+
+bool CaptureReader::isComplete() const
+{
+    return m_complete;
+}
+
+qint64 CaptureReader::getPosition() const
+{
+    return m_position;
+}
+
+void CaptureReader::seek(qint64 frame)
+{
+    m_position = qBound<qint64>(0, frame, m_header.frameCount);
+}
+
+int CaptureReader::readBlock(double *output, int maxFrames, int channel)
+{
+    if (!isOpen() || channel < 0 || channel >= m_header.channelCount) {
+        return 0;
+    }
+
+    const int channels = m_header.channelCount;
+    const int sampleBytes = CaptureFormat::bytesPerSample(m_header.sampleFormat);
+    const int frameBytes = sampleBytes * channels;
+    int read = 0;
+    while (read < maxFrames && m_position < m_header.frameCount) {
+        const int index = findChunk(m_position);
+        const CaptureFormat::ChunkInfo &chunk = m_chunks[index];
+        const int first = static_cast<int>(m_position - chunk.firstFrame);
+        const int frames = qMin(maxFrames - read, chunk.frames - first);
+        if (chunk.encoding == CaptureFormat::Gap) {
+            std::fill(output + read, output + read + frames, 0.0);
+            read += frames;
+            m_position += frames;
+            continue;
+        }
+
+        const uchar *samples = chunkSamples(index);
+        if (!samples) {
+            break;
+        }
+
+        const uchar *src = samples + static_cast<qint64>(first) * frameBytes + channel * sampleBytes;
+        double *dest = output + read;
+        switch (m_header.sampleFormat) {
+        case CaptureFormat::Int16:
+            for (int i = 0; i < frames; ++i) {
+                dest[i] = qFromLittleEndian<qint16>(src + static_cast<qint64>(i) * frameBytes);
+            }
+            break;
+        case CaptureFormat::Float32:
+            for (int i = 0; i < frames; ++i) {
+                dest[i] = readFloat32(src + static_cast<qint64>(i) * frameBytes);
+            }
+            break;
+        default:
+            for (int i = 0; i < frames; ++i) {
+                dest[i] = readFloat64(src + static_cast<qint64>(i) * frameBytes);
+            }
+            break;
+        }
+
+        read += frames;
+        m_position += frames;
+    }
+    return read;
+}
+
+bool CaptureReader::loadIndex()
+{
+    const qint64 indexOffset = m_header.indexOffset;
+    const qint64 count = m_header.chunkCount;
+    if (indexOffset < CaptureFormat::HEADER_SIZE ||
+            indexOffset + count * CaptureFormat::INDEX_ENTRY_SIZE > m_mappingSize) {
+        return false;
+    }
+
+    m_chunks.resize(static_cast<int>(count));
+    qint64 nextFrame = 0;
+    for (int i = 0; i < m_chunks.size(); ++i) {
+        CaptureFormat::ChunkInfo &chunk = m_chunks[i];
+        CaptureFormat::readIndexEntry(m_mapping + indexOffset + i * CaptureFormat::INDEX_ENTRY_SIZE, chunk);
+        if (chunk.firstFrame != nextFrame || !checkChunk(chunk, indexOffset)) {
+            m_chunks.clear();
+            return false;
+        }
+        nextFrame += chunk.frames;
+    }
+    return true;
+}
+
+void CaptureReader::scanChunks()
+{
+    m_chunks.clear();
+    CaptureFormat::ChunkInfo chunk;
+    chunk.offset = CaptureFormat::HEADER_SIZE;
+    chunk.firstFrame = 0;
+    while (chunk.offset + CaptureFormat::CHUNK_HEADER_SIZE <= m_mappingSize &&
+           CaptureFormat::readChunkHeader(m_mapping + chunk.offset, chunk) &&
+           checkChunk(chunk, m_mappingSize)) {
+        m_chunks.append(chunk);
+        chunk.offset += CaptureFormat::CHUNK_HEADER_SIZE + chunk.storedBytes;
+        chunk.firstFrame += chunk.frames;
+    }
+}
+
+bool CaptureReader::checkChunk(CaptureFormat::ChunkInfo &chunk, qint64 limit) const
+{
+    if (chunk.offset < CaptureFormat::HEADER_SIZE ||
+            chunk.offset + CaptureFormat::CHUNK_HEADER_SIZE + chunk.storedBytes > limit) {
+        return false;
+    }
+
+    CaptureFormat::ChunkInfo stored = chunk;
+    if (!CaptureFormat::readChunkHeader(m_mapping + chunk.offset, stored) ||
+            stored.frames != chunk.frames || stored.storedBytes != chunk.storedBytes) {
+        return false;
+    }
+    chunk.encoding = stored.encoding;
+
+    // 未压缩的块长度必须与帧数一致, 缺口没有数据
+    const qint64 rawBytes = static_cast<qint64>(chunk.frames) * m_header.channelCount *
+            CaptureFormat::bytesPerSample(m_header.sampleFormat);
+    if (chunk.encoding != CaptureFormat::Gap && rawBytes > INT_MAX) {
+        return false;
+    }
+    switch (chunk.encoding) {
+    case CaptureFormat::Raw:
+        return chunk.storedBytes == rawBytes;
+    case CaptureFormat::Gap:
+        return chunk.storedBytes == 0;
+    default:
+        return true;
+    }
+}
+
+int CaptureReader::findChunk(qint64 frame) const
+{
+    // 第一帧不大于 frame 的最后一块
+    auto it = std::upper_bound(m_chunks.begin(), m_chunks.end(), frame,
+                               [](qint64 value, const CaptureFormat::ChunkInfo &chunk) {
+        return value < chunk.firstFrame;
+    });
+    return static_cast<int>(it - m_chunks.begin()) - 1;
+}
+
+const uchar *CaptureReader::chunkSamples(int index)
+{
+    const CaptureFormat::ChunkInfo &chunk = m_chunks[index];
+    const uchar *stored = m_mapping + chunk.offset + CaptureFormat::CHUNK_HEADER_SIZE;
+    if (chunk.encoding == CaptureFormat::Raw) {
+        return stored;
+    }
+
+    if (m_decodedChunk != index) {
+        m_decodedChunk = -1;
+        if (!CaptureFormat::decompressChunk(stored, chunk.storedBytes, chunk.frames * m_header.channelCount,
+                                            m_header.sampleFormat, m_header.channelCount, m_decoded)) {
+            // 文件截断到损坏的块之前, 之后的读取和帧数都不再包括这一块及其后的数据
+            m_errorString = QString("第 %1 块数据损坏, 无法解压").arg(index);
+            m_chunks.resize(index);
+            updateFrameCount();
+            m_position = qMin(m_position, m_header.frameCount);
+            return nullptr;
+        }
+        m_decodedChunk = index;
+    }
+    return reinterpret_cast<const uchar *>(m_decoded.constData());
+}
@@ -0,0 +1,80 @@
+#ifndef CAPTUREREADER_H
+#define CAPTUREREADER_H
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QFile>
+#include <QString>
+#include <QVector>
+
+#include "captureformat.h"
+
+// 内存映射的采集文件 (格式见 CaptureFormat) 读取器
+// 打开时只解析文件头和索引; 按帧定位时在索引中二分查找所在的块. 未压缩的块直接从映射内存转换,
+// 压缩的块解压到缓冲区 (只缓存最近一块, 顺序读取时每块只解压一次).
+// 没有正常关闭的文件 (没有索引或索引损坏) 按块头顺序扫描恢复出完整的块.
+// 压缩的块在第一次解压时检查, 解压失败时文件截断到该块之前 (帧数相应减少);
+// 第一个有数据的块在打开时检查, 损坏时打开失败.
+// 录制时丢弃的帧 (缺口) 计入帧数, 读出为0.
+class CaptureReader
+{
+public:
+    CaptureReader();
+    ~CaptureReader();
+
+    // 文件开头是否为采集文件的 magic
+    static bool isCaptureFile(const QString &filePath);
+
+    bool open(const QString &filePath);
+    void close();
+    bool isOpen() const;
+    QString errorString() const;
+
+    CaptureFormat::Header getHeader() const;
+    CaptureFormat::SampleFormat getSampleFormat() const;
+    int getChannelCount() const;
+    double getSamplingRate() const;
+    qint64 getFrameCount() const;
+    QDateTime getStartTime() const;
+    int getChunkCount() const;
+    // 缺口中的帧数 (录制时丢弃, 读出为0)
+    qint64 getMissingFrames() const;
+    // 文件是否正常关闭 (索引有效)
+    bool isComplete() const;
+
+    // 读取位置 (单位: 帧)
+    qint64 getPosition() const;
+    void seek(qint64 frame);
+
+    // 从当前位置读取最多 maxFrames 帧的指定通道, 转换为 double 写入 output, 返回实际读取的帧数
+    int readBlock(double *output, int maxFrames, int channel = 0);
+
+private:
+    // 读取并检查索引, 失败时返回 false
+    bool loadIndex();
+    void scanChunks();
+    // 检查块头与索引项一致, 并取出块的编码
+    bool checkChunk(CaptureFormat::ChunkInfo &chunk, qint64 limit) const;
+    int findChunk(qint64 frame) const;
+    // 由块列表更新文件头中的块数, 帧数和缺口帧数
+    void updateFrameCount();
+    // 块的小端交织样本 (映射内存或解压缓冲区), 数据损坏时截断块列表并返回 nullptr
+    const uchar *chunkSamples(int chunk);
+
+    QFile m_file;
+    uchar *m_mapping;
+    qint64 m_mappingSize;
+
+    CaptureFormat::Header m_header;
+    bool m_complete;
+    QVector<CaptureFormat::ChunkInfo> m_chunks;
+    qint64 m_missingFrames;
+    qint64 m_position;
+
+    int m_decodedChunk;                 // m_decoded 中是哪一块, -1 表示没有
+    QByteArray m_decoded;
+
+    QString m_errorString;
+};
+
+#endif // CAPTUREREADER_H
@@ -0,0 +1,591 @@
+#include "capturewriter.h"
+#include "simdkernels.h"
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QVarLengthArray>
+#include <QtEndian>
+#include <climits>
+#include <cstring>
+#include <type_traits>
+
+// 后台写入线程
+class CaptureWriter::Worker : public QThread
+{
+public:
+    explicit Worker(CaptureWriter *writer) : m_writer(writer) {}
+
+protected:
+    void run() override
+    {
+        m_writer->runWriter();
+    }
+
+private:
+    CaptureWriter *m_writer;
+};
+
+// 按目标格式写入小端样本
+template <typename T>
+static void storeSamples(const T *input, int count, CaptureFormat::SampleFormat format, uchar *output)
+{
+    switch (format) {
+    case CaptureFormat::Int16:
+        for (int i = 0; i < count; ++i) {
+            qToLittleEndian<qint16>(static_cast<qint16>(input[i]), output + 2 * i);
+        }
+        break;
+    case CaptureFormat::Float32:
+        for (int i = 0; i < count; ++i) {
+            const float value = static_cast<float>(input[i]);
+            quint32 bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            qToLittleEndian<quint32>(bits, output + 4 * i);
+        }
+        break;
+    default:
+        for (int i = 0; i < count; ++i) {
+            const double value = static_cast<double>(input[i]);
+            quint64 bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            qToLittleEndian<quint64>(bits, output + 8 * i);
+        }
+        break;
+    }
+}
+
+CaptureWriter::Settings::Settings() :
+    sampleFormat(CaptureFormat::Float64),
+    channelCount(1),
+    samplingRate(8000.0),
+    startTime(0),
+    compressed(true),
+    compressionLevel(1),
+    chunkFrames(DEFAULT_CHUNK_FRAMES),
+    bufferCount(8),
+    bufferSamples(1 << 16)
+{
+}
+
+CaptureWriter::CaptureWriter(QObject *parent) : QObject(parent),
+    m_pendingSamples(0),
+    m_open(false),
+    m_closing(false),
+    m_running(false),
+    m_framesWritten(0),
+    m_bytesWritten(0),
+    m_droppedBlocks(0),
+    m_droppedSamples(0),
+    m_failed(false),
+    m_chunkSamples(0),
+    m_outputOffset(0)
+{
+}
+
+CaptureWriter::~CaptureWriter()
+{
+    close();
+    if (m_worker) {
+        m_worker->wait();
+    }
+}
+
+bool CaptureWriter::open(const QString &filePath, const Settings &settings)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_open || m_running) {
+        m_errorString = "上一个采集文件还没有写完";
+        return false;
+    }
+
+    const qint64 chunkBytes = static_cast<qint64>(settings.chunkFrames) * settings.channelCount *
+            CaptureFormat::bytesPerSample(settings.sampleFormat);
+    if (settings.channelCount <= 0 || settings.channelCount > 65535 || !(settings.samplingRate > 0.0)) {
+        m_errorString = "通道数或采样率无效";
+        return false;
+    }
+    if (settings.chunkFrames <= 0 || chunkBytes > (1 << 28) ||
+            settings.compressionLevel < 1 || settings.compressionLevel > 9) {
+        m_errorString = "每块帧数或压缩级别超出范围";
+        return false;
+    }
+    if (settings.bufferCount <= 0 || settings.bufferSamples <= 0 ||
+            static_cast<qint64>(settings.bufferCount) * settings.bufferSamples * sizeof(double) > (1 << 30)) {
+        m_errorString = "缓冲区池大小超出范围";
+        return false;
+    }
+    locker.unlock();
+
+    // 上一个文件的线程已经写完, 只差退出
+    if (m_worker) {
+        m_worker->wait();
+    }
+
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered)) {
+        locker.relock();
+        m_errorString = QString("无法创建文件: %1").arg(m_file.errorString());
+        return false;
+    }
+
+    // 文件头先占位, 关闭时回填帧数和索引位置
+    CaptureFormat::Header header;
+    header.sampleFormat = settings.sampleFormat;
+    header.channelCount = settings.channelCount;
+    header.samplingRate = settings.samplingRate;
+    header.startTime = settings.startTime;
+    header.chunkFrames = settings.chunkFrames;
+    header.compressed = settings.compressed;
+    m_output.resize(CaptureFormat::HEADER_SIZE);
+    CaptureFormat::writeHeader(header, m_output.data());
+    m_outputOffset = 0;
+    m_chunk.resize(static_cast<int>(chunkBytes));
+    m_chunkSamples = 0;
+    m_chunks.clear();
+    m_failed = false;
+
+    locker.relock();
+    m_settings = settings;
+    m_pendingBlocks.clear();
+    m_pendingSamples = 0;
+    m_framesWritten = 0;
+    m_bytesWritten = 0;
+    m_droppedBlocks = 0;
+    m_droppedSamples = 0;
+    m_pool.clear();
+    m_freeBuffers.clear();
+    m_errorString.clear();
+    m_open = true;
+    m_closing = false;
+    m_running = true;
+    locker.unlock();
+
+    if (!m_worker) {
+        m_worker.reset(new Worker(this));
+    }
+    m_worker->start();
+    return true;
+}
+
+bool CaptureWriter::isOpen() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_open;
+}
+
+CaptureWriter::Settings CaptureWriter::getSettings() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_settings;
+}
+
+void CaptureWriter::write(const QVector<double> &samples)
+{
+    Block block;
+    block.samples = samples;
+    block.int16Samples = false;
+    block.buffer = -1;
+    block.count = 0;
+    block.gap = false;
+    enqueueBlock(block);
+}
+
+void CaptureWriter::write(const QVector<qint16> &samples)
+{
+    Block block;
+    block.samples16 = samples;
+    block.int16Samples = true;
+    block.buffer = -1;
+    block.count = 0;
+    block.gap = false;
+    enqueueBlock(block);
+}
+
+bool CaptureWriter::write(const double *samples, int count, int timeout)
+{
+    return writeCopy(samples, count, false, timeout);
+}
+
+bool CaptureWriter::write(const qint16 *samples, int count, int timeout)
+{
+    return writeCopy(samples, count, true, timeout);
+}
+
+bool CaptureWriter::writeCopy(const void *samples, int count, bool int16Samples, int timeout)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_open || count <= 0) {
+        return false;
+    }
+
+    const int bufferSamples = m_settings.bufferSamples;
+    const int needed = (count + bufferSamples - 1) / bufferSamples;
+    if (m_pool.isEmpty()) {
+        m_pool.resize(m_settings.bufferCount * bufferSamples * static_cast<int>(sizeof(double)));
+        for (int i = m_settings.bufferCount - 1; i >= 0; --i) {
+            m_freeBuffers.append(i);
+        }
+    }
+
+    // 等待后台线程归还缓冲区 (背压); 一块放不进整个缓冲区池或超时时整块丢弃, 文件中不会出现半块
+    QElapsedTimer timer;
+    timer.start();
+    while (m_freeBuffers.size() < needed) {
+        const qint64 remaining = timeout - timer.elapsed();
+        if (needed > m_settings.bufferCount || remaining <= 0 ||
+                !m_bufferReleased.wait(&m_mutex, static_cast<unsigned long>(remaining)) || !m_open) {
+            if (m_open) {
+                ++m_droppedBlocks;
+                m_droppedSamples += count;
+                enqueueGap(count);
+            }
+            return false;
+        }
+    }
+
+    QVarLengthArray<Block, 4> blocks(needed);
+    for (int i = 0; i < needed; ++i) {
+        blocks[i].buffer = m_freeBuffers.takeLast();
+    }
+    locker.unlock();
+
+    // 在锁外复制; 缓冲区排队之前后台线程不会访问
+    const int sampleBytes = int16Samples ? sizeof(qint16) : sizeof(double);
+    const uchar *input = static_cast<const uchar *>(samples);
+    for (int i = 0; i < needed; ++i) {
+        Block &block = blocks[i];
+        block.int16Samples = int16Samples;
+        block.gap = false;
+        block.count = qMin(bufferSamples, count - i * bufferSamples);
+        std::memcpy(bufferData(block.buffer), input + static_cast<qint64>(i) * bufferSamples * sampleBytes,
+                    static_cast<size_t>(block.count) * sampleBytes);
+    }
+
+    locker.relock();
+    for (const Block &block : blocks) {
+        m_pendingBlocks.append(block);
+        m_pendingSamples += block.count;
+    }
+    m_wakeUp.wakeAll();
+    return true;
+}
+
+void CaptureWriter::writeGap(qint64 count)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_open && count > 0) {
+        enqueueGap(count);
+    }
+}
+
+void CaptureWriter::enqueueGap(qint64 count)
+{
+    // 连续的缺口合并为一个; 每个缺口块最多 INT_MAX 个样本
+    while (count > 0) {
+        Block *last = m_pendingBlocks.isEmpty() ? nullptr : &m_pendingBlocks.last();
+        if (!last || !last->gap || last->count == INT_MAX) {
+            Block gap;
+            gap.int16Samples = false;
+            gap.buffer = -1;
+            gap.count = 0;
+            gap.gap = true;
+            m_pendingBlocks.append(gap);
+            last = &m_pendingBlocks.last();
+        }
+        const int added = static_cast<int>(qMin<qint64>(count, INT_MAX - last->count));
+        last->count += added;
+        count -= added;
+    }
+    m_wakeUp.wakeAll();
+}
+
+uchar *CaptureWriter::bufferData(int buffer)
+{
+    return m_pool.data() + static_cast<qint64>(buffer) * m_settings.bufferSamples * sizeof(double);
+}
+
+void CaptureWriter::enqueueBlock(const Block &block)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_open || block.size() == 0) {
+        return;
+    }
+    m_pendingBlocks.append(block);
+    m_pendingSamples += block.size();
+    m_wakeUp.wakeAll();
+}
+
+void CaptureWriter::close()
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_open) {
+        return;
+    }
+    m_open = false;
+    m_closing = true;
+    m_wakeUp.wakeAll();
+}
+
+bool CaptureWriter::waitForFinished(int timeout)
+{
+    QMutexLocker locker(&m_mutex);
+    while (m_running) {
+        if (!m_finished.wait(&m_mutex, timeout < 0 ? ULONG_MAX : static_cast<unsigned long>(timeout))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+QString CaptureWriter::errorString() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_errorString;
+}
+
+qint64 CaptureWriter::getFramesWritten() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_framesWritten;
+}
+
+qint64 CaptureWriter::getBytesWritten() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_bytesWritten;
+}
+
+qint64 CaptureWriter::getPendingSamples() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_pendingSamples;
+}
+
+qint64 CaptureWriter::getDroppedBlocks() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_droppedBlocks;
+}
+
+qint64 CaptureWriter::getDroppedSamples() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_droppedSamples;
+}
+
+void CaptureWriter::runWriter()
+{
+    for (;;) {
+        QMutexLocker locker(&m_mutex);
+        while (m_pendingBlocks.isEmpty() && !m_closing) {
+            m_wakeUp.wait(&m_mutex);
+        }
+        if (m_pendingBlocks.isEmpty()) {
+            break;
+        }
+        const Block block = m_pendingBlocks.takeFirst();
+        m_pendingSamples -= block.size();
+        locker.unlock();
+
+        // 写入失败后丢弃剩余的数据, 直到关闭
+        if (!m_failed) {
+            appendBlock(block);
+        }
+
+        if (block.buffer >= 0) {
+            locker.relock();
+            m_freeBuffers.append(block.buffer);
+            m_bufferReleased.wakeAll();
+        }
+    }
+
+    const bool ok = !m_failed && finishFile();
+    m_file.close();
+    m_output.clear();
+    m_compressed.clear();
+
+    m_mutex.lock();
+    m_closing = false;
+    m_running = false;
+    m_finished.wakeAll();
+    m_mutex.unlock();
+    emit finished(ok);
+}
+
+void CaptureWriter::appendBlock(const Block &block)
+{
+    if (block.gap) {
+        appendGap(block.count / m_settings.channelCount);
+    } else if (block.buffer >= 0) {
+        const uchar *data = bufferData(block.buffer);
+        if (block.int16Samples) {
+            appendSamples(reinterpret_cast<const qint16 *>(data), block.count);
+        } else {
+            appendSamples(reinterpret_cast<const double *>(data), block.count);
+        }
+    } else if (block.int16Samples) {
+        appendSamples(block.samples16.constData(), block.samples16.size());
+    } else {
+        appendSamples(block.samples.constData(), block.samples.size());
+    }
+}
+
+template <typename T>
+void CaptureWriter::appendSamples(const T *samples, int size)
+{
+    const CaptureFormat::SampleFormat format = m_settings.sampleFormat;
+    const int sampleBytes = CaptureFormat::bytesPerSample(format);
+    const int capacity = m_chunk.size() / sampleBytes;
+
+    for (int offset = 0; offset < size && !m_failed; ) {
+        const int count = qMin(size - offset, capacity - m_chunkSamples);
+        uchar *output = m_chunk.data() + m_chunkSamples * sampleBytes;
+        if (std::is_same<T, double>::value && format == CaptureFormat::Int16) {
+            // 与16位流水线相同的取整和限幅
+            m_convert16.resize(count);
+            SimdKernels::convertToInt16(reinterpret_cast<const double *>(samples) + offset, m_convert16.data(), count);
+            storeSamples(m_convert16.constData(), count, format, output);
+        } else {
+            storeSamples(samples + offset, count, format, output);
+        }
+
+        m_chunkSamples += count;
+        offset += count;
+        if (m_chunkSamples == capacity) {
+            encodeChunk();
+        }
+    }
+}
+
+void CaptureWriter::encodeChunk()
+{
+    // 只有最后一块可能不满; 末尾不足一帧的样本丢弃
+    const int channels = m_settings.channelCount;
+    CaptureFormat::ChunkInfo chunk;
+    chunk.frames = m_chunkSamples / channels;
+    m_chunkSamples = 0;
+    if (chunk.frames == 0) {
+        return;
+    }
+
+    const CaptureFormat::SampleFormat format = m_settings.sampleFormat;
+    const int samples = chunk.frames * channels;
+    const uchar *payload = m_chunk.constData();
+    chunk.storedBytes = samples * CaptureFormat::bytesPerSample(format);
+    chunk.encoding = CaptureFormat::Raw;
+    if (m_settings.compressed &&
+            CaptureFormat::compressChunk(payload, samples, format, channels, m_settings.compressionLevel, m_compressed)) {
+        payload = reinterpret_cast<const uchar *>(m_compressed.constData());
+        chunk.storedBytes = m_compressed.size();
+        chunk.encoding = CaptureFormat::Deflate;
+    }
+
+    appendChunk(chunk, payload);
+
+    m_mutex.lock();
+    m_framesWritten += chunk.frames;
+    m_mutex.unlock();
+
+    flushOutput(false);
+}
+
+void CaptureWriter::appendGap(int frames)
+{
+    // 缺口之前不足一块的数据先单独成块, 之后的数据从新块开始
+    encodeChunk();
+    if (frames <= 0 || m_failed) {
+        return;
+    }
+
+    CaptureFormat::ChunkInfo chunk;
+    chunk.frames = frames;
+    chunk.storedBytes = 0;
+    chunk.encoding = CaptureFormat::Gap;
+    appendChunk(chunk, nullptr);
+    flushOutput(false);
+}
+
+void CaptureWriter::appendChunk(CaptureFormat::ChunkInfo &chunk, const uchar *payload)
+{
+    const CaptureFormat::ChunkInfo *last = m_chunks.isEmpty() ? nullptr : &m_chunks.last();
+    chunk.firstFrame = last ? last->firstFrame + last->frames : 0;
+    chunk.offset = m_outputOffset + m_output.size();
+    m_chunks.append(chunk);
+
+    const int position = m_output.size();
+    m_output.resize(position + CaptureFormat::CHUNK_HEADER_SIZE + chunk.storedBytes);
+    CaptureFormat::writeChunkHeader(chunk, m_output.data() + position);
+    if (chunk.storedBytes > 0) {
+        std::memcpy(m_output.data() + position + CaptureFormat::CHUNK_HEADER_SIZE, payload, chunk.storedBytes);
+    }
+}
+
+bool CaptureWriter::flushOutput(bool final)
+{
+    const int size = m_output.size();
+    const int length = final ? size : size / WRITE_BUFFER_SIZE * WRITE_BUFFER_SIZE;
+    if (length == 0) {
+        return true;
+    }
+
+    if (m_file.write(reinterpret_cast<const char *>(m_output.constData()), length) != length) {
+        fail(QString("写入文件失败: %1").arg(m_file.errorString()));
+        return false;
+    }
+
+    uchar *data = m_output.data();
+    std::memmove(data, data + length, size - length);
+    m_output.resize(size - length);
+    m_outputOffset += length;
+
+    m_mutex.lock();
+    m_bytesWritten = m_outputOffset;
+    m_mutex.unlock();
+    return true;
+}
+
+bool CaptureWriter::finishFile()
+{
+    encodeChunk();
+    if (m_failed) {
+        return false;
+    }
+
+    CaptureFormat::Header header;
+    header.sampleFormat = m_settings.sampleFormat;
+    header.channelCount = m_settings.channelCount;
+    header.samplingRate = m_settings.samplingRate;
+    header.startTime = m_settings.startTime;
+    header.creationTime = QDateTime::currentMSecsSinceEpoch();
+    header.chunkFrames = m_settings.chunkFrames;
+    header.compressed = m_settings.compressed;
+    header.chunkCount = m_chunks.size();
+    header.frameCount = m_chunks.isEmpty() ? 0 : m_chunks.last().firstFrame + m_chunks.last().frames;
+    header.indexOffset = m_outputOffset + m_output.size();
+
+    const int position = m_output.size();
+    m_output.resize(position + m_chunks.size() * CaptureFormat::INDEX_ENTRY_SIZE);
+    for (int i = 0; i < m_chunks.size(); ++i) {
+        CaptureFormat::writeIndexEntry(m_chunks[i], m_output.data() + position + i * CaptureFormat::INDEX_ENTRY_SIZE);
+    }
+    if (!flushOutput(true)) {
+        return false;
+    }
+
+    uchar buffer[CaptureFormat::HEADER_SIZE];
+    CaptureFormat::writeHeader(header, buffer);
+    if (!m_file.seek(0) ||
+            m_file.write(reinterpret_cast<const char *>(buffer), sizeof(buffer)) != sizeof(buffer)) {
+        fail(QString("写入文件头失败: %1").arg(m_file.errorString()));
+        return false;
+    }
+    return true;
+}
+
+void CaptureWriter::fail(const QString &error)
+{
+    m_failed = true;
+    QMutexLocker locker(&m_mutex);
+    m_errorString = error;
+}
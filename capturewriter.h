@@ -0,0 +1,149 @@
+#ifndef CAPTUREWRITER_H
+#define CAPTUREWRITER_H
+
+#include <QObject>
+#include <QFile>
+#include <QMutex>
+#include <QVector>
+#include <QWaitCondition>
+#include <memory>
+
+#include "captureformat.h"
+
+// 采集文件 (格式见 CaptureFormat) 的后台写入器
+// write() 只把数据块排队 (QVector 隐式共享, 不拷贝) 后立即返回; 后台线程按块转换为目标采样格式,
+// 编码 (可选无损压缩) 后放入写缓冲区, 每凑满 WRITE_BUFFER_SIZE 字节整块写入一次, 文件偏移始终是
+// WRITE_BUFFER_SIZE 的整数倍. close() 同样不等待: 后台线程写完剩余数据和索引, 回填文件头后发出 finished().
+// 长时间录制使用复制版本的 write(): 数据复制到固定数量的缓冲区 (缓冲区池) 中排队, 后台线程写完后归还,
+// 磁盘跟不上时最多等待 timeout 毫秒, 仍然没有空闲缓冲区就整块丢弃并计数, 内存占用与录制时长无关
+// (只有索引随块数增长, 每块24字节). 丢弃的样本在文件中记为缺口 (CaptureFormat::Gap 块), 帧序号与时间保持对应.
+class CaptureWriter : public QObject
+{
+    Q_OBJECT
+public:
+    struct Settings {
+        CaptureFormat::SampleFormat sampleFormat;
+        int channelCount;
+        double samplingRate;
+        qint64 startTime;               // 第一个样本的时间, 自1970年起的毫秒数 (UTC)
+        bool compressed;
+        int compressionLevel;           // zlib 压缩级别 1..9
+        int chunkFrames;                // 每块的帧数 (同时是随机读取和解压的粒度)
+        int bufferCount;                // 缓冲区池的缓冲区数 (第一次复制写入时分配)
+        int bufferSamples;              // 每个缓冲区的样本数
+
+        Settings();
+    };
+
+    explicit CaptureWriter(QObject *parent = nullptr);
+    // 未关闭的文件会被关闭, 等待后台线程写完
+    ~CaptureWriter();
+
+    // 创建文件并启动后台线程; 参数无效, 无法创建文件或上一个文件还没写完时返回 false, 原因见 errorString()
+    bool open(const QString &filePath, const Settings &settings);
+    bool isOpen() const;
+    Settings getSettings() const;
+
+    // 排队交织样本 (各通道的样本依次排列), 不阻塞. 16位样本写入浮点格式时转换, double 写入 Int16 格式时取整并限幅
+    void write(const QVector<double> &samples);
+    void write(const QVector<qint16> &samples);
+    // 复制版本: 样本复制到缓冲区池后排队, 每 bufferSamples 个样本占用一个缓冲区.
+    // 没有足够的空闲缓冲区时最多等待 timeout 毫秒 (0 表示不等待), 超时则整块丢弃并计数, 返回 false.
+    // 同一个文件只应由一个线程写入
+    bool write(const double *samples, int count, int timeout = 0);
+    bool write(const qint16 *samples, int count, int timeout = 0);
+    // 记录 count 个在上游丢失的样本, 文件中写为缺口 (不计入丢弃统计)
+    void writeGap(qint64 count);
+
+    // 写完排队的数据后关闭文件, 立即返回; 完成后发出 finished()
+    void close();
+    // 等待文件写完; timeout 为毫秒, 负数表示一直等待. 超时返回 false
+    bool waitForFinished(int timeout = -1);
+
+    QString errorString() const;
+    qint64 getFramesWritten() const;    // 已编码的帧数
+    qint64 getBytesWritten() const;     // 已写入文件的字节数
+    qint64 getPendingSamples() const;   // 排队等待写入的样本数
+    qint64 getDroppedBlocks() const;    // 缓冲区池用完时丢弃的块数
+    qint64 getDroppedSamples() const;   // 文件中记为缺口
+
+    static const int WRITE_BUFFER_SIZE = 1 << 20;
+    static const int DEFAULT_CHUNK_FRAMES = 1 << 16;
+
+signals:
+    // 后台线程发出; ok 为 false 时原因见 errorString()
+    void finished(bool ok);
+
+private:
+    class Worker;
+
+    struct Block {
+        QVector<double> samples;
+        QVector<qint16> samples16;
+        bool int16Samples;
+        int buffer;                     // 缓冲区池中的缓冲区, -1 表示数据在 samples/samples16 中
+        int count;                      // 缓冲区中的样本数 (缺口为丢弃的样本数)
+        bool gap;                       // 丢弃的数据, 只占位置
+
+        int size() const
+        {
+            return gap ? 0 : buffer >= 0 ? count : int16Samples ? samples16.size() : samples.size();
+        }
+    };
+
+    void enqueueBlock(const Block &block);
+    bool writeCopy(const void *samples, int count, bool int16Samples, int timeout);
+    // 排队一个缺口, 与队尾的缺口合并 (调用者持有 m_mutex)
+    void enqueueGap(qint64 count);
+    uchar *bufferData(int buffer);
+
+    // 以下在后台线程中运行
+    void runWriter();
+    // 转换样本追加到当前块, 每凑满一块编码一次
+    void appendBlock(const Block &block);
+    template <typename T>
+    void appendSamples(const T *samples, int size);
+    void encodeChunk();
+    // 结束当前块后写入 frames 帧的缺口
+    void appendGap(int frames);
+    // 追加块头和存储的数据到写缓冲区并记入索引
+    void appendChunk(CaptureFormat::ChunkInfo &chunk, const uchar *payload);
+    // 写出写缓冲区中完整的 WRITE_BUFFER_SIZE 字节段; final 为 true 时写出全部
+    bool flushOutput(bool final);
+    // 写入索引并回填文件头
+    bool finishFile();
+    void fail(const QString &error);
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_wakeUp;
+    QWaitCondition m_finished;
+    QWaitCondition m_bufferReleased;
+    QVector<Block> m_pendingBlocks;
+    qint64 m_pendingSamples;
+    bool m_open;                        // open() 之后, close() 之前
+    bool m_closing;
+    bool m_running;                     // 后台线程还在写
+    Settings m_settings;
+    QString m_errorString;
+    qint64 m_framesWritten;
+    qint64 m_bytesWritten;
+    qint64 m_droppedBlocks;
+    qint64 m_droppedSamples;
+    QVector<uchar> m_pool;              // bufferCount 个缓冲区, 每个按 double 计 bufferSamples 个样本
+    QVector<int> m_freeBuffers;
+
+    // 只在后台线程中访问 (open() 在线程启动前初始化)
+    QFile m_file;
+    bool m_failed;
+    QVector<uchar> m_chunk;             // 当前块的小端样本
+    int m_chunkSamples;
+    QByteArray m_compressed;
+    QVector<uchar> m_output;            // 写缓冲区, 第一个字节的文件偏移为 m_outputOffset
+    qint64 m_outputOffset;
+    QVector<CaptureFormat::ChunkInfo> m_chunks;
+    QVector<qint16> m_convert16;
+
+    std::unique_ptr<Worker> m_worker;
+};
+
+#endif // CAPTUREWRITER_H
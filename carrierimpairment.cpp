@@ -0,0 +1,100 @@
+#include "carrierimpairment.h"
+
+#include "nco.h"
+#include "simdkernels.h"
+
+#include <QtMath>
+
+CarrierImpairment::CarrierImpairment() :
+    m_samplingRate(1000.0),
+    m_frequencyOffset(0.0),
+    m_linewidth(0.0),
+    m_phase(0),
+    m_phaseIncrement(0),
+    m_phaseNoise(0.0)
+{
+}
+
+void CarrierImpairment::setSamplingRate(double samplingRate)
+{
+    m_samplingRate = samplingRate;
+    updateIncrement();
+}
+
+double CarrierImpairment::getSamplingRate() const
+{
+    return m_samplingRate;
+}
+
+void CarrierImpairment::setFrequencyOffset(double frequency)
+{
+    m_frequencyOffset = frequency;
+    updateIncrement();
+}
+
+double CarrierImpairment::getFrequencyOffset() const
+{
+    return m_frequencyOffset;
+}
+
+void CarrierImpairment::setPhaseNoiseLinewidth(double linewidth)
+{
+    m_linewidth = qMax(0.0, linewidth);
+}
+
+double CarrierImpairment::getPhaseNoiseLinewidth() const
+{
+    return m_linewidth;
+}
+
+void CarrierImpairment::setSeed(quint64 seed)
+{
+    m_noise.setSeed(seed);
+}
+
+bool CarrierImpairment::isEnabled() const
+{
+    return m_phaseIncrement != 0 || m_linewidth > 0.0;
+}
+
+void CarrierImpairment::reset()
+{
+    m_phase = 0;
+    m_phaseNoise = 0.0;
+}
+
+void CarrierImpairment::updateIncrement()
+{
+    m_phaseIncrement = m_samplingRate > 0.0 ? cyclesToPhase(m_frequencyOffset / m_samplingRate) : 0;
+}
+
+void CarrierImpairment::apply(double *re, double *im, int numSamples)
+{
+    if (numSamples <= 0) {
+        return;
+    }
+
+    // 先逐样本求出相位 (周期), 再由向量内核计算 e^(j*theta) 并相乘
+    m_phaseBuffer.resize(numSamples);
+    double *phase = m_phaseBuffer.data();
+    if (m_linewidth > 0.0 && m_samplingRate > 0.0) {
+        m_noiseBuffer.resize(numSamples);
+        double *noise = m_noiseBuffer.data();
+        m_noise.generate(noise, numSamples);
+
+        const double sigma = std::sqrt(2.0 * M_PI * m_linewidth / m_samplingRate) / (2.0 * M_PI);
+        for (int i = 0; i < numSamples; ++i) {
+            phase[i] = static_cast<qint64>(m_phase) / PHASE_SCALE + m_phaseNoise;
+            m_phase += m_phaseIncrement;
+            m_phaseNoise += sigma * noise[i];
+        }
+        m_phaseNoise -= std::round(m_phaseNoise);
+    } else {
+        for (int i = 0; i < numSamples; ++i) {
+            phase[i] = static_cast<qint64>(m_phase) / PHASE_SCALE + m_phaseNoise;
+            m_phase += m_phaseIncrement;
+        }
+    }
+
+    SimdKernels::rotatePhase(re, im, phase, numSamples);
+}
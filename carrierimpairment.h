@@ -0,0 +1,53 @@
+#ifndef CARRIERIMPAIRMENT_H
+#define CARRIERIMPAIRMENT_H
+
+#include <QVector>
+
+#include "gaussiannoise.h"
+
+// 载波频偏与相位噪声: 复基带 (解析) 信号乘以 e^(j*theta(n))
+// theta(n) = 2*pi*frequencyOffset*n/fs + phi(n), phi 为维纳过程 (自由振荡器的相位噪声),
+// 每个样本的相位增量方差为 2*pi*linewidth/fs, 对应洛伦兹谱的 3dB 全线宽.
+// 频偏部分用64位整数相位累加, 相位噪声的累积值每块折叠一次, 长时间运行不会损失精度.
+class CarrierImpairment
+{
+public:
+    CarrierImpairment();
+
+    void setSamplingRate(double samplingRate);
+    double getSamplingRate() const;
+
+    // 载波频偏 (Hz), 可以为负
+    void setFrequencyOffset(double frequency);
+    double getFrequencyOffset() const;
+
+    // 相位噪声的 3dB 线宽 (Hz), 0 表示没有相位噪声
+    void setPhaseNoiseLinewidth(double linewidth);
+    double getPhaseNoiseLinewidth() const;
+
+    void setSeed(quint64 seed);
+
+    // 频偏和相位噪声都为0时不需要处理
+    bool isEnabled() const;
+
+    // 相位回到0
+    void reset();
+
+    // (re + j*im) *= e^(j*theta(n)), 相位随之前进 numSamples 个样本
+    void apply(double *re, double *im, int numSamples);
+
+private:
+    void updateIncrement();
+
+    double m_samplingRate;
+    double m_frequencyOffset;
+    double m_linewidth;
+    quint64 m_phase;            // 频偏部分的相位, 2^64 对应一个周期
+    quint64 m_phaseIncrement;
+    double m_phaseNoise;        // 相位噪声的累积值 (周期)
+    GaussianNoise m_noise;
+    QVector<double> m_phaseBuffer;
+    QVector<double> m_noiseBuffer;
+};
+
+#endif // CARRIERIMPAIRMENT_H
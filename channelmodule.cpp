@@ -1,7 +1,141 @@
 #include "channelmodule.h"
+#include "simdkernels.h"
+
+#include <QMutexLocker>
+#include <QThread>
+#include <QWaitCondition>
+#include <cstring>
+#include <functional>
+#include <thread>
+#include <vector>
+
+// 常驻的分段处理线程: 在第一次需要时创建, 随 ChannelModule 一起退出.
+// run() 把任务 0..taskCount-1 分给工作线程和调用线程, 全部完成后返回
+class ChannelModule::ChunkWorkers
+{
+public:
+    explicit ChunkWorkers(int threadCount) :
+        m_task(nullptr),
+        m_taskCount(0),
+        m_nextTask(0),
+        m_pendingTasks(0),
+        m_quit(false)
+    {
+        m_threads.reserve(static_cast<size_t>(threadCount));
+        for (int i = 0; i < threadCount; ++i) {
+            m_threads.emplace_back(&ChunkWorkers::work, this);
+        }
+    }
+
+    ~ChunkWorkers()
+    {
+        {
+            QMutexLocker locker(&m_mutex);
+            m_quit = true;
+            m_taskAvailable.wakeAll();
+        }
+        for (std::thread &thread : m_threads) {
+            thread.join();
+        }
+    }
+
+    int threadCount() const
+    {
+        return static_cast<int>(m_threads.size());
+    }
+
+    void run(int taskCount, const std::function<void(int)> &task)
+    {
+        QMutexLocker locker(&m_mutex);
+        m_task = &task;
+        m_taskCount = taskCount;
+        m_nextTask = 0;
+        m_pendingTasks = taskCount;
+        m_taskAvailable.wakeAll();
+
+        // 调用线程也领取任务, 然后等待工作线程上还在运行的任务
+        while (m_nextTask < m_taskCount) {
+            const int index = m_nextTask++;
+            locker.unlock();
+            task(index);
+            locker.relock();
+            --m_pendingTasks;
+        }
+        while (m_pendingTasks > 0) {
+            m_tasksDone.wait(&m_mutex);
+        }
+        m_task = nullptr;
+        m_taskCount = 0;
+        m_nextTask = 0;
+    }
+
+private:
+    void work()
+    {
+        QMutexLocker locker(&m_mutex);
+        for (;;) {
+            while (!m_quit && m_nextTask >= m_taskCount) {
+                m_taskAvailable.wait(&m_mutex);
+            }
+            if (m_quit) {
+                return;
+            }
+            const int index = m_nextTask++;
+            const std::function<void(int)> &task = *m_task;
+            locker.unlock();
+            task(index);
+            locker.relock();
+            if (--m_pendingTasks == 0) {
+                m_tasksDone.wakeAll();
+            }
+        }
+    }
+
+    QMutex m_mutex;
+    QWaitCondition m_taskAvailable;
+    QWaitCondition m_tasksDone;
+    const std::function<void(int)> *m_task;
+    int m_taskCount;
+    int m_nextTask;
+    int m_pendingTasks;
+    bool m_quit;
+    std::vector<std::thread> m_threads;
+};
+
+// 把 [0, numSamples) 均分成若干段交给 processChunk(begin, end). 工作线程常驻,
+// 线程数增加时才重新创建, 每个块不再创建和回收线程
+template <typename Function>
+void ChannelModule::runChunks(int numSamples, Function processChunk)
+{
+    const int chunkCount = qBound(1, numSamples / MIN_SAMPLES_PER_THREAD, qMax(1, effectiveThreadCount()));
+    if (chunkCount == 1) {
+        processChunk(0, numSamples);
+        return;
+    }
+
+    if (!m_workers || m_workers->threadCount() < chunkCount - 1) {
+        m_workers.reset();
+        m_workers.reset(new ChunkWorkers(chunkCount - 1));
+    }
+    auto processIndex = [&](int i) {
+        const int begin = static_cast<int>(static_cast<qint64>(numSamples) * i / chunkCount);
+        const int end = static_cast<int>(static_cast<qint64>(numSamples) * (i + 1) / chunkCount);
+        processChunk(begin, end);
+    };
+    m_workers->run(chunkCount, std::ref(processIndex));
+}
 
 ChannelModule::ChannelModule(QObject *parent) : QObject(parent),
-    m_noiseAmplitude(1.0)
+    m_noiseAmplitude(1.0),
+    m_threadCount(0),
+    m_samplingRate(1000.0),
+    m_fadingEnabled(false)
+{
+    m_hilbert.setTaps(DelayLineFilter::hilbertTaps(HILBERT_HALF_LENGTH));
+    m_hilbertDelay.setTaps({ { HILBERT_HALF_LENGTH, 1.0 } });
+}
+
+ChannelModule::~ChannelModule()
 {
 }
 
@@ -15,53 +149,237 @@ double ChannelModule::getNoiseAmplitude() const
     return m_noiseAmplitude;
 }
 
+void ChannelModule::setNoiseSeed(quint64 seed)
+{
+    m_noise.setSeed(seed);
+}
+
+quint64 ChannelModule::getNoiseSeed() const
+{
+    return m_noise.getSeed();
+}
+
+void ChannelModule::setNoisePosition(quint64 position)
+{
+    m_noise.setPosition(position);
+}
+
+quint64 ChannelModule::getNoisePosition() const
+{
+    return m_noise.getPosition();
+}
+
+void ChannelModule::setThreadCount(int threadCount)
+{
+    m_threadCount = qMax(0, threadCount);
+}
+
+int ChannelModule::getThreadCount() const
+{
+    return m_threadCount;
+}
+
 QVector<double> ChannelModule::processSignal(const QVector<double> &inputSignal)
 {
-    QVector<double> result;
-    result.reserve(inputSignal.size());
-    
-    // 为每个信号样本添加噪声
-    for (double sample : inputSignal) {
-        double noise = generateGaussianNoise() * m_noiseAmplitude;
-        double processedSample = sample + noise;
-        
-        // 确保值在16位范围内
-        processedSample = qBound(-32768.0, processedSample, 32767.0);
-        
-        result.append(processedSample);
-    }
-    
-    m_processedData = result;
+    QVector<double> result(getMaxOutputSamples(inputSignal.size()));
+    result.resize(processSignal(inputSignal.constData(), inputSignal.size(), result.data()));
     return result;
 }
 
+QVector<qint16> ChannelModule::processSignal(const QVector<qint16> &inputSignal)
+{
+    QVector<qint16> result(getMaxOutputSamples(inputSignal.size()));
+    result.resize(processSignal(inputSignal.constData(), inputSignal.size(), result.data()));
+    return result;
+}
+
+int ChannelModule::processSignal(const double *input, int numSamples, double *output)
+{
+    if (hasImpairments()) {
+        numSamples = applyImpairments(input, numSamples, output);
+        input = output;
+    }
+    addNoise(input, output, numSamples);
+    return numSamples;
+}
+
+int ChannelModule::processSignal(const qint16 *input, int numSamples, qint16 *output)
+{
+    if (hasImpairments()) {
+        // 损伤在 double 上计算, 叠加噪声后再转换回16位
+        m_stageInput.resize(getMaxOutputSamples(numSamples));
+        double *signal = m_stageInput.data();
+        SimdKernels::convertFromInt16(input, signal, numSamples);
+        numSamples = applyImpairments(signal, numSamples, signal);
+        addNoise(signal, signal, numSamples);
+        SimdKernels::convertToInt16(signal, output, numSamples);
+        return numSamples;
+    }
+
+    m_noiseBuffer.resize(numSamples);
+    double *noiseBuffer = m_noiseBuffer.data();
+    const quint64 position = m_noise.getPosition();
+    const double amplitude = m_noiseAmplitude;
+    const GaussianNoise &noise = m_noise;
+    runChunks(numSamples, [=, &noise](int begin, int end) {
+        noise.generateAt(position + begin, noiseBuffer + begin, end - begin);
+        SimdKernels::addScaledNoiseInt16(input + begin, noiseBuffer + begin, amplitude, output + begin, end - begin);
+    });
+    m_noise.setPosition(position + numSamples);
+    return numSamples;
+}
+
+int ChannelModule::getMaxOutputSamples(int numSamples) const
+{
+    return m_clockDrift.isEnabled() ? qMax(numSamples, m_clockDrift.getMaxOutputSamples(numSamples)) : numSamples;
+}
+
+// 每段从噪声序列的对应位置生成噪声, 再由向量内核叠加到信号上并限制在16位范围内;
+// 噪声只取决于种子和位置, 分段方式不影响结果. output 可以与 input 相同
+void ChannelModule::addNoise(const double *input, double *output, int numSamples)
+{
+    m_noiseBuffer.resize(numSamples);
+    double *noiseBuffer = m_noiseBuffer.data();
+    const quint64 position = m_noise.getPosition();
+    const double amplitude = m_noiseAmplitude;
+    const GaussianNoise &noise = m_noise;
+    runChunks(numSamples, [=, &noise](int begin, int end) {
+        noise.generateAt(position + begin, noiseBuffer + begin, end - begin);
+        SimdKernels::addScaledNoise(input + begin, noiseBuffer + begin, amplitude, output + begin, end - begin);
+    });
+    m_noise.setPosition(position + numSamples);
+}
+
+void ChannelModule::setSamplingRate(double samplingRate)
+{
+    m_samplingRate = samplingRate;
+    m_fading.setSamplingRate(samplingRate);
+    m_carrier.setSamplingRate(samplingRate);
+}
+
+double ChannelModule::getSamplingRate() const
+{
+    return m_samplingRate;
+}
+
+void ChannelModule::setMultipath(const QVector<DelayLineFilter::Tap> &paths)
+{
+    m_multipath.setTaps(paths);
+}
+
+QVector<DelayLineFilter::Tap> ChannelModule::getMultipath() const
+{
+    return m_multipath.getTaps();
+}
+
+void ChannelModule::setFading(bool enabled, double maxDoppler, double ricianFactor)
+{
+    m_fadingEnabled = enabled;
+    m_fading.setMaxDoppler(maxDoppler);
+    m_fading.setRicianFactor(ricianFactor);
+}
+
+bool ChannelModule::isFadingEnabled() const
+{
+    return m_fadingEnabled;
+}
+
+void ChannelModule::setCarrierOffset(double frequencyOffset, double phaseNoiseLinewidth)
+{
+    m_carrier.setFrequencyOffset(frequencyOffset);
+    m_carrier.setPhaseNoiseLinewidth(phaseNoiseLinewidth);
+}
+
+double ChannelModule::getCarrierFrequencyOffset() const
+{
+    return m_carrier.getFrequencyOffset();
+}
+
+void ChannelModule::setClockDrift(double ppm)
+{
+    m_clockDrift.setDrift(ppm);
+}
+
+double ChannelModule::getClockDrift() const
+{
+    return m_clockDrift.getDrift();
+}
+
+void ChannelModule::setImpairmentSeed(quint64 seed)
+{
+    // 两级使用不同的种子, 避免衰落与相位噪声相关
+    m_fading.setSeed(seed);
+    m_carrier.setSeed(seed ^ Q_UINT64_C(0x9E3779B97F4A7C15));
+}
+
+void ChannelModule::resetImpairments()
+{
+    m_multipath.reset();
+    m_hilbert.reset();
+    m_hilbertDelay.reset();
+    m_fading.reset();
+    m_carrier.reset();
+    m_clockDrift.reset();
+}
+
+bool ChannelModule::hasImpairments() const
+{
+    return !m_multipath.isEmpty() || m_fadingEnabled || m_carrier.isEnabled() || m_clockDrift.isEnabled();
+}
+
+int ChannelModule::applyImpairments(const double *input, int numSamples, double *output)
+{
+    const double *signal = input;
+
+    if (!m_multipath.isEmpty()) {
+        m_multipathOutput.resize(numSamples);
+        m_multipath.process(signal, m_multipathOutput.data(), numSamples);
+        signal = m_multipathOutput.constData();
+    }
+
+    // 实信号 s 与其希尔伯特变换组成解析信号 s + j*H{s}, 乘以复增益后取实部
+    if (m_fadingEnabled || m_carrier.isEnabled()) {
+        m_analyticRe.resize(numSamples);
+        m_analyticIm.resize(numSamples);
+        double *re = m_analyticRe.data();
+        double *im = m_analyticIm.data();
+        m_hilbertDelay.process(signal, re, numSamples);
+        m_hilbert.process(signal, im, numSamples);
+
+        if (m_fadingEnabled) {
+            m_fadingRe.resize(numSamples);
+            m_fadingIm.resize(numSamples);
+            m_fading.generate(m_fadingRe.data(), m_fadingIm.data(), numSamples);
+            SimdKernels::multiplyComplex(re, im, m_fadingRe.constData(), m_fadingIm.constData(), numSamples);
+        }
+        if (m_carrier.isEnabled()) {
+            m_carrier.apply(re, im, numSamples);
+        }
+        signal = re;
+    }
+
+    if (m_clockDrift.isEnabled()) {
+        return m_clockDrift.process(signal, numSamples, output);
+    }
+    if (signal != output) {
+        std::memcpy(output, signal, sizeof(double) * numSamples);
+    }
+    return numSamples;
+}
+
+int ChannelModule::effectiveThreadCount() const
+{
+    return m_threadCount > 0 ? m_threadCount : QThread::idealThreadCount();
+}
+
 void ChannelModule::onSignalReceived(const QVector<double> &inputSignal)
 {
     QVector<double> processedSignal = processSignal(inputSignal);
     emit signalProcessed(processedSignal);
 }
 
-double ChannelModule::generateGaussianNoise()
+void ChannelModule::onSignalReceived16(const QVector<qint16> &inputSignal)
 {
-    // 使用Box-Muller变换生成高斯白噪声
-    static bool hasSpare = false;
-    static double spare;
-    
-    if (hasSpare) {
-        hasSpare = false;
-        return spare;
-    }
-    
-    hasSpare = true;
-    
-    double u1, u2;
-    do {
-        u1 = QRandomGenerator::global()->generateDouble();
-        u2 = QRandomGenerator::global()->generateDouble();
-    } while (u1 <= 1e-7); // 避免对数函数的参数为0
-    
-    double z1 = qSqrt(-2.0 * qLn(u1)) * qCos(2.0 * M_PI * u2);
-    spare = qSqrt(-2.0 * qLn(u1)) * qSin(2.0 * M_PI * u2);
-    
-    return z1;
-} 
\ No newline at end of file
+    QVector<qint16> processedSignal = processSignal(inputSignal);
+    emit signalProcessed16(processedSignal);
+}
@@ -3,34 +3,121 @@
 
 #include <QObject>
 #include <QVector>
-#include <QRandomGenerator>
-#include <QtMath>
+#include <memory>
+
+#include "carrierimpairment.h"
+#include "clockdrift.h"
+#include "delaylinefilter.h"
+#include "fadingchannel.h"
+#include "gaussiannoise.h"
 
 class ChannelModule : public QObject
 {
     Q_OBJECT
 public:
     explicit ChannelModule(QObject *parent = nullptr);
+    ~ChannelModule();
     
     // 设置噪声参数
     void setNoiseAmplitude(double amplitude);
     double getNoiseAmplitude() const;
+    // 噪声种子和位置: 噪声序列只取决于种子和样本位置, 记录二者即可精确重放一次仿真.
+    // setNoiseSeed 同时把位置复位到序列开头
+    void setNoiseSeed(quint64 seed);
+    quint64 getNoiseSeed() const;
+    void setNoisePosition(quint64 position);
+    quint64 getNoisePosition() const;
+
+    // 生成噪声的线程数, 0 表示按CPU核数自动选择; 输出与线程数无关.
+    // 额外的线程在第一次需要时创建并保持到对象销毁
+    void setThreadCount(int threadCount);
+    int getThreadCount() const;
+
+    // 每个线程至少处理的样本数, 更短的段唤醒线程的开销超过收益.
+    // 最大的流模式块 (SignalGenerator::MAX_BLOCK_SIZE) 可以分给8个线程
+    static const int MIN_SAMPLES_PER_THREAD = 1 << 13;
+
+    // 信道损伤, 按 多径 -> 衰落 -> 载波频偏/相位噪声 -> 采样时钟漂移 的顺序作用在信号上, 最后叠加噪声.
+    // 各级都保存跨块的状态, 流式数据可以按任意长度分块连续送入.
+    // 衰落和载波损伤作用在由希尔伯特变换得到的解析信号上, 启用后信号延迟 HILBERT_HALF_LENGTH 个样本
+    void setSamplingRate(double samplingRate);
+    double getSamplingRate() const;
+
+    // 多径: 每条路径的延迟 (样本) 和增益, 为空时关闭
+    void setMultipath(const QVector<DelayLineFilter::Tap> &paths);
+    QVector<DelayLineFilter::Tap> getMultipath() const;
+
+    // 平坦衰落: 最大多普勒频移 (Hz), 莱斯因子 (0 为瑞利衰落)
+    void setFading(bool enabled, double maxDoppler, double ricianFactor);
+    bool isFadingEnabled() const;
+
+    // 载波频偏 (Hz) 与相位噪声线宽 (Hz), 都为0时关闭
+    void setCarrierOffset(double frequencyOffset, double phaseNoiseLinewidth);
+    double getCarrierFrequencyOffset() const;
+
+    // 采样时钟漂移 (ppm), 不为0时输出样本数与输入不同
+    void setClockDrift(double ppm);
+    double getClockDrift() const;
+
+    // 衰落和相位噪声的种子
+    void setImpairmentSeed(quint64 seed);
+
+    // 清空各级损伤的内部状态 (延迟线, 衰落时间, 载波相位, 采样位置)
+    void resetImpairments();
+
+    static const int HILBERT_HALF_LENGTH = 32;
     
     // 处理信号并添加噪声
     QVector<double> processSignal(const QVector<double> &inputSignal);
+    QVector<qint16> processSignal(const QVector<qint16> &inputSignal);
+
+    // 无拷贝版本: 结果写入调用者提供的 output, 返回输出的样本数 (启用时钟漂移时与输入不同).
+    // output 至少能容纳 getMaxOutputSamples(numSamples) 个样本, 可以与 input 相同 (原地处理).
+    // 内部缓冲区在块之间复用, 块大小不增长时不分配内存
+    int processSignal(const double *input, int numSamples, double *output);
+    int processSignal(const qint16 *input, int numSamples, qint16 *output);
+    int getMaxOutputSamples(int numSamples) const;
 
 signals:
     void signalProcessed(const QVector<double> &processedData);
+    void signalProcessed16(const QVector<qint16> &processedData);
 
 public slots:
     void onSignalReceived(const QVector<double> &inputSignal);
+    void onSignalReceived16(const QVector<qint16> &inputSignal);
 
 private:
-    // 生成高斯白噪声
-    double generateGaussianNoise();
-    
+    class ChunkWorkers;
+
+    int effectiveThreadCount() const;  // 实际使用的线程数
+    template <typename Function>
+    void runChunks(int numSamples, Function processChunk);
+    bool hasImpairments() const;
+    int applyImpairments(const double *input, int numSamples, double *output);
+    void addNoise(const double *input, double *output, int numSamples);
+
     double m_noiseAmplitude;
-    QVector<double> m_processedData;
+    int m_threadCount;
+    GaussianNoise m_noise;          // 高斯白噪声发生器, 状态属于本实例
+    QVector<double> m_noiseBuffer;  // 噪声缓冲区, 在块之间复用
+    std::unique_ptr<ChunkWorkers> m_workers;
+
+    double m_samplingRate;
+    bool m_fadingEnabled;
+    DelayLineFilter m_multipath;
+    DelayLineFilter m_hilbert;      // 解析信号的虚部
+    DelayLineFilter m_hilbertDelay; // 实部延迟, 与虚部对齐
+    FadingChannel m_fading;
+    CarrierImpairment m_carrier;
+    ClockDrift m_clockDrift;
+
+    // 各级损伤的中间缓冲区, 在块之间复用
+    QVector<double> m_stageInput;
+    QVector<double> m_multipathOutput;
+    QVector<double> m_analyticRe;
+    QVector<double> m_analyticIm;
+    QVector<double> m_fadingRe;
+    QVector<double> m_fadingIm;
 };
 
 #endif // CHANNELMODULE_H 
\ No newline at end of file
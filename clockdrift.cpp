@@ -0,0 +1,76 @@
+#include "clockdrift.h"
+
+#include "simdkernels.h"
+
+#include <cmath>
+#include <cstring>
+
+ClockDrift::ClockDrift() :
+    m_drift(0.0),
+    m_step(1.0),
+    m_position(2.0)
+{
+    reset();
+}
+
+void ClockDrift::setDrift(double ppm)
+{
+    // 漂移不能使采样间隔小于等于0
+    m_drift = qBound(-1e5, ppm, 1e5);
+    m_step = 1.0 + m_drift * 1e-6;
+}
+
+double ClockDrift::getDrift() const
+{
+    return m_drift;
+}
+
+bool ClockDrift::isEnabled() const
+{
+    return m_drift != 0.0;
+}
+
+void ClockDrift::reset()
+{
+    m_buffer.fill(0.0, HISTORY);
+    m_position = 2.0;
+}
+
+int ClockDrift::getMaxOutputSamples(int numSamples) const
+{
+    // 位置始终不小于2, 每块最多 ceil(numSamples / step) 个输出
+    return static_cast<int>(std::ceil(numSamples / m_step)) + 1;
+}
+
+int ClockDrift::process(const double *input, int numSamples, double *output)
+{
+    if (numSamples <= 0) {
+        return 0;
+    }
+
+    const int length = HISTORY + numSamples;
+    m_buffer.resize(length);
+    double *buffer = m_buffer.data();
+    std::memcpy(buffer + HISTORY, input, sizeof(double) * numSamples);
+
+    // 输出位置 t_k = m_position + k * step 需要满足 t_k < length - 2 (插值用到 t 之后两个样本)
+    const double limit = length - 2;
+    int count = 0;
+    if (m_position < limit) {
+        count = static_cast<int>(std::ceil((limit - m_position) / m_step));
+        while (count > 0 && m_position + (count - 1) * m_step >= limit) {
+            --count;
+        }
+        while (m_position + count * m_step < limit) {
+            ++count;
+        }
+    }
+
+    SimdKernels::interpolateCubic(buffer, m_position, m_step, output, count);
+
+    // 下一块的位置相对于保留下来的最后 HISTORY 个样本, 始终不小于2
+    m_position += count * m_step - numSamples;
+    std::memmove(buffer, buffer + numSamples, sizeof(double) * HISTORY);
+    m_buffer.resize(HISTORY);
+    return count;
+}
@@ -0,0 +1,38 @@
+#ifndef CLOCKDRIFT_H
+#define CLOCKDRIFT_H
+
+#include <QVector>
+
+// 采样时钟漂移: 以略微不同的采样间隔对输入重新采样 (4点三次拉格朗日插值)
+// 漂移为 ppm 时每个输出样本对应 1 + ppm * 1e-6 个输入样本, 正值表示接收端时钟偏慢, 输出样本数相应减少.
+// 内部保存最近几个输入样本和小数位置, 数据可以按任意长度分块连续送入; 固定引入约2个样本的延迟.
+class ClockDrift
+{
+public:
+    ClockDrift();
+
+    void setDrift(double ppm);
+    double getDrift() const;
+
+    // 漂移为0时不需要处理
+    bool isEnabled() const;
+
+    // 清空历史, 位置回到起点
+    void reset();
+
+    // 处理一块输入, 输出约 numSamples / (1 + ppm * 1e-6) 个样本 (具体个数取决于块之间的小数位置),
+    // 返回输出的样本数. output 至少能容纳 getMaxOutputSamples(numSamples) 个样本, 可以与 input 相同
+    int process(const double *input, int numSamples, double *output);
+    int getMaxOutputSamples(int numSamples) const;
+
+    // 保留的历史样本数: 插值需要位置前后各两个样本
+    static const int HISTORY = 4;
+
+private:
+    double m_drift;
+    double m_step;              // 每个输出样本前进的输入样本数
+    double m_position;          // 下一个输出样本在 m_buffer 中的位置
+    QVector<double> m_buffer;   // [HISTORY 个历史样本 | 当前块]
+};
+
+#endif // CLOCKDRIFT_H
@@ -0,0 +1,337 @@
+#include "decimator.h"
+
+#include "simdkernels.h"
+#include "windowfunction.h"
+
+#include <QtMath>
+#include <cstring>
+
+// 半带滤波器实测阻带衰减不足时, 设计指标最多提高的量 (dB)
+static const double MAX_HALF_BAND_MARGIN_DB = 20.0;
+
+// 部分主元高斯消元求解 n 阶线性方程组 a * x = b (a 按行存放), 结果写入 b
+static void solveLinearSystem(QVector<double> &a, QVector<double> &b, int n)
+{
+    for (int col = 0; col < n; ++col) {
+        int pivot = col;
+        for (int row = col + 1; row < n; ++row) {
+            if (std::abs(a[row * n + col]) > std::abs(a[pivot * n + col])) {
+                pivot = row;
+            }
+        }
+        if (pivot != col) {
+            for (int k = 0; k < n; ++k) {
+                std::swap(a[col * n + k], a[pivot * n + k]);
+            }
+            std::swap(b[col], b[pivot]);
+        }
+        for (int row = col + 1; row < n; ++row) {
+            const double scale = a[row * n + col] / a[col * n + col];
+            for (int k = col; k < n; ++k) {
+                a[row * n + k] -= scale * a[col * n + k];
+            }
+            b[row] -= scale * b[col];
+        }
+    }
+    for (int row = n - 1; row >= 0; --row) {
+        double sum = b[row];
+        for (int k = row + 1; k < n; ++k) {
+            sum -= a[row * n + k] * b[k];
+        }
+        b[row] = sum / a[row * n + row];
+    }
+}
+
+Decimator::Decimator() :
+    m_factor(1),
+    m_cicFactor(1),
+    m_cicPhase(0),
+    m_compensate(false),
+    m_usePolyphase(false)
+{
+}
+
+bool Decimator::setFactor(int factor, double passband, double attenuationDb)
+{
+    if (factor < 1 || factor > MAX_FACTOR || !(passband > 0.0 && passband < 1.0) ||
+            !(attenuationDb >= 20.0 && attenuationDb <= 200.0)) {
+        return false;
+    }
+
+    int halfBandCount = 0;
+    int oddFactor = factor;
+    while (oddFactor % 2 == 0) {
+        oddFactor /= 2;
+        ++halfBandCount;
+    }
+
+    // 只有奇数倍时没有后级滤除 CIC 的混叠, 改用多相 FIR 一次抽取
+    const bool usePolyphase = halfBandCount == 0 && oddFactor > 1;
+    if (usePolyphase && !m_polyphase.setRatio(1, oddFactor, passband, attenuationDb)) {
+        return false;
+    }
+
+    // 第 i 级之后 (含本级) 还要抽取 2^r 倍, 要保护的通带 passband * fs_out / 2 按本级输入采样率归一化
+    m_halfBands.clear();
+    for (int i = 0; i < halfBandCount; ++i) {
+        const int remaining = halfBandCount - i;
+        m_halfBands.append(designHalfBand(passband * 0.5 / (1 << remaining), attenuationDb));
+    }
+
+    m_factor = factor;
+    m_usePolyphase = usePolyphase;
+    m_cicFactor = usePolyphase ? 1 : oddFactor;
+    m_compensate = m_cicFactor > 1;
+    if (m_cicFactor > 1) {
+        m_cic.setOrder(CIC_ORDER);
+        m_cic.setLength(m_cicFactor);
+        m_compensator.setTaps(compensatorTaps(m_cicFactor, factor, passband * 0.5));
+    }
+    m_polyphaseOutput.resize(m_polyphase.getMaxOutputSize(TILE_SIZE));
+    reset();
+    return true;
+}
+
+int Decimator::getFactor() const
+{
+    return m_factor;
+}
+
+QVector<int> Decimator::getStageFactors() const
+{
+    QVector<int> factors;
+    if (m_usePolyphase) {
+        factors.append(m_polyphase.getDecimation());
+    }
+    if (m_cicFactor > 1) {
+        factors.append(m_cicFactor);
+    }
+    for (int i = 0; i < m_halfBands.size(); ++i) {
+        factors.append(2);
+    }
+    return factors;
+}
+
+void Decimator::reset()
+{
+    m_cic.reset();
+    m_cicPhase = 0;
+    for (HalfBand &stage : m_halfBands) {
+        stage.buffer.fill(0.0, 4 * stage.taps.size() - 2);
+        stage.phase = 0;
+    }
+    m_compensator.reset();
+    m_polyphase.reset();
+}
+
+int Decimator::getMaxOutputSize(int numSamples) const
+{
+    // 每个输出对应输入中间隔 factor 的一个样本
+    return numSamples > 0 ? (numSamples + m_factor - 1) / m_factor : 0;
+}
+
+int Decimator::process(const double *input, int numSamples, double *output)
+{
+    if (m_factor == 1) {
+        if (output != input && numSamples > 0) {
+            std::memmove(output, input, sizeof(double) * numSamples);
+        }
+        return qMax(numSamples, 0);
+    }
+
+    // 输出不会超过已经读取的输入, output 可以与 input 相同
+    m_tile.resize(TILE_SIZE);
+    double *tile = m_tile.data();
+    int count = 0;
+    for (int start = 0; start < numSamples; start += TILE_SIZE) {
+        const int size = qMin(TILE_SIZE, numSamples - start);
+        std::memcpy(tile, input + start, sizeof(double) * size);
+        const int produced = processTile(tile, size);
+        std::memcpy(output + count, tile, sizeof(double) * produced);
+        count += produced;
+    }
+    return count;
+}
+
+int Decimator::process(const qint16 *input, int numSamples, qint16 *output)
+{
+    if (m_factor == 1) {
+        if (output != input && numSamples > 0) {
+            std::memmove(output, input, sizeof(qint16) * numSamples);
+        }
+        return qMax(numSamples, 0);
+    }
+
+    m_tile.resize(TILE_SIZE);
+    double *tile = m_tile.data();
+    int count = 0;
+    for (int start = 0; start < numSamples; start += TILE_SIZE) {
+        const int size = qMin(TILE_SIZE, numSamples - start);
+        SimdKernels::convertFromInt16(input + start, tile, size);
+        const int produced = processTile(tile, size);
+        SimdKernels::convertToInt16(tile, output + count, produced);
+        count += produced;
+    }
+    return count;
+}
+
+// 半带滤波器中心右侧的非零抽头, Kaiser 窗按 designDb 选取 beta 并用经验公式估计长度
+static QVector<double> halfBandTaps(double passbandEdge, double designDb)
+{
+    // 长度 4j+3: 除中心外只有奇数偏移的抽头非零, 两端的抽头不为0
+    const double transition = 0.5 - 2.0 * passbandEdge;
+    const double estimate = (designDb - 7.95) / (14.36 * transition) + 1.0;
+    const int pairs = qMax(1, static_cast<int>(std::ceil((estimate - 3.0) / 4.0)) + 1);
+    const int length = 4 * pairs - 1;
+    const int center = length / 2;
+
+    const QVector<double> window = WindowFunction::generate(WindowFunction::Kaiser, length,
+                                                            WindowFunction::kaiserBeta(designDb));
+    const QVector<double> prototype = FirFilter::lowPassTaps(0.25, 1.0, length, window);
+
+    // 截止频率为 fs/4 的 sinc 在偶数偏移处为0; 奇数偏移的抽头之和归一化为 0.25 (两侧合计 0.5), 直流增益正好为1
+    QVector<double> taps(pairs);
+    double sum = 0.0;
+    for (int i = 0; i < pairs; ++i) {
+        taps[i] = prototype[center + 2 * i + 1];
+        sum += taps[i];
+    }
+    for (double &tap : taps) {
+        tap *= 0.25 / sum;
+    }
+    return taps;
+}
+
+// 半带滤波器在阻带 [0.5 - passbandEdge, 0.5] 上的最大增益, H(f) = 0.5 + 2 * sum(h[c+2i+1] * cos(2 pi (2i+1) f))
+static double halfBandStopbandGain(const QVector<double> &taps, double passbandEdge)
+{
+    const int points = 16 * 4 * taps.size();
+    double peak = 0.0;
+    for (int k = 0; k <= points; ++k) {
+        const double f = 0.5 - passbandEdge * k / points;
+        double response = 0.5;
+        for (int i = 0; i < taps.size(); ++i) {
+            response += 2.0 * taps[i] * std::cos(2.0 * M_PI * (2 * i + 1) * f);
+        }
+        peak = qMax(peak, std::abs(response));
+    }
+    return peak;
+}
+
+Decimator::HalfBand Decimator::designHalfBand(double passbandEdge, double attenuationDb)
+{
+    // 经验公式对较短的滤波器偏乐观, 实测的阻带衰减不足 attenuationDb 时逐步提高设计指标.
+    // 每一级单独满足指标, 级联后各级的混叠都低于 attenuationDb
+    const double maxGain = std::pow(10.0, -attenuationDb / 20.0);
+    QVector<double> taps;
+    for (double designDb = attenuationDb; designDb <= attenuationDb + MAX_HALF_BAND_MARGIN_DB; designDb += 1.0) {
+        taps = halfBandTaps(passbandEdge, designDb);
+        if (halfBandStopbandGain(taps, passbandEdge) <= maxGain) {
+            break;
+        }
+    }
+
+    HalfBand stage;
+    stage.taps = taps;
+    stage.buffer.fill(0.0, 4 * taps.size() - 2);
+    stage.phase = 0;
+    return stage;
+}
+
+QVector<double> Decimator::compensatorTaps(int cicFactor, int outputFactor, double passbandEdge)
+{
+    // 对称 FIR 的幅度响应 A(f) = c0 + 2 * sum(c_p * cos(2 pi p f)), 在通带内均匀取点,
+    // 最小化 sum((A(f) * H_cic(f) - 1)^2), 解 (P+1) 阶正规方程
+    const int half = COMPENSATOR_LENGTH / 2;
+    const int n = half + 1;
+    const int points = 64;
+    QVector<double> normal(n * n, 0.0);
+    QVector<double> rhs(n, 0.0);
+    QVector<double> basis(n);
+    for (int g = 0; g < points; ++g) {
+        const double f = passbandEdge * g / (points - 1);
+        // CIC 工作在输入采样率上
+        const double x = M_PI * f / outputFactor;
+        const double response = g == 0 ? 1.0 : std::pow(std::abs(std::sin(cicFactor * x) / (cicFactor * std::sin(x))),
+                                                        CIC_ORDER);
+        for (int p = 0; p < n; ++p) {
+            basis[p] = response * (p == 0 ? 1.0 : 2.0 * std::cos(2.0 * M_PI * p * f));
+        }
+        for (int row = 0; row < n; ++row) {
+            for (int col = 0; col < n; ++col) {
+                normal[row * n + col] += basis[row] * basis[col];
+            }
+            rhs[row] += basis[row];
+        }
+    }
+    solveLinearSystem(normal, rhs, n);
+
+    QVector<double> taps(COMPENSATOR_LENGTH);
+    for (int p = 0; p < n; ++p) {
+        taps[half + p] = rhs[p];
+        taps[half - p] = rhs[p];
+    }
+    return taps;
+}
+
+int Decimator::processTile(double *data, int numSamples)
+{
+    if (m_usePolyphase) {
+        const int count = m_polyphase.process(data, numSamples, m_polyphaseOutput.data());
+        std::memcpy(data, m_polyphaseOutput.constData(), sizeof(double) * count);
+        return count;
+    }
+
+    int count = numSamples;
+    if (m_cicFactor > 1) {
+        count = processCic(data, count);
+    }
+    for (HalfBand &stage : m_halfBands) {
+        count = processHalfBand(stage, data, count);
+    }
+    if (m_compensate) {
+        m_compensator.process(data, data, count);
+    }
+    return count;
+}
+
+int Decimator::processCic(double *data, int numSamples)
+{
+    // 滑动平均级联 (增益已归一化) 后每 C 个样本保留一个
+    m_cic.process(data, data, numSamples);
+    int count = 0;
+    int i = m_cicPhase;
+    for (; i < numSamples; i += m_cicFactor) {
+        data[count++] = data[i];
+    }
+    m_cicPhase = i - numSamples;
+    return count;
+}
+
+int Decimator::processHalfBand(HalfBand &stage, double *data, int numSamples)
+{
+    const int pairs = stage.taps.size();
+    const int center = 2 * pairs - 1;
+    const int history = 2 * center;
+    stage.buffer.resize(history + numSamples);
+    double *buffer = stage.buffer.data();
+    std::memcpy(buffer + history, data, sizeof(double) * numSamples);
+
+    // 只计算保留的输出: y[n] = 0.5 * x[n-c] + sum(h[c+2i+1] * (x[n-c-2i-1] + x[n-c+2i+1]))
+    const double *taps = stage.taps.constData();
+    int count = 0;
+    int i = stage.phase;
+    for (; i < numSamples; i += 2) {
+        const double *middle = buffer + i + center;
+        double sum = 0.5 * middle[0];
+        for (int k = 0; k < pairs; ++k) {
+            sum += taps[k] * (middle[-2 * k - 1] + middle[2 * k + 1]);
+        }
+        data[count++] = sum;
+    }
+    stage.phase = i - numSamples;
+
+    std::memmove(buffer, buffer + numSamples, sizeof(double) * history);
+    stage.buffer.resize(history);
+    return count;
+}
@@ -0,0 +1,75 @@
+#ifndef DECIMATOR_H
+#define DECIMATOR_H
+
+#include <QVector>
+
+#include "firfilter.h"
+#include "movingaverage.h"
+#include "polyphaseresampler.h"
+
+// 多级流式整数倍抽取器: 输出采样率 = 输入采样率 / factor, 保护 [0, passband * 输出奈奎斯特频率] 不被混叠.
+// factor = C * 2^k (C 为奇数), 按速率从高到低:
+//  - C > 1 且 k > 0: C 倍 CIC 抽取 (CIC_ORDER 级滑动平均, 每个输入只有加减), 然后 k 级半带抽取,
+//    最后在输出速率上用短的对称 FIR 补偿 CIC 在通带内的 sinc^N 衰减
+//  - C = 1: k 级半带抽取. 半带滤波器一半抽头为0, 对称抽头两两合并, 每级只计算保留的输出;
+//    越靠后的级速率越低, 过渡带越窄, 滤波器越长, 最后一级的过渡带为输出采样率的 (1 - passband) / 2
+//  - k = 0: 单级多相 FIR 抽取 (PolyphaseResampler)
+// 按 TILE_SIZE 个输入分段逐级处理, 各级状态在块之间保留, 数据可以按任意长度分块连续送入.
+class Decimator
+{
+public:
+    Decimator();
+
+    // 设置倍数并设计各级, 清空状态; factor 为1时直通. 参数超出范围时返回 false, 保持原来的设计
+    bool setFactor(int factor, double passband = 0.8, double attenuationDb = 80.0);
+    int getFactor() const;
+    // 各级的抽取倍数, 按处理顺序
+    QVector<int> getStageFactors() const;
+
+    // 清空状态 (之前的输入视为0)
+    void reset();
+
+    // numSamples 个输入最多产生的输出数
+    int getMaxOutputSize(int numSamples) const;
+    // 返回输出样本数; output 至少 getMaxOutputSize(numSamples) 个样本, 可以与 input 相同
+    int process(const double *input, int numSamples, double *output);
+    // 16位定点数据转换为 double 抽取后再饱和转换回来
+    int process(const qint16 *input, int numSamples, qint16 *output);
+
+    static const int MAX_FACTOR = 1024;
+    static const int CIC_ORDER = 8;
+    static const int COMPENSATOR_LENGTH = 9;
+    static const int TILE_SIZE = 1024;
+
+private:
+    struct HalfBand {
+        QVector<double> taps;       // 中心右侧的非零抽头 h[c+1], h[c+3], ..., 中心抽头为 0.5
+        QVector<double> buffer;     // [最近 length - 1 个历史样本 | 当前段]
+        int phase;                  // 当前段中第一个产生输出的样本
+    };
+
+    // 半带滤波器: 通带 [0, passbandEdge] (按本级输入采样率归一化), 阻带从 0.5 - passbandEdge 开始,
+    // 阻带衰减按实际响应检验, 不足时提高设计指标
+    static HalfBand designHalfBand(double passbandEdge, double attenuationDb);
+    // 最小二乘拟合 1 / CIC 幅度响应 (按输出采样率归一化的 [0, passbandEdge])
+    static QVector<double> compensatorTaps(int cicFactor, int outputFactor, double passbandEdge);
+
+    // 原地处理一段, 返回输出样本数
+    int processTile(double *data, int numSamples);
+    int processCic(double *data, int numSamples);
+    static int processHalfBand(HalfBand &stage, double *data, int numSamples);
+
+    int m_factor;
+    int m_cicFactor;                // 1 表示没有 CIC 级
+    MovingAverage m_cic;
+    int m_cicPhase;                 // 下一段中第一个保留的样本
+    QVector<HalfBand> m_halfBands;
+    bool m_compensate;
+    FirFilter m_compensator;
+    bool m_usePolyphase;
+    PolyphaseResampler m_polyphase;
+    QVector<double> m_tile;
+    QVector<double> m_polyphaseOutput;
+};
+
+#endif // DECIMATOR_H
@@ -0,0 +1,87 @@
+#include "delaylinefilter.h"
+
+#include "simdkernels.h"
+
+#include <QtMath>
+#include <algorithm>
+#include <cstring>
+
+DelayLineFilter::DelayLineFilter() :
+    m_maxDelay(0)
+{
+}
+
+void DelayLineFilter::setTaps(const QVector<Tap> &taps)
+{
+    m_taps.clear();
+    m_maxDelay = 0;
+    for (const Tap &tap : taps) {
+        if (tap.delay >= 0) {
+            m_taps.append(tap);
+            m_maxDelay = qMax(m_maxDelay, tap.delay);
+        }
+    }
+    reset();
+}
+
+QVector<DelayLineFilter::Tap> DelayLineFilter::getTaps() const
+{
+    return m_taps;
+}
+
+bool DelayLineFilter::isEmpty() const
+{
+    return m_taps.isEmpty();
+}
+
+int DelayLineFilter::getMaxDelay() const
+{
+    return m_maxDelay;
+}
+
+void DelayLineFilter::reset()
+{
+    m_buffer.fill(0.0, m_maxDelay);
+}
+
+void DelayLineFilter::process(const double *input, double *output, int numSamples)
+{
+    if (numSamples <= 0) {
+        return;
+    }
+
+    // 当前块接在历史样本之后, 第 i 个输出对应 buffer[m_maxDelay + i]
+    m_buffer.resize(m_maxDelay + numSamples);
+    double *buffer = m_buffer.data();
+    std::memcpy(buffer + m_maxDelay, input, sizeof(double) * numSamples);
+
+    for (int start = 0; start < numSamples; start += TILE_SIZE) {
+        const int count = qMin(TILE_SIZE, numSamples - start);
+        double *tile = output + start;
+        std::fill(tile, tile + count, 0.0);
+        for (const Tap &tap : m_taps) {
+            SimdKernels::multiplyAccumulate(buffer + m_maxDelay - tap.delay + start, tap.gain, tile, count);
+        }
+    }
+
+    // 保留最后 m_maxDelay 个样本作为下一块的历史
+    std::memmove(buffer, buffer + numSamples, sizeof(double) * m_maxDelay);
+    m_buffer.resize(m_maxDelay);
+}
+
+QVector<DelayLineFilter::Tap> DelayLineFilter::hilbertTaps(int halfLength)
+{
+    // 理想希尔伯特变换器 h[k] = 2 / (pi * k) (k 为奇数), 偶数项为0
+    QVector<Tap> taps;
+    const int length = 2 * halfLength + 1;
+    for (int k = -halfLength; k <= halfLength; ++k) {
+        if (k % 2 == 0) {
+            continue;
+        }
+        const double n = k + halfLength;
+        const double window = 0.42 - 0.5 * std::cos(2.0 * M_PI * n / (length - 1))
+                              + 0.08 * std::cos(4.0 * M_PI * n / (length - 1));
+        taps.append({ k + halfLength, 2.0 / (M_PI * k) * window });
+    }
+    return taps;
+}
@@ -0,0 +1,43 @@
+#ifndef DELAYLINEFILTER_H
+#define DELAYLINEFILTER_H
+
+#include <QVector>
+
+// 稀疏抽头延迟线滤波器: y[n] = sum(gain_k * x[n - delay_k])
+// 用于多径信道 (每条路径一个抽头) 和希尔伯特变换器. 内部保存最近 maxDelay 个输入样本,
+// 数据可以按任意长度分块连续送入, 结果与一次性处理整段数据相同.
+// 每块按 TILE_SIZE 个样本分段, 段内逐抽头用向量内核累加.
+class DelayLineFilter
+{
+public:
+    struct Tap {
+        int delay;      // 样本数, >= 0
+        double gain;
+    };
+
+    DelayLineFilter();
+
+    // 设置抽头并清空历史, 负延迟的抽头被忽略
+    void setTaps(const QVector<Tap> &taps);
+    QVector<Tap> getTaps() const;
+    bool isEmpty() const;
+    int getMaxDelay() const;
+
+    // 清空历史 (之前的输入视为0)
+    void reset();
+
+    // output 可以与 input 相同
+    void process(const double *input, double *output, int numSamples);
+
+    // 奇数长度 2 * halfLength + 1 的 Blackman 窗希尔伯特变换器, 群延迟 halfLength 个样本
+    static QVector<Tap> hilbertTaps(int halfLength);
+
+    static const int TILE_SIZE = 1024;
+
+private:
+    QVector<Tap> m_taps;
+    int m_maxDelay;
+    QVector<double> m_buffer;   // [最近 m_maxDelay 个历史样本 | 当前块]
+};
+
+#endif // DELAYLINEFILTER_H
@@ -0,0 +1,136 @@
+#include "fadingchannel.h"
+
+#include "nco.h"
+#include "philox.h"
+#include "simdkernels.h"
+
+#include <QRandomGenerator>
+#include <QtMath>
+#include <algorithm>
+
+// 由种子和序号确定的 [0, 1) 均匀随机数
+static double uniformAt(quint64 seed, quint32 index)
+{
+    const quint32 key[2] = { static_cast<quint32>(seed), static_cast<quint32>(seed >> 32) };
+    quint32 block[4] = { index, 0, 0, 0 };
+    Philox::generate(key, block);
+    const quint64 bits = block[0] | (static_cast<quint64>(block[1]) << 32);
+    return (bits >> 11) * (1.0 / 9007199254740992.0);
+}
+
+FadingChannel::FadingChannel() :
+    m_samplingRate(1000.0),
+    m_maxDoppler(1.0),
+    m_ricianFactor(0.0),
+    m_seed(QRandomGenerator::global()->generate64()),
+    m_sampleIndex(0),
+    m_lineOfSightPhase(0.0)
+{
+    updateSinusoids();
+}
+
+void FadingChannel::setSamplingRate(double samplingRate)
+{
+    m_samplingRate = samplingRate;
+    updateSinusoids();
+}
+
+double FadingChannel::getSamplingRate() const
+{
+    return m_samplingRate;
+}
+
+void FadingChannel::setMaxDoppler(double frequency)
+{
+    m_maxDoppler = qMax(0.0, frequency);
+    updateSinusoids();
+}
+
+double FadingChannel::getMaxDoppler() const
+{
+    return m_maxDoppler;
+}
+
+void FadingChannel::setRicianFactor(double factor)
+{
+    m_ricianFactor = qMax(0.0, factor);
+}
+
+double FadingChannel::getRicianFactor() const
+{
+    return m_ricianFactor;
+}
+
+void FadingChannel::setSeed(quint64 seed)
+{
+    m_seed = seed;
+    m_sampleIndex = 0;
+    updateSinusoids();
+}
+
+quint64 FadingChannel::getSeed() const
+{
+    return m_seed;
+}
+
+void FadingChannel::reset()
+{
+    m_sampleIndex = 0;
+}
+
+void FadingChannel::updateSinusoids()
+{
+    // Zheng & Xiao: 第 n 个入射角 alpha_n = (2*pi*n - pi + theta) / (4*M), n = 1..M,
+    // 同相支路频率 fd*cos(alpha_n), 正交支路频率 fd*sin(alpha_n), 两条支路初相位独立均匀分布
+    const int count = SINUSOID_COUNT;
+    m_phaseOffsets.resize(2 * count);
+    m_phaseIncrements.resize(2 * count);
+    m_stepRe.resize(2 * count);
+    m_stepIm.resize(2 * count);
+
+    const double theta = (2.0 * uniformAt(m_seed, 0) - 1.0) * M_PI;
+    const double normalizedDoppler = m_samplingRate > 0.0 ? m_maxDoppler / m_samplingRate : 0.0;
+    for (int n = 0; n < count; ++n) {
+        const double alpha = (2.0 * M_PI * (n + 1) - M_PI + theta) / (4.0 * count);
+        const double frequencies[2] = { normalizedDoppler * std::cos(alpha), normalizedDoppler * std::sin(alpha) };
+        for (int branch = 0; branch < 2; ++branch) {
+            const int k = branch * count + n;
+            m_phaseOffsets[k] = cyclesToPhase(uniformAt(m_seed, static_cast<quint32>(1 + k)));
+            m_phaseIncrements[k] = cyclesToPhase(frequencies[branch]);
+
+            const double step = phaseToRadians(m_phaseIncrements[k]);
+            m_stepRe[k] = std::cos(step);
+            m_stepIm[k] = std::sin(step);
+        }
+    }
+    m_lineOfSightPhase = 2.0 * M_PI * uniformAt(m_seed, static_cast<quint32>(1 + 2 * count));
+}
+
+void FadingChannel::generate(double *gainRe, double *gainIm, int numSamples)
+{
+    // 散射分量每支路功率 1 / (2 * (K + 1)), 直射分量功率 K / (K + 1)
+    const int count = SINUSOID_COUNT;
+    const double scatterAmplitude = std::sqrt(1.0 / (count * (m_ricianFactor + 1.0)));
+    const double lineOfSight = std::sqrt(m_ricianFactor / (m_ricianFactor + 1.0));
+    const double lineOfSightRe = lineOfSight * std::cos(m_lineOfSightPhase);
+    const double lineOfSightIm = lineOfSight * std::sin(m_lineOfSightPhase);
+
+    for (int start = 0; start < numSamples; start += TILE_SIZE) {
+        const int tileSize = qMin(TILE_SIZE, numSamples - start);
+        double *tileRe = gainRe + start;
+        double *tileIm = gainIm + start;
+        std::fill(tileRe, tileRe + tileSize, lineOfSightRe);
+        std::fill(tileIm, tileIm + tileSize, lineOfSightIm);
+
+        // z = A * e^(j*angle), 实部即 A * cos(angle)
+        const quint64 sampleIndex = static_cast<quint64>(m_sampleIndex + start);
+        for (int k = 0; k < 2 * count; ++k) {
+            const double angle = phaseToRadians(m_phaseOffsets[k] + sampleIndex * m_phaseIncrements[k]);
+            double re = scatterAmplitude * std::cos(angle);
+            double im = scatterAmplitude * std::sin(angle);
+            SimdKernels::accumulateTone(re, im, m_stepRe[k], m_stepIm[k],
+                                        k < count ? tileRe : tileIm, tileSize);
+        }
+    }
+    m_sampleIndex += numSamples;
+}
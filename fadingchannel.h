@@ -0,0 +1,57 @@
+#ifndef FADINGCHANNEL_H
+#define FADINGCHANNEL_H
+
+#include <QVector>
+
+// 平坦瑞利/莱斯衰落: 输出随时间变化的复信道增益 h(n), 平均功率为1
+// 散射分量使用 Zheng & Xiao (2003) 的正弦波叠加模型 (SINUSOID_COUNT 个入射方向, 随机初相位),
+// 自相关函数逼近 Jakes 谱 J0(2*pi*fd*tau); 莱斯因子 K > 0 时再加上一个固定的直射分量.
+// 每个正弦分量在 TILE_SIZE 个样本内用 SimdKernels::accumulateTone 递推, 段起点由样本序号算出.
+// 入射角和初相位只取决于种子.
+class FadingChannel
+{
+public:
+    FadingChannel();
+
+    void setSamplingRate(double samplingRate);
+    double getSamplingRate() const;
+
+    // 最大多普勒频移 (Hz)
+    void setMaxDoppler(double frequency);
+    double getMaxDoppler() const;
+
+    // 莱斯因子: 直射分量与散射分量的功率比 (线性值), 0 为瑞利衰落
+    void setRicianFactor(double factor);
+    double getRicianFactor() const;
+
+    // 重新抽取入射角和初相位, 时间回到0
+    void setSeed(quint64 seed);
+    quint64 getSeed() const;
+
+    // 时间回到0
+    void reset();
+
+    // 输出下一段信道增益 h = gainRe + j * gainIm
+    void generate(double *gainRe, double *gainIm, int numSamples);
+
+    static const int SINUSOID_COUNT = 16;
+    static const int TILE_SIZE = 512;
+
+private:
+    void updateSinusoids();
+
+    double m_samplingRate;
+    double m_maxDoppler;
+    double m_ricianFactor;
+    quint64 m_seed;
+    qint64 m_sampleIndex;
+
+    // 同相 (实部) 和正交 (虚部) 支路各 SINUSOID_COUNT 个分量的整数相位 (2^64 对应一个周期) 与旋转因子
+    QVector<quint64> m_phaseOffsets;
+    QVector<quint64> m_phaseIncrements;
+    QVector<double> m_stepRe;
+    QVector<double> m_stepIm;
+    double m_lineOfSightPhase;  // 直射分量的相位 (弧度)
+};
+
+#endif // FADINGCHANNEL_H
@@ -0,0 +1,567 @@
+#include "fft.h"
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QtMath>
+#include <algorithm>
+
+// 单位根 e^(-j*2*pi*i/R) = cosine[i] - j*sine[i], 奇数基蝶形使用
+template <int R>
+struct RootsOfUnity {
+    double cosine[R];
+    double sine[R];
+
+    RootsOfUnity()
+    {
+        for (int i = 0; i < R; ++i) {
+            cosine[i] = std::cos(2.0 * M_PI * i / R);
+            sine[i] = std::sin(2.0 * M_PI * i / R);
+        }
+    }
+};
+
+static const RootsOfUnity<3> ROOTS3;
+static const RootsOfUnity<5> ROOTS5;
+static const RootsOfUnity<7> ROOTS7;
+
+// 奇素数基 R 的 DFT: 下标 p 和 R-p 配对, t_p = a_p + a_(R-p), d_p = a_p - a_(R-p),
+// X_q = a0 + sum(cos * t_p) -/+ j * sum(sin * d_p) 分别给出 X_q 和 X_(R-q)
+template <int R>
+static void oddButterfly(double *re, double *im, const RootsOfUnity<R> &roots)
+{
+    const int half = R / 2;
+    double sumRe[half + 1], sumIm[half + 1], diffRe[half + 1], diffIm[half + 1];
+    double dcRe = re[0];
+    double dcIm = im[0];
+    for (int p = 1; p <= half; ++p) {
+        sumRe[p] = re[p] + re[R - p];
+        sumIm[p] = im[p] + im[R - p];
+        diffRe[p] = re[p] - re[R - p];
+        diffIm[p] = im[p] - im[R - p];
+        dcRe += sumRe[p];
+        dcIm += sumIm[p];
+    }
+
+    const double a0re = re[0];
+    const double a0im = im[0];
+    for (int q = 1; q <= half; ++q) {
+        double mRe = a0re;
+        double mIm = a0im;
+        double nRe = 0.0;
+        double nIm = 0.0;
+        for (int p = 1; p <= half; ++p) {
+            const int index = (p * q) % R;
+            mRe += roots.cosine[index] * sumRe[p];
+            mIm += roots.cosine[index] * sumIm[p];
+            nRe += roots.sine[index] * diffRe[p];
+            nIm += roots.sine[index] * diffIm[p];
+        }
+        // X_q = m - j*n, X_(R-q) = m + j*n
+        re[q] = mRe + nIm;
+        im[q] = mIm - nRe;
+        re[R - q] = mRe - nIm;
+        im[R - q] = mIm + nRe;
+    }
+    re[0] = dcRe;
+    im[0] = dcIm;
+}
+
+// 混合基的一级: 每组 R*m 个数据依次是 R 个长度为 m 的子变换 A_p (自然顺序),
+// b_p = w^(p*k) * A_p[k], 输出 X[k + q*m] = sum(b_p * e^(-j*2*pi*p*q/R))
+template <int R>
+static void mixedStage(double *data, int begin, int end, int m, const double *twiddles)
+{
+    double re[R];
+    double im[R];
+    for (int group = begin; group < end; group += R * m) {
+        double *x = data + 2 * group;
+        const double *w = twiddles;
+        for (int k = 0; k < m; ++k, w += 2 * (R - 1)) {
+            re[0] = x[2 * k];
+            im[0] = x[2 * k + 1];
+            for (int p = 1; p < R; ++p) {
+                const double *a = x + 2 * (p * m + k);
+                const double wRe = w[2 * (p - 1)];
+                const double wIm = w[2 * (p - 1) + 1];
+                re[p] = a[0] * wRe - a[1] * wIm;
+                im[p] = a[0] * wIm + a[1] * wRe;
+            }
+
+            if constexpr (R == 2) {
+                const double re1 = re[1];
+                const double im1 = im[1];
+                re[1] = re[0] - re1;
+                im[1] = im[0] - im1;
+                re[0] += re1;
+                im[0] += im1;
+            } else if constexpr (R == 4) {
+                const double sum02re = re[0] + re[2];
+                const double sum02im = im[0] + im[2];
+                const double diff02re = re[0] - re[2];
+                const double diff02im = im[0] - im[2];
+                const double sum13re = re[1] + re[3];
+                const double sum13im = im[1] + im[3];
+                // -j * (b1 - b3)
+                const double rot13re = im[1] - im[3];
+                const double rot13im = re[3] - re[1];
+                re[0] = sum02re + sum13re;
+                im[0] = sum02im + sum13im;
+                re[1] = diff02re + rot13re;
+                im[1] = diff02im + rot13im;
+                re[2] = sum02re - sum13re;
+                im[2] = sum02im - sum13im;
+                re[3] = diff02re - rot13re;
+                im[3] = diff02im - rot13im;
+            } else if constexpr (R == 3) {
+                // X1 = m - j*n, X2 = m + j*n, m = a0 - (b1 + b2)/2, n = sin(2*pi/3) * (b1 - b2)
+                const double sumRe = re[1] + re[2];
+                const double sumIm = im[1] + im[2];
+                const double nRe = ROOTS3.sine[1] * (re[1] - re[2]);
+                const double nIm = ROOTS3.sine[1] * (im[1] - im[2]);
+                const double mRe = re[0] - 0.5 * sumRe;
+                const double mIm = im[0] - 0.5 * sumIm;
+                re[0] += sumRe;
+                im[0] += sumIm;
+                re[1] = mRe + nIm;
+                im[1] = mIm - nRe;
+                re[2] = mRe - nIm;
+                im[2] = mIm + nRe;
+            } else if constexpr (R == 5) {
+                oddButterfly<5>(re, im, ROOTS5);
+            } else {
+                oddButterfly<7>(re, im, ROOTS7);
+            }
+
+            for (int q = 0; q < R; ++q) {
+                double *y = x + 2 * (q * m + k);
+                y[0] = re[q];
+                y[1] = im[q];
+            }
+        }
+    }
+}
+
+// 按位反转/数字反转重排需要依次交换的下标对
+// 第 s 级 (基 r_s) 合并 r_s 个子变换, 输入下标 n 的最低位数字 (n mod r_last) 决定它属于最后一级的哪个子变换,
+// 依此类推, 重排后 x[n] 位于 pos(n). 沿每个置换环依次交换即可原地完成.
+static QVector<quint32> permutationSwaps(const QVector<int> &radices, int size)
+{
+    QVector<int> position(size);
+    for (int n = 0; n < size; ++n) {
+        int remaining = n;
+        int length = size;
+        int pos = 0;
+        for (int s = radices.size() - 1; s >= 0; --s) {
+            length /= radices[s];
+            pos += (remaining % radices[s]) * length;
+            remaining /= radices[s];
+        }
+        position[n] = pos;
+    }
+
+    // 走过的环把位置改为自身, 之后作为不动点跳过
+    QVector<quint32> swaps;
+    for (int start = 0; start < size; ++start) {
+        int j = position[start];
+        while (j != start) {
+            swaps.append(static_cast<quint32>(start));
+            swaps.append(static_cast<quint32>(j));
+            const int next = position[j];
+            position[j] = j;
+            j = next;
+        }
+        position[start] = start;
+    }
+    return swaps;
+}
+
+// 只含不大于 maxRadix 的素因子
+static bool isSmooth(int size, int maxRadix)
+{
+    for (int radix = 2; radix <= maxRadix; ++radix) {
+        while (size % radix == 0) {
+            size /= radix;
+        }
+    }
+    return size == 1;
+}
+
+// 在缓存中查找长度为 size 的计划并移到最后 (最近使用)
+static std::shared_ptr<const Fft> takeCachedPlan(QVector<std::shared_ptr<const Fft>> &cache, int size)
+{
+    for (int i = cache.size() - 1; i >= 0; --i) {
+        if (cache[i]->getSize() == size) {
+            std::shared_ptr<const Fft> plan = cache[i];
+            cache.remove(i);
+            cache.append(plan);
+            return plan;
+        }
+    }
+    return std::shared_ptr<const Fft>();
+}
+
+Fft::Fft(int size) :
+    m_size(size > 0 ? size : 1),
+    m_powerOfTwo(isPowerOfTwo(m_size)),
+    m_radix2First(false)
+{
+    if (m_powerOfTwo) {
+        int log2Size = 0;
+        while ((1 << log2Size) < m_size) {
+            ++log2Size;
+        }
+        m_radix2First = (log2Size & 1) != 0;
+
+        // 位反转重排
+        m_swaps = permutationSwaps(QVector<int>(log2Size, 2), m_size);
+
+        // 基4各级: 第一级的 m 为1 (或在基2之后为2), 每级乘4
+        for (int m = m_radix2First ? 2 : 1; 4 * m <= m_size; m *= 4) {
+            m_quarters.append(m);
+            m_twiddleOffsets.append(m_twiddles.size());
+            for (int k = 0; k < m; ++k) {
+                for (int p = 1; p <= 3; ++p) {
+                    const double angle = -2.0 * M_PI * p * k / (4.0 * m);
+                    m_twiddles.append(std::cos(angle));
+                    m_twiddles.append(std::sin(angle));
+                }
+            }
+        }
+        return;
+    }
+
+    // 分解为 4, 2, 3, 5, 7 的乘积
+    int remaining = m_size;
+    while (remaining % 4 == 0) {
+        m_radices.append(4);
+        remaining /= 4;
+    }
+    for (int radix = 2; radix <= MAX_RADIX; ++radix) {
+        if (radix == 4 || radix == 6) {
+            continue;
+        }
+        while (remaining % radix == 0) {
+            m_radices.append(radix);
+            remaining /= radix;
+        }
+    }
+
+    if (remaining == 1) {
+        m_swaps = permutationSwaps(m_radices, m_size);
+
+        int m = 1;
+        for (int radix : m_radices) {
+            m_spans.append(m);
+            m_twiddleOffsets.append(m_twiddles.size());
+            for (int k = 0; k < m; ++k) {
+                for (int p = 1; p < radix; ++p) {
+                    const double angle = -2.0 * M_PI * p * k / (static_cast<double>(radix) * m);
+                    m_twiddles.append(std::cos(angle));
+                    m_twiddles.append(std::sin(angle));
+                }
+            }
+            m *= radix;
+        }
+        return;
+    }
+
+    // Bluestein: 线性卷积长度为 2N-1, 循环卷积取不小于它的2的幂;
+    // 只含 2/3/5 因子的混合基每点的开销约为2的幂的1.5到1.8倍 (含7的更慢), 这样的长度明显更短时改用混合基
+    m_radices.clear();
+    const int minimumSize = 2 * m_size - 1;
+    int convolutionSize = 1;
+    while (convolutionSize < minimumSize) {
+        convolutionSize <<= 1;
+    }
+    int smoothSize = minimumSize;
+    while (!isSmooth(smoothSize, 5)) {
+        ++smoothSize;
+    }
+    if (3 * static_cast<qint64>(smoothSize) < 2 * static_cast<qint64>(convolutionSize)) {
+        convolutionSize = smoothSize;
+    }
+    m_convolution = plan(convolutionSize);
+
+    // n^2 对 2N 取模后再乘 pi/N, 避免 n 很大时角度失去精度
+    m_chirp.resize(2 * m_size);
+    for (int n = 0; n < m_size; ++n) {
+        const qint64 square = static_cast<qint64>(n) * n % (2 * static_cast<qint64>(m_size));
+        const double angle = -M_PI * static_cast<double>(square) / m_size;
+        m_chirp[2 * n] = std::cos(angle);
+        m_chirp[2 * n + 1] = std::sin(angle);
+    }
+
+    QVector<std::complex<double>> kernel(convolutionSize, std::complex<double>(0.0, 0.0));
+    for (int n = 0; n < m_size; ++n) {
+        const std::complex<double> value(m_chirp[2 * n], -m_chirp[2 * n + 1]);
+        kernel[n] = value;
+        if (n > 0) {
+            kernel[convolutionSize - n] = value;
+        }
+    }
+    m_convolution->forward(kernel.data());
+    m_chirpSpectrum.resize(2 * convolutionSize);
+    const double scale = 1.0 / convolutionSize;
+    for (int k = 0; k < convolutionSize; ++k) {
+        m_chirpSpectrum[2 * k] = kernel[k].real() * scale;
+        m_chirpSpectrum[2 * k + 1] = kernel[k].imag() * scale;
+    }
+}
+
+std::shared_ptr<const Fft> Fft::plan(int size)
+{
+    static QMutex mutex;
+    static QVector<std::shared_ptr<const Fft>> cache;   // 最近使用的在最后
+
+    {
+        QMutexLocker locker(&mutex);
+        std::shared_ptr<const Fft> cached = takeCachedPlan(cache, size);
+        if (cached) {
+            return cached;
+        }
+    }
+
+    // 在锁外构造: Bluestein 计划构造时还要取卷积长度的计划
+    std::shared_ptr<const Fft> plan = std::make_shared<const Fft>(size);
+
+    QMutexLocker locker(&mutex);
+    // 其他线程可能同时构造了相同长度的计划, 保留先放入缓存的那个
+    std::shared_ptr<const Fft> cached = takeCachedPlan(cache, size);
+    if (cached) {
+        return cached;
+    }
+    if (cache.size() >= PLAN_CACHE_SIZE) {
+        cache.removeFirst();
+    }
+    cache.append(plan);
+    return plan;
+}
+
+int Fft::getSize() const
+{
+    return m_size;
+}
+
+int Fft::getWorkspaceSize() const
+{
+    return m_convolution ? m_convolution->getSize() : 0;
+}
+
+bool Fft::isPowerOfTwo(int size)
+{
+    return size > 0 && (size & (size - 1)) == 0;
+}
+
+void Fft::forward(std::complex<double> *data, std::complex<double> *workspace) const
+{
+    QVector<std::complex<double>> buffer;
+    if (!workspace && getWorkspaceSize() > 0) {
+        buffer.resize(getWorkspaceSize());
+        workspace = buffer.data();
+    }
+
+    // std::complex<double> 与 double[2] 的内存布局相同, 蝶形直接在实部虚部上计算
+    transform(reinterpret_cast<double *>(data), reinterpret_cast<double *>(workspace));
+}
+
+void Fft::inverse(std::complex<double> *data, std::complex<double> *workspace) const
+{
+    QVector<std::complex<double>> buffer;
+    if (!workspace && getWorkspaceSize() > 0) {
+        buffer.resize(getWorkspaceSize());
+        workspace = buffer.data();
+    }
+
+    // IFFT(x) = conj(FFT(conj(x))) / N
+    double *values = reinterpret_cast<double *>(data);
+    for (int i = 0; i < m_size; ++i) {
+        values[2 * i + 1] = -values[2 * i + 1];
+    }
+    transform(values, reinterpret_cast<double *>(workspace));
+    const double scale = 1.0 / m_size;
+    for (int i = 0; i < m_size; ++i) {
+        values[2 * i] *= scale;
+        values[2 * i + 1] *= -scale;
+    }
+}
+
+void Fft::transform(double *data, double *workspace) const
+{
+    if (m_convolution) {
+        bluestein(data, workspace);
+        return;
+    }
+
+    permute(data);
+
+    if (!m_powerOfTwo) {
+        // 与2的幂相同, 蝶形跨度不超过 BLOCK_SIZE 的前几级逐块完成, 块长为这几级基的乘积
+        int blockSize = 1;
+        int stage = 0;
+        while (stage < m_radices.size() && blockSize * m_radices[stage] <= BLOCK_SIZE) {
+            blockSize *= m_radices[stage];
+            ++stage;
+        }
+        for (int begin = 0; begin < m_size; begin += blockSize) {
+            for (int s = 0; s < stage; ++s) {
+                mixedRadixStage(data, begin, begin + blockSize, s);
+            }
+        }
+        for (int s = stage; s < m_radices.size(); ++s) {
+            mixedRadixStage(data, 0, m_size, s);
+        }
+        return;
+    }
+
+    // 跨度不超过一块的各级逐块完成
+    const int blockSize = qMin(m_size, BLOCK_SIZE);
+    int stage = 0;
+    while (stage < m_quarters.size() && 4 * m_quarters[stage] <= blockSize) {
+        ++stage;
+    }
+    for (int begin = 0; begin < m_size; begin += blockSize) {
+        if (m_radix2First) {
+            radix2Stage(data, begin, begin + blockSize);
+        }
+        for (int s = 0; s < stage; ++s) {
+            radix4Stage(data, begin, begin + blockSize, s);
+        }
+    }
+
+    // 剩下的各级跨度大于一块, 整体逐级进行
+    for (int s = stage; s < m_quarters.size(); ++s) {
+        radix4Stage(data, 0, m_size, s);
+    }
+}
+
+void Fft::permute(double *data) const
+{
+    const quint32 *swaps = m_swaps.constData();
+    for (int i = 0; i < m_swaps.size(); i += 2) {
+        const quint32 a = 2 * swaps[i];
+        const quint32 b = 2 * swaps[i + 1];
+        std::swap(data[a], data[b]);
+        std::swap(data[a + 1], data[b + 1]);
+    }
+}
+
+void Fft::radix2Stage(double *data, int begin, int end) const
+{
+    for (int i = begin; i < end; i += 2) {
+        double *a = data + 2 * i;
+        const double re = a[2];
+        const double im = a[3];
+        a[2] = a[0] - re;
+        a[3] = a[1] - im;
+        a[0] += re;
+        a[1] += im;
+    }
+}
+
+// 位反转顺序下一组 4m 个数据依次是下标模4余 0, 2, 1, 3 的四个长度为 m 的子变换 A0, A2, A1, A3.
+// b_p = w^(p*k) * A_p[k], 输出 X[k + q*m] = sum(b_p * (-j)^(p*q))
+void Fft::radix4Stage(double *data, int begin, int end, int stage) const
+{
+    const int m = m_quarters[stage];
+    const double *twiddles = m_twiddles.constData() + m_twiddleOffsets[stage];
+
+    for (int group = begin; group < end; group += 4 * m) {
+        double *x0 = data + 2 * group;
+        double *x2 = x0 + 2 * m;
+        double *x1 = x2 + 2 * m;
+        double *x3 = x1 + 2 * m;
+        const double *w = twiddles;
+        for (int k = 0; k < m; ++k, w += 6) {
+            const double a0re = x0[2 * k];
+            const double a0im = x0[2 * k + 1];
+            const double a1re = x1[2 * k];
+            const double a1im = x1[2 * k + 1];
+            const double a2re = x2[2 * k];
+            const double a2im = x2[2 * k + 1];
+            const double a3re = x3[2 * k];
+            const double a3im = x3[2 * k + 1];
+
+            const double b1re = a1re * w[0] - a1im * w[1];
+            const double b1im = a1re * w[1] + a1im * w[0];
+            const double b2re = a2re * w[2] - a2im * w[3];
+            const double b2im = a2re * w[3] + a2im * w[2];
+            const double b3re = a3re * w[4] - a3im * w[5];
+            const double b3im = a3re * w[5] + a3im * w[4];
+
+            const double sum02re = a0re + b2re;
+            const double sum02im = a0im + b2im;
+            const double diff02re = a0re - b2re;
+            const double diff02im = a0im - b2im;
+            const double sum13re = b1re + b3re;
+            const double sum13im = b1im + b3im;
+            // -j * (b1 - b3)
+            const double rot13re = b1im - b3im;
+            const double rot13im = b3re - b1re;
+
+            x0[2 * k] = sum02re + sum13re;
+            x0[2 * k + 1] = sum02im + sum13im;
+            x2[2 * k] = diff02re + rot13re;
+            x2[2 * k + 1] = diff02im + rot13im;
+            x1[2 * k] = sum02re - sum13re;
+            x1[2 * k + 1] = sum02im - sum13im;
+            x3[2 * k] = diff02re - rot13re;
+            x3[2 * k + 1] = diff02im - rot13im;
+        }
+    }
+}
+
+void Fft::mixedRadixStage(double *data, int begin, int end, int stage) const
+{
+    const int m = m_spans[stage];
+    const double *twiddles = m_twiddles.constData() + m_twiddleOffsets[stage];
+    switch (m_radices[stage]) {
+    case 2:
+        mixedStage<2>(data, begin, end, m, twiddles);
+        break;
+    case 3:
+        mixedStage<3>(data, begin, end, m, twiddles);
+        break;
+    case 4:
+        mixedStage<4>(data, begin, end, m, twiddles);
+        break;
+    case 5:
+        mixedStage<5>(data, begin, end, m, twiddles);
+        break;
+    default:
+        mixedStage<7>(data, begin, end, m, twiddles);
+        break;
+    }
+}
+
+// y = x * c 补零到 M 点, Y = FFT(y) * FFT(conj(c)) / M, 再用 conj(FFT(conj(Y))) 完成逆变换, X = c * 卷积结果
+void Fft::bluestein(double *data, double *workspace) const
+{
+    const int convolutionSize = m_convolution->getSize();
+    const double *chirp = m_chirp.constData();
+    for (int n = 0; n < m_size; ++n) {
+        const double re = data[2 * n];
+        const double im = data[2 * n + 1];
+        workspace[2 * n] = re * chirp[2 * n] - im * chirp[2 * n + 1];
+        workspace[2 * n + 1] = re * chirp[2 * n + 1] + im * chirp[2 * n];
+    }
+    std::fill(workspace + 2 * m_size, workspace + 2 * convolutionSize, 0.0);
+
+    std::complex<double> *buffer = reinterpret_cast<std::complex<double> *>(workspace);
+    m_convolution->forward(buffer);
+
+    const double *spectrum = m_chirpSpectrum.constData();
+    for (int k = 0; k < convolutionSize; ++k) {
+        const double re = workspace[2 * k];
+        const double im = workspace[2 * k + 1];
+        workspace[2 * k] = re * spectrum[2 * k] - im * spectrum[2 * k + 1];
+        workspace[2 * k + 1] = -(re * spectrum[2 * k + 1] + im * spectrum[2 * k]);
+    }
+    m_convolution->forward(buffer);
+
+    for (int k = 0; k < m_size; ++k) {
+        const double re = workspace[2 * k];
+        const double im = -workspace[2 * k + 1];
+        data[2 * k] = re * chirp[2 * k] - im * chirp[2 * k + 1];
+        data[2 * k + 1] = re * chirp[2 * k + 1] + im * chirp[2 * k];
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef FFT_H
+#define FFT_H
+
+#include <QVector>
+#include <complex>
+#include <memory>
+
+// 原地复数FFT, 任意长度
+// 迭代实现: 先按位反转 (数字反转) 表重排, 再逐级做蝶形, 不需要补零, 频点间隔正好是 fs/N.
+//  - 长度为2的幂: 基4蝶形 (log2(N) 为奇数时先做一级基2), 跨度不超过 BLOCK_SIZE 的前几级按块完成
+//    (一块数据留在缓存中连续做完这几级), 之后的各级整体逐级进行.
+//  - 长度只含 2/3/5/7 因子: 混合基, 每级的基为 4/2/3/5/7 之一, 同样按块完成前几级.
+//  - 含有大于7的素因子: Bluestein 算法, 把变换写成与线性调频序列的卷积, 用长度 M >= 2N-1 的2的幂 (或只含
+//    2/3/5 因子) 的FFT计算, 需要 getWorkspaceSize() 个复数的工作区. 开销约为两次 M 点FFT.
+// 每一级的旋转因子在构造时直接由三角函数算好, 按蝶形的访问顺序连续存放, 变换过程中不调用三角函数;
+// 调用者提供工作区时不分配内存.
+// 计划只取决于长度, plan() 按长度缓存并在线程之间共享; 变换是 const 的, 可以并发调用.
+class Fft
+{
+public:
+    explicit Fft(int size);
+
+    // 长度为 size 的共享计划, 最近用过的 PLAN_CACHE_SIZE 个长度只构造一次 (线程安全)
+    static std::shared_ptr<const Fft> plan(int size);
+
+    int getSize() const;
+    // 变换需要的工作区 (复数个数), 只有 Bluestein 计划不为0
+    int getWorkspaceSize() const;
+
+    // X[k] = sum(x[n] * e^(-j*2*pi*k*n/N))
+    // workspace 为空且需要工作区时临时分配
+    void forward(std::complex<double> *data, std::complex<double> *workspace = nullptr) const;
+    // 逆变换, 包含 1/N 缩放: inverse(forward(x)) == x
+    void inverse(std::complex<double> *data, std::complex<double> *workspace = nullptr) const;
+
+    static bool isPowerOfTwo(int size);
+
+    // 按块完成的最大跨度 (复数个数), 2048 个复数为 32KB
+    static const int BLOCK_SIZE = 2048;
+    static const int PLAN_CACHE_SIZE = 16;
+    // 混合基支持的最大素因子, 含有更大素因子的长度使用 Bluestein 算法
+    static const int MAX_RADIX = 7;
+
+private:
+    void transform(double *data, double *workspace) const;
+    void permute(double *data) const;
+    void radix2Stage(double *data, int begin, int end) const;
+    void radix4Stage(double *data, int begin, int end, int stage) const;
+    void mixedRadixStage(double *data, int begin, int end, int stage) const;
+    void bluestein(double *data, double *workspace) const;
+
+    int m_size;
+    bool m_powerOfTwo;
+    bool m_radix2First;             // 2的幂: log2(N) 为奇数时先做一级基2
+    QVector<quint32> m_swaps;       // 位反转/数字反转重排依次交换的下标对
+    QVector<int> m_quarters;        // 2的幂: 每一级基4蝶形的四分之一跨度 m (蝶形跨度 4m)
+    QVector<int> m_radices;         // 混合基: 每一级的基 r, 蝶形跨度 r*m, m 为之前各级基的乘积
+    QVector<int> m_spans;           // 混合基: 每一级的 m
+    QVector<int> m_twiddleOffsets;  // 每一级旋转因子在 m_twiddles 中的起点
+    // 2的幂: 每一级依次存放 k = 0..m-1 的 (w^k, w^2k, w^3k) 实部虚部, w = e^(-j*2*pi/(4m))
+    // 混合基: 每一级依次存放 k = 0..m-1 的 w^(p*k), p = 1..r-1, w = e^(-j*2*pi/(r*m))
+    QVector<double> m_twiddles;
+
+    // Bluestein: X[k] = c[k] * sum(x[n] * c[n] * conj(c[k-n])), c[n] = e^(-j*pi*n^2/N)
+    std::shared_ptr<const Fft> m_convolution;   // 长度 M 的循环卷积FFT
+    QVector<double> m_chirp;                    // c[n], n = 0..N-1
+    QVector<double> m_chirpSpectrum;            // conj(c) 按循环卷积排列后的 M 点FFT, 已包含逆变换的 1/M
+};
+
+#endif // FFT_H
@@ -0,0 +1,174 @@
+#include "fftconvolver.h"
+
+#include <QtMath>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// y += x * h, 复数按实部虚部交错存放
+void multiplyAccumulate(const std::complex<double> *x, const std::complex<double> *h,
+                        std::complex<double> *y, int count)
+{
+    const double *a = reinterpret_cast<const double *>(x);
+    const double *b = reinterpret_cast<const double *>(h);
+    double *out = reinterpret_cast<double *>(y);
+    for (int i = 0; i < 2 * count; i += 2) {
+        out[i] += a[i] * b[i] - a[i + 1] * b[i + 1];
+        out[i + 1] += a[i] * b[i + 1] + a[i + 1] * b[i];
+    }
+}
+
+// 开销估计的相对单位: 直接卷积一个抽头乘加 (向量内核) 为1
+const double FFT_COST_PER_POINT = 2.0;      // 2B 点实数FFT 约 FFT_COST_PER_POINT * 2B * log2(2B)
+const double MAC_COST_PER_BIN = 5.0;        // 一个频点的复数乘加
+
+double fftCost(int partitionSize)
+{
+    const int size = 2 * partitionSize;
+    return FFT_COST_PER_POINT * size * std::log2(static_cast<double>(size));
+}
+
+} // namespace
+
+FftConvolver::FftConvolver() :
+    m_partitionSize(0),
+    m_partitions(0),
+    m_bins(0),
+    m_current(0),
+    m_fill(0)
+{
+}
+
+void FftConvolver::setTaps(const QVector<double> &taps, int partitionSize)
+{
+    m_partitionSize = qMax(partitionSize, 1);
+    m_partitions = qMax((taps.size() + m_partitionSize - 1) / m_partitionSize, 1);
+    m_bins = m_partitionSize + 1;
+    m_fft = RealFft::plan(2 * m_partitionSize);
+    m_workspace.resize(m_fft->getWorkspaceSize());
+
+    // 每块抽头放在 2B 点窗口的前 B 点, 后面补零
+    m_filterSpectra.resize(m_partitions * m_bins);
+    m_window.fill(0.0, 2 * m_partitionSize);
+    for (int p = 0; p < m_partitions; ++p) {
+        const int begin = p * m_partitionSize;
+        const int count = qMin(m_partitionSize, taps.size() - begin);
+        if (count > 0) {
+            std::memcpy(m_window.data(), taps.constData() + begin, sizeof(double) * count);
+        }
+        std::fill(m_window.begin() + qMax(count, 0), m_window.end(), 0.0);
+        m_fft->forward(m_window.constData(), m_filterSpectra.data() + p * m_bins, m_workspace.data());
+    }
+
+    m_accumulator.resize(m_bins);
+    m_spectrum.resize(m_bins);
+    m_output.resize(2 * m_partitionSize);
+    prime(nullptr, 0);
+}
+
+int FftConvolver::getPartitionSize() const
+{
+    return m_partitionSize;
+}
+
+void FftConvolver::prime(const double *history, int length)
+{
+    m_inputSpectra.fill(std::complex<double>(), m_partitions * m_bins);
+    m_current = 0;
+    m_fill = 0;
+
+    // 当前段从相对位置0开始, 第 k-p 段的窗口覆盖 [-(p + 1) * B, -(p - 1) * B)
+    const int size = m_partitionSize;
+    for (int p = m_partitions - 1; p >= 0; --p) {
+        const int begin = -(p + 1) * size;
+        for (int n = 0; n < 2 * size; ++n) {
+            const int index = length + begin + n;
+            m_window[n] = index >= 0 && index < length ? history[index] : 0.0;
+        }
+        if (p > 0) {
+            m_fft->forward(m_window.constData(), spectrumAt(p), m_workspace.data());
+        }
+    }
+    accumulateHistory();
+}
+
+void FftConvolver::process(const double *input, double *output, int numSamples)
+{
+    const int size = m_partitionSize;
+    while (numSamples > 0) {
+        const int count = qMin(numSamples, size - m_fill);
+        std::memcpy(m_window.data() + size + m_fill, input, sizeof(double) * count);
+        filterSegment();
+        std::memcpy(output, m_output.constData() + size + m_fill, sizeof(double) * count);
+
+        m_fill += count;
+        input += count;
+        output += count;
+        numSamples -= count;
+
+        if (m_fill == size) {
+            // 当前段完整, 其频谱已在延迟线中; 窗口前移一段
+            double *window = m_window.data();
+            std::memcpy(window, window + size, sizeof(double) * size);
+            std::fill(window + size, window + 2 * size, 0.0);
+            m_fill = 0;
+            m_current = (m_current + 1) % m_partitions;
+            accumulateHistory();
+        }
+    }
+}
+
+int FftConvolver::partitionSizeFor(int numTaps, int blockSize)
+{
+    if (numTaps <= 1 || blockSize <= 0) {
+        return 0;
+    }
+
+    // 一块 N 个样本: 直接卷积 N * L; 分块卷积每送入一次至少做一次 FFT/逆FFT 和 p = 0 的乘加,
+    // 每经过一段整体边界再做一次, 进入新的一段时累加 p >= 1 的 P - 1 段
+    const double samples = blockSize;
+    double bestCost = samples * numTaps;
+    int best = 0;
+    for (int size = MIN_PARTITION_SIZE; size <= MAX_PARTITION_SIZE; size *= 2) {
+        const int partitions = (numTaps + size - 1) / size;
+        const double segments = samples / size;
+        const double transforms = std::floor(segments) + 1.0;
+        const double cost = transforms * (2.0 * fftCost(size) + MAC_COST_PER_BIN * (size + 1))
+                + segments * (partitions - 1) * MAC_COST_PER_BIN * (size + 1);
+        if (cost < bestCost) {
+            bestCost = cost;
+            best = size;
+        }
+        if (size >= numTaps) {
+            break;
+        }
+    }
+    return best;
+}
+
+void FftConvolver::filterSegment()
+{
+    std::complex<double> *current = spectrumAt(0);
+    m_fft->forward(m_window.constData(), current, m_workspace.data());
+
+    std::memcpy(static_cast<void *>(m_spectrum.data()), m_accumulator.constData(),
+                sizeof(std::complex<double>) * m_bins);
+    multiplyAccumulate(current, m_filterSpectra.constData(), m_spectrum.data(), m_bins);
+    m_fft->inverse(m_spectrum.constData(), m_output.data(), m_workspace.data());
+}
+
+void FftConvolver::accumulateHistory()
+{
+    m_accumulator.fill(std::complex<double>());
+    for (int p = 1; p < m_partitions; ++p) {
+        multiplyAccumulate(spectrumAt(p), m_filterSpectra.constData() + p * m_bins,
+                           m_accumulator.data(), m_bins);
+    }
+}
+
+std::complex<double> *FftConvolver::spectrumAt(int delay)
+{
+    const int slot = (m_current - delay + m_partitions) % m_partitions;
+    return m_inputSpectra.data() + slot * m_bins;
+}
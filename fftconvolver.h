@@ -0,0 +1,62 @@
+#ifndef FFTCONVOLVER_H
+#define FFTCONVOLVER_H
+
+#include <QVector>
+#include <complex>
+#include <memory>
+
+#include "realfft.h"
+
+// 均匀分块 overlap-save 快速卷积: y[n] = sum(h[k] * x[n - k])
+// 抽头按 B 个一段分成 P 块, 每块补零后做 2B 点实数FFT (构造时算好). 输入同样按 B 个样本一段,
+// 每段与前一段拼成 2B 点窗口做FFT, 频谱存入 P 段的频域延迟线; 当前段的输出为
+//   Y_k = sum(X_{k-p} * H_p), p = 0..P-1
+// 逆变换后取后 B 点 (前 B 点受循环卷积混叠). 其中 p >= 1 的部分只与已经完整的段有关, 在进入新的一段时累加一次,
+// 之后每次送入数据只需一次FFT, 一次复数乘加和一次逆FFT.
+// 一段未满时窗口后部补零, 已有样本的输出仍是精确的, 因此输出没有额外延迟, 数据可以按任意长度分块送入;
+// 段内剩余样本到来时重新变换这一段, 分块越小这部分开销越大.
+class FftConvolver
+{
+public:
+    FftConvolver();
+
+    // 设置抽头 (h[0] 乘当前样本) 和分段长度 B (2的幂), 状态清零
+    void setTaps(const QVector<double> &taps, int partitionSize);
+    int getPartitionSize() const;
+
+    // 以 history (length 个样本, 最早的在前) 作为之前的输入重建状态, 更早的样本视为0;
+    // 下一个送入的样本是新一段的开始
+    void prime(const double *history, int length);
+
+    // output 可以与 input 相同
+    void process(const double *input, double *output, int numSamples);
+
+    // 每次送入 blockSize 个样本时, 按估计开销选择分段长度; 直接卷积更快时返回0
+    static int partitionSizeFor(int numTaps, int blockSize);
+
+    static const int MIN_PARTITION_SIZE = 32;
+    static const int MAX_PARTITION_SIZE = 8192;
+
+private:
+    // 当前窗口做FFT存入延迟线, 加上 p = 0 的部分后逆变换到 m_output
+    void filterSegment();
+    // 进入新的一段: 累加 p >= 1 的部分
+    void accumulateHistory();
+    std::complex<double> *spectrumAt(int delay);
+
+    int m_partitionSize;                    // B
+    int m_partitions;                       // P
+    int m_bins;                             // B + 1
+    std::shared_ptr<const RealFft> m_fft;   // 2B 点
+    QVector<std::complex<double>> m_filterSpectra;  // H_p, 依次存放
+    QVector<std::complex<double>> m_inputSpectra;   // 频域延迟线, P 段循环使用
+    int m_current;                          // 当前段在延迟线中的位置
+    QVector<std::complex<double>> m_accumulator;    // sum(X_{k-p} * H_p), p >= 1
+    QVector<std::complex<double>> m_spectrum;       // 当前段的输出频谱
+    QVector<double> m_window;               // [前一段 | 当前段 (未满部分为0)]
+    int m_fill;                             // 当前段已有的样本数
+    QVector<double> m_output;               // 2B 点逆变换结果
+    QVector<std::complex<double>> m_workspace;
+};
+
+#endif // FFTCONVOLVER_H
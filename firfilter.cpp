@@ -0,0 +1,146 @@
+#include "firfilter.h"
+
+#include "simdkernels.h"
+
+#include <QtMath>
+#include <algorithm>
+#include <cstring>
+
+FirFilter::FirFilter() :
+    m_reversedTaps(1, 1.0),
+    m_blockSize(0),
+    m_partitionSize(0),
+    m_convolverTaps(false),
+    m_convolverSynced(false)
+{
+}
+
+void FirFilter::setTaps(const QVector<double> &taps)
+{
+    const int oldHistory = m_buffer.size();
+    m_reversedTaps = taps.isEmpty() ? QVector<double>(1, 1.0) : taps;
+    std::reverse(m_reversedTaps.begin(), m_reversedTaps.end());
+
+    // 历史长度变为 length - 1: 增加时在前面补0, 减少时丢弃最早的样本
+    const int history = m_reversedTaps.size() - 1;
+    if (history > oldHistory) {
+        m_buffer.insert(0, history - oldHistory, 0.0);
+    } else if (history < oldHistory) {
+        m_buffer.remove(0, oldHistory - history);
+    }
+
+    // 抽头数变化后重新选择卷积方式, 频域状态在下一块由历史样本重建
+    m_blockSize = 0;
+    m_convolverTaps = false;
+    m_convolverSynced = false;
+}
+
+QVector<double> FirFilter::getTaps() const
+{
+    QVector<double> taps = m_reversedTaps;
+    std::reverse(taps.begin(), taps.end());
+    return taps;
+}
+
+int FirFilter::getLength() const
+{
+    return m_reversedTaps.size();
+}
+
+void FirFilter::reset()
+{
+    m_buffer.fill(0.0, m_reversedTaps.size() - 1);
+    m_convolverSynced = false;
+}
+
+void FirFilter::saveState(QVector<double> &state) const
+{
+    state.resize(m_buffer.size());
+    std::memcpy(state.data(), m_buffer.constData(), sizeof(double) * m_buffer.size());
+}
+
+void FirFilter::restoreState(const QVector<double> &state)
+{
+    if (state.size() != m_reversedTaps.size() - 1) {
+        reset();
+        return;
+    }
+    m_buffer.resize(state.size());
+    std::memcpy(m_buffer.data(), state.constData(), sizeof(double) * state.size());
+    // 快速卷积的状态在下一次处理时由历史样本重建
+    m_convolverSynced = false;
+}
+
+void FirFilter::process(const double *input, double *output, int numSamples)
+{
+    if (numSamples <= 0) {
+        return;
+    }
+
+    // 当前块接在历史样本之后, 第 i 个输出用到 buffer[i .. i + length - 1]
+    const int history = m_reversedTaps.size() - 1;
+    m_buffer.resize(history + numSamples);
+    double *buffer = m_buffer.data();
+    std::memcpy(buffer + history, input, sizeof(double) * numSamples);
+
+    if (numSamples != m_blockSize) {
+        m_blockSize = numSamples;
+        const int partitionSize = FftConvolver::partitionSizeFor(m_reversedTaps.size(), numSamples);
+        if (partitionSize != m_partitionSize) {
+            m_partitionSize = partitionSize;
+            m_convolverTaps = false;
+            m_convolverSynced = false;
+        }
+    }
+
+    if (m_partitionSize > 0) {
+        if (!m_convolverTaps) {
+            m_convolver.setTaps(getTaps(), m_partitionSize);
+            m_convolverTaps = true;
+            m_convolverSynced = false;
+        }
+        if (!m_convolverSynced) {
+            m_convolver.prime(buffer, history);
+            m_convolverSynced = true;
+        }
+        m_convolver.process(buffer + history, output, numSamples);
+    } else {
+        for (int start = 0; start < numSamples; start += TILE_SIZE) {
+            const int count = qMin(TILE_SIZE, numSamples - start);
+            SimdKernels::convolve(buffer + start, m_reversedTaps.constData(), m_reversedTaps.size(),
+                                  output + start, count);
+        }
+        m_convolverSynced = false;
+    }
+
+    // 保留最后 length - 1 个样本作为下一块的历史
+    std::memmove(buffer, buffer + numSamples, sizeof(double) * history);
+    m_buffer.resize(history);
+}
+
+QVector<double> FirFilter::lowPassTaps(double cutoffFrequency, double samplingRate, int numTaps,
+                                       const QVector<double> &window)
+{
+    const int length = qMax(numTaps, 1) | 1;
+    const QVector<double> weights = window.size() == length
+            ? window : WindowFunction::generate(WindowFunction::Blackman, length);
+
+    // h[n] = 2 * fc * sinc(2 * fc * (n - M)), fc 为归一化截止频率, M 为中心
+    const double fc = qBound(0.0, cutoffFrequency / samplingRate, 0.5);
+    const int center = length / 2;
+    QVector<double> taps(length);
+    double sum = 0.0;
+    for (int n = 0; n < length; ++n) {
+        const int k = n - center;
+        const double ideal = k == 0 ? 2.0 * fc : std::sin(2.0 * M_PI * fc * k) / (M_PI * k);
+        taps[n] = ideal * weights[n];
+        sum += taps[n];
+    }
+
+    if (sum != 0.0) {
+        for (double &tap : taps) {
+            tap /= sum;
+        }
+    }
+    return taps;
+}
@@ -0,0 +1,54 @@
+#ifndef FIRFILTER_H
+#define FIRFILTER_H
+
+#include <QVector>
+
+#include "fftconvolver.h"
+#include "windowfunction.h"
+
+// 流式FIR滤波器: y[n] = sum(h[k] * x[n - k])
+// 内部保存最近 length - 1 个输入样本, 数据可以按任意长度分块连续送入, 结果与一次性处理整段数据相同.
+// 每块根据抽头数和块长估计开销, 在两种卷积之间自动选择:
+//  - 直接卷积: 向量内核 (SimdKernels::convolve), 每块按 TILE_SIZE 个输出分段, 适合短滤波器
+//  - 快速卷积: 均匀分块 overlap-save (FftConvolver), 长滤波器每个样本的开销约为 O(log B + L/B) 而不是 O(L)
+// 两者结果相同 (相差舍入误差), 都没有额外延迟. 历史样本始终按直接卷积的方式保存,
+// 快速卷积的频域状态在需要时由历史样本重建, 因此可以随时切换.
+// 更换抽头 (例如改变截止频率) 时保留历史样本, 输出连续, 不需要重新填充延迟线.
+class FirFilter
+{
+public:
+    FirFilter();
+
+    // 设置抽头, h[0] 乘当前样本; 历史样本保留 (长度增加时更早的样本视为0)
+    void setTaps(const QVector<double> &taps);
+    QVector<double> getTaps() const;
+    int getLength() const;
+
+    // 清空历史 (之前的输入视为0)
+    void reset();
+    // 状态快照 (与当前设计对应), 写入 state 时复用它的内存; 恢复时长度不符 (设计已改变) 则清空状态
+    void saveState(QVector<double> &state) const;
+    void restoreState(const QVector<double> &state);
+
+    // output 可以与 input 相同
+    void process(const double *input, double *output, int numSamples);
+
+    // 窗函数法低通设计: 理想低通 (sinc) 截断到 numTaps 点 (取奇数, 线性相位, 群延迟 (numTaps-1)/2)
+    // 再乘窗, 直流增益归一化为1. window 为空时使用 Blackman 窗
+    static QVector<double> lowPassTaps(double cutoffFrequency, double samplingRate, int numTaps,
+                                       const QVector<double> &window = QVector<double>());
+
+    static const int TILE_SIZE = 1024;
+
+private:
+    QVector<double> m_reversedTaps;     // 按时间倒序, 与 SimdKernels::convolve 的约定一致
+    QVector<double> m_buffer;           // [最近 length - 1 个历史样本 | 当前块]
+
+    FftConvolver m_convolver;
+    int m_blockSize;                    // 上一块的长度, 块长不变时沿用上次的选择
+    int m_partitionSize;                // 快速卷积的分段长度, 0 表示直接卷积
+    bool m_convolverTaps;               // m_convolver 已载入当前抽头和分段长度
+    bool m_convolverSynced;             // m_convolver 的状态与历史样本一致
+};
+
+#endif // FIRFILTER_H
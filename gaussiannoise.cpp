@@ -0,0 +1,216 @@
+#include "gaussiannoise.h"
+#include "philox.h"
+
+#include <QRandomGenerator>
+#include <cmath>
+#include <cstring>
+
+// 256 层 Ziggurat 的底层 (含尾部) 右边界和每层面积 (Marsaglia & Tsang, 2000)
+static const double ZIGGURAT_R = 3.6541528853610088;
+static const double ZIGGURAT_VOLUME = 0.00492867323399;
+static const int ZIGGURAT_LAYERS = 256;
+static const double TWO_POW_52 = 4503599627370496.0;
+
+// 每次调用向量内核生成的样本数 (GAUSSIAN_BLOCK 的倍数), 决定未接受样本下标缓冲区的大小
+static const int VECTOR_CHUNK = 1024;
+
+// 第0层为底层矩形加尾部, 第1层在最上面, 层号越大越靠近底层.
+// 第 i 层 (i >= 1) 覆盖 x ∈ [0, edge[i]), 其中 x < edge[i-1] 的部分完全在密度曲线之下;
+// 第0层覆盖 [0, V / f(R)), x < R 的部分为底层矩形, 其余对应尾部
+struct ZigguratTables {
+    double layerAccept[ZIGGURAT_LAYERS];    // 快速接受边界: 候选点绝对值小于它即接受
+    double layerWidth[ZIGGURAT_LAYERS];     // 层宽度 / 2^52
+    double layerEdge[ZIGGURAT_LAYERS];      // 层右边界 x_i, edge[0] = 0 为顶点
+    double layerDensity[ZIGGURAT_LAYERS];   // exp(-x_i^2 / 2)
+};
+
+static ZigguratTables buildZigguratTables()
+{
+    ZigguratTables tables;
+    double edge = ZIGGURAT_R;
+    const double baseWidth = ZIGGURAT_VOLUME / std::exp(-0.5 * edge * edge);
+
+    tables.layerAccept[0] = edge;
+    tables.layerAccept[1] = 0.0;
+    tables.layerWidth[0] = baseWidth / TWO_POW_52;
+    tables.layerWidth[ZIGGURAT_LAYERS - 1] = edge / TWO_POW_52;
+    tables.layerEdge[0] = 0.0;
+    tables.layerEdge[ZIGGURAT_LAYERS - 1] = edge;
+    tables.layerDensity[0] = 1.0;
+    tables.layerDensity[ZIGGURAT_LAYERS - 1] = std::exp(-0.5 * edge * edge);
+
+    for (int i = ZIGGURAT_LAYERS - 2; i >= 1; --i) {
+        edge = std::sqrt(-2.0 * std::log(ZIGGURAT_VOLUME / edge + std::exp(-0.5 * edge * edge)));
+        tables.layerAccept[i + 1] = edge;
+        tables.layerWidth[i] = edge / TWO_POW_52;
+        tables.layerEdge[i] = edge;
+        tables.layerDensity[i] = std::exp(-0.5 * edge * edge);
+    }
+    return tables;
+}
+
+static const ZigguratTables &zigguratTables()
+{
+    static const ZigguratTables tables = buildZigguratTables();
+    return tables;
+}
+
+GaussianNoise::GaussianNoise()
+{
+    setSeed(QRandomGenerator::global()->generate64());
+}
+
+GaussianNoise::GaussianNoise(quint64 seed)
+{
+    setSeed(seed);
+}
+
+void GaussianNoise::setSeed(quint64 seed)
+{
+    m_key[0] = static_cast<quint32>(seed);
+    m_key[1] = static_cast<quint32>(seed >> 32);
+    m_position = 0;
+}
+
+quint64 GaussianNoise::getSeed() const
+{
+    return m_key[0] | (static_cast<quint64>(m_key[1]) << 32);
+}
+
+void GaussianNoise::setPosition(quint64 position)
+{
+    m_position = position;
+}
+
+quint64 GaussianNoise::getPosition() const
+{
+    return m_position;
+}
+
+void GaussianNoise::generate(double *output, int numSamples)
+{
+    generateAt(m_position, output, numSamples);
+    m_position += numSamples;
+}
+
+double GaussianNoise::next()
+{
+    return sampleAt(m_position++);
+}
+
+void GaussianNoise::generateAt(quint64 position, double *output, int numSamples) const
+{
+    const ZigguratTables &tables = zigguratTables();
+    const int block = SimdKernels::GAUSSIAN_BLOCK;
+
+    // 向量内核按整组生成, 组边界之前和之后的零散样本逐个计算
+    int head = static_cast<int>((block - position % block) % block);
+    head = qMin(head, numSamples);
+    for (int i = 0; i < head; ++i) {
+        output[i] = sampleAt(position + i);
+    }
+
+    const int vectorEnd = head + (numSamples - head) / block * block;
+    int rejected[VECTOR_CHUNK];
+    for (int start = head; start < vectorEnd; start += VECTOR_CHUNK) {
+        const int count = qMin(VECTOR_CHUNK, vectorEnd - start);
+        double *chunk = output + start;
+        const int rejectedCount = SimdKernels::gaussianCandidates(m_key, (position + start) / block,
+                                                                  tables.layerAccept, tables.layerWidth,
+                                                                  chunk, count, rejected);
+
+        // 快速路径未接受的样本: NaN 载荷中带有层号和符号
+        for (int k = 0; k < rejectedCount; ++k) {
+            const int i = rejected[k];
+            quint64 bits;
+            std::memcpy(&bits, &chunk[i], sizeof(bits));
+            chunk[i] = sampleRejected(position + start + i, static_cast<int>(bits & 0xff), (bits & 0x100) != 0);
+        }
+    }
+
+    for (int i = vectorEnd; i < numSamples; ++i) {
+        output[i] = sampleAt(position + i);
+    }
+}
+
+// 与向量内核的计数器分配方式相同: 第 b 组使用计数器 b * GAUSSIAN_LANES + l,
+// 低64位给组内第 l 个样本, 高64位给第 GAUSSIAN_LANES + l 个样本
+double GaussianNoise::sampleAt(quint64 position) const
+{
+    const ZigguratTables &tables = zigguratTables();
+    const int lanes = SimdKernels::GAUSSIAN_LANES;
+    const int offset = static_cast<int>(position % SimdKernels::GAUSSIAN_BLOCK);
+    const quint64 counter = position / SimdKernels::GAUSSIAN_BLOCK * lanes + offset % lanes;
+
+    quint32 words[4] = { static_cast<quint32>(counter), static_cast<quint32>(counter >> 32), 0, 0 };
+    Philox::generate(m_key, words);
+    const int half = offset / lanes;
+    const quint64 r = words[2 * half] | (static_cast<quint64>(words[2 * half + 1]) << 32);
+
+    const int layer = static_cast<int>(r & 0xff);
+    const double x = static_cast<double>(r >> 12) * tables.layerWidth[layer];
+    if (x < tables.layerAccept[layer]) {
+        return (r & 0x100) ? -x : x;
+    }
+    return sampleRejected(position, layer, (r & 0x100) != 0);
+}
+
+// 候选点已落在 layer 层的快速接受区之外. 在该条件下候选点在层内剩余区间上均匀分布,
+// 因此这里重新抽取位置再做楔形区 (或尾部) 的判断, 与沿用原候选点的分布完全相同.
+// 所需的随机数来自计数器 (样本位置, 抽取次数, 1), 与快速路径的计数器 (..., 0, 0) 不会重叠.
+double GaussianNoise::sampleRejected(quint64 position, int layer, bool negative) const
+{
+    const ZigguratTables &tables = zigguratTables();
+
+    quint32 draw = 0;
+    quint32 words[4];
+    int used = 4;
+    auto nextBits = [&]() -> quint64 {
+        if (used == 4) {
+            words[0] = static_cast<quint32>(position);
+            words[1] = static_cast<quint32>(position >> 32);
+            words[2] = draw++;
+            words[3] = 1;
+            Philox::generate(m_key, words);
+            used = 0;
+        }
+        const quint64 bits = words[used] | (static_cast<quint64>(words[used + 1]) << 32);
+        used += 2;
+        return bits;
+    };
+    // [0, 1) 均匀分布
+    auto nextUniform = [&]() -> double {
+        return (nextBits() >> 11) * (1.0 / 9007199254740992.0);
+    };
+
+    for (;;) {
+        if (layer == 0) {
+            // 尾部 |x| > R (Marsaglia 方法)
+            double x;
+            double y;
+            do {
+                x = -std::log1p(-nextUniform()) / ZIGGURAT_R;
+                y = -std::log1p(-nextUniform());
+            } while (y + y < x * x);
+            return negative ? -(ZIGGURAT_R + x) : ZIGGURAT_R + x;
+        }
+
+        // 楔形区: x ∈ [edge[layer-1], edge[layer]), 纵坐标落在密度曲线之下即接受
+        const double inner = tables.layerEdge[layer - 1];
+        const double x = inner + nextUniform() * (tables.layerEdge[layer] - inner);
+        const double y = tables.layerDensity[layer]
+                         + nextUniform() * (tables.layerDensity[layer - 1] - tables.layerDensity[layer]);
+        if (y < std::exp(-0.5 * x * x)) {
+            return negative ? -x : x;
+        }
+
+        // 拒绝, 重新抽取一个完整的候选点
+        const quint64 r = nextBits();
+        layer = static_cast<int>(r & 0xff);
+        negative = (r & 0x100) != 0;
+        const double candidate = static_cast<double>(r >> 12) * tables.layerWidth[layer];
+        if (candidate < tables.layerAccept[layer]) {
+            return negative ? -candidate : candidate;
+        }
+    }
+}
@@ -0,0 +1,43 @@
+#ifndef GAUSSIANNOISE_H
+#define GAUSSIANNOISE_H
+
+#include "simdkernels.h"
+
+#include <QtGlobal>
+
+// 高斯白噪声发生器, 输出标准正态分布 N(0, 1) 样本
+// 256 层 Ziggurat 算法, 均匀随机数来自计数器型发生器 Philox4x32-10 (种子即密钥).
+// 序列中第 n 个样本只取决于种子和 n: generateAt() 可以从任意位置开始生成, 各线程分段生成后拼接
+// 与单线程顺序生成逐位一致; 记录种子和位置即可精确重放一次仿真.
+// 约99%的样本只需一次查表和一次乘法, 这部分由 SimdKernels::gaussianCandidates 向量化生成,
+// 其余样本走精确的慢速路径.
+class GaussianNoise
+{
+public:
+    GaussianNoise();                        // 随机种子
+    explicit GaussianNoise(quint64 seed);
+
+    // 设置种子并把位置复位到序列开头
+    void setSeed(quint64 seed);
+    quint64 getSeed() const;
+
+    // 下一次 generate() / next() 输出的样本在序列中的位置
+    void setPosition(quint64 position);
+    quint64 getPosition() const;
+
+    // 从当前位置生成 numSamples 个样本, 位置随之前进
+    void generate(double *output, int numSamples);
+    double next();
+
+    // 生成序列中 [position, position + numSamples) 的样本, 不改变当前位置, 可以在多个线程中同时调用
+    void generateAt(quint64 position, double *output, int numSamples) const;
+    double sampleAt(quint64 position) const;
+
+private:
+    double sampleRejected(quint64 position, int layer, bool negative) const;
+
+    quint32 m_key[2];
+    quint64 m_position;
+};
+
+#endif // GAUSSIANNOISE_H
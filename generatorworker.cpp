@@ -0,0 +1,77 @@
+#include "generatorworker.h"
+#include "signalgenerator.h"
+
+#include <QElapsedTimer>
+
+GeneratorWorker::GeneratorWorker(SignalGenerator *generator, QObject *parent) : QThread(parent),
+    m_generator(generator),
+    m_freeBlocks(POOL_SIZE),
+    m_pool(POOL_SIZE),
+    m_pool16(POOL_SIZE)
+{
+}
+
+GeneratorWorker::~GeneratorWorker()
+{
+    requestInterruption();
+    wait();
+}
+
+void GeneratorWorker::takeBlock(int slot, QVector<double> &block)
+{
+    m_pool[slot].swap(block);
+}
+
+void GeneratorWorker::takeBlock16(int slot, QVector<qint16> &block)
+{
+    m_pool16[slot].swap(block);
+}
+
+void GeneratorWorker::releaseBlock()
+{
+    m_freeBlocks.release();
+}
+
+void GeneratorWorker::run()
+{
+    const bool int16Samples = m_generator->getSampleFormat() == INT16_SAMPLES;
+    int slot = 0;
+
+    QElapsedTimer timer;
+    timer.start();
+    double dueTimeUs = 0.0; // 已输出样本对应的时间
+
+    while (!isInterruptionRequested()) {
+        // 消费端跟不上时等待, 避免排队的块无限增长
+        if (!m_freeBlocks.tryAcquire(1, 10)) {
+            continue;
+        }
+
+        int blockSize = m_generator->getBlockSize();
+        int samplingRate = static_cast<int>(m_generator->getSamplingRate());
+
+        // 槽里是消费端换出的旧缓冲区, 没有其他引用时 resize() 和 data() 不会重新分配内存
+        if (int16Samples) {
+            QVector<qint16> &block = m_pool16[slot];
+            block.resize(blockSize);
+            m_generator->generateBlock16(block.data(), blockSize);
+            emit blockReady16(slot);
+        } else {
+            QVector<double> &block = m_pool[slot];
+            block.resize(blockSize);
+            m_generator->generateBlock(block.data(), blockSize);
+            emit blockReady(slot);
+        }
+        slot = (slot + 1) % POOL_SIZE;
+
+        // 按采样率节拍输出
+        dueTimeUs += blockSize * 1.0e6 / samplingRate;
+        qint64 waitUs = static_cast<qint64>(dueTimeUs) - timer.nsecsElapsed() / 1000;
+        if (waitUs > 0) {
+            usleep(static_cast<unsigned long>(waitUs));
+        } else if (waitUs < -1000000) {
+            // 落后超过1秒时重新对齐, 不再突发追赶
+            dueTimeUs = timer.nsecsElapsed() / 1000.0;
+        }
+    }
+}
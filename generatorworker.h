@@ -0,0 +1,48 @@
+#ifndef GENERATORWORKER_H
+#define GENERATORWORKER_H
+
+#include <QThread>
+#include <QVector>
+#include <QSemaphore>
+
+class SignalGenerator;
+
+// 连续流模式的工作线程
+// 按采样率节拍循环生成固定大小的数据块, 使用固定数量的缓冲区轮转.
+// 块通过 blockReady(slot) 通知消费端, 消费端用 takeBlock() 把块交换到自己的缓冲区,
+// 换出的旧缓冲区留在该槽, releaseBlock() 之后由工作线程复用. 只要下游不保留对旧缓冲区的引用,
+// 复用时就不会重新分配内存, 长时间运行时内存占用保持不变
+class GeneratorWorker : public QThread
+{
+    Q_OBJECT
+public:
+    explicit GeneratorWorker(SignalGenerator *generator, QObject *parent = nullptr);
+    ~GeneratorWorker();
+
+    // 取走槽 slot 中已生成的块: 与 block 交换内容. 只能在 blockReady(slot) 之后,
+    // releaseBlock() 之前调用
+    void takeBlock(int slot, QVector<double> &block);
+    void takeBlock16(int slot, QVector<qint16> &block);
+
+    // 消费端处理完一个块后调用, 归还一个缓冲区
+    void releaseBlock();
+
+    // 轮转缓冲区数量 (同时在途的最大块数)
+    static const int POOL_SIZE = 4;
+
+signals:
+    void blockReady(int slot);
+    void blockReady16(int slot);
+
+protected:
+    void run() override;
+
+private:
+    SignalGenerator *m_generator;
+    QSemaphore m_freeBlocks;
+    // 轮转的缓冲区, 每个槽在生成期间属于工作线程, blockReady() 之后到 releaseBlock() 之前属于消费端
+    QVector<QVector<double>> m_pool;
+    QVector<QVector<qint16>> m_pool16;
+};
+
+#endif // GENERATORWORKER_H
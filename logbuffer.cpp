@@ -0,0 +1,159 @@
+#include "logbuffer.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QMetaObject>
+
+LogBuffer::LogBuffer(QObject *parent) : QObject(parent),
+    m_slots(new Slot[QUEUE_CAPACITY]),
+    m_enqueuePos(0),
+    m_dequeuePos(0),
+    m_flushPending(false),
+    m_echoToDebug(true),
+    m_dropped(0),
+    m_reportedDropped(0),
+    m_historyStart(0)
+{
+    for (int i = 0; i < QUEUE_CAPACITY; ++i) {
+        m_slots[i].sequence.store(static_cast<quint64>(i), std::memory_order_relaxed);
+    }
+}
+
+void LogBuffer::append(const QString &message)
+{
+    LogEntry entry;
+    entry.sequence = 0;
+    entry.timestamp = QDateTime::currentMSecsSinceEpoch();
+    entry.message = message;
+
+    if (m_echoToDebug.load(std::memory_order_relaxed)) {
+        qDebug() << formatEntry(entry);
+    }
+
+    if (!tryEnqueue(entry)) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // 已经有待处理的 flush 时不再重复投递, 连续的日志合并成一次界面更新
+    if (!m_flushPending.exchange(true, std::memory_order_acq_rel)) {
+        QMetaObject::invokeMethod(this, "flush", Qt::QueuedConnection);
+    }
+}
+
+void LogBuffer::setEchoToDebug(bool enabled)
+{
+    m_echoToDebug.store(enabled, std::memory_order_relaxed);
+}
+
+bool LogBuffer::isEchoToDebug() const
+{
+    return m_echoToDebug.load(std::memory_order_relaxed);
+}
+
+QVector<LogEntry> LogBuffer::entries() const
+{
+    QVector<LogEntry> result;
+    result.reserve(m_history.size());
+    for (int i = 0; i < m_history.size(); ++i) {
+        result.append(m_history[(m_historyStart + i) % m_history.size()]);
+    }
+    return result;
+}
+
+QString LogBuffer::toString() const
+{
+    QString text;
+    const QVector<LogEntry> history = entries();
+    for (const LogEntry &entry : history) {
+        text.append(formatEntry(entry) + "\n");
+    }
+    return text;
+}
+
+quint64 LogBuffer::getDroppedCount() const
+{
+    return m_dropped.load(std::memory_order_relaxed);
+}
+
+QString LogBuffer::formatEntry(const LogEntry &entry)
+{
+    return QDateTime::fromMSecsSinceEpoch(entry.timestamp).toString("[yyyy-MM-dd hh:mm:ss.zzz] ") + entry.message;
+}
+
+void LogBuffer::flush()
+{
+    // 先清除标志再取数据, 取数据期间新写入的日志会再投递一次 flush, 不会遗漏
+    m_flushPending.store(false, std::memory_order_release);
+
+    QVector<LogEntry> added;
+    LogEntry entry;
+    while (tryDequeue(entry)) {
+        added.append(entry);
+    }
+
+    const quint64 dropped = m_dropped.load(std::memory_order_relaxed);
+    if (dropped != m_reportedDropped) {
+        LogEntry notice;
+        notice.sequence = added.isEmpty() ? m_dequeuePos : added.last().sequence;
+        notice.timestamp = QDateTime::currentMSecsSinceEpoch();
+        notice.message = QString("日志队列已满, 丢弃 %1 条日志").arg(dropped - m_reportedDropped);
+        added.append(notice);
+        m_reportedDropped = dropped;
+    }
+
+    if (added.isEmpty()) {
+        return;
+    }
+
+    for (const LogEntry &newEntry : added) {
+        if (m_history.size() < HISTORY_CAPACITY) {
+            m_history.append(newEntry);
+        } else {
+            m_history[m_historyStart] = newEntry;
+            m_historyStart = (m_historyStart + 1) % HISTORY_CAPACITY;
+        }
+    }
+
+    emit entriesAdded(added);
+}
+
+bool LogBuffer::tryEnqueue(LogEntry &entry)
+{
+    quint64 pos = m_enqueuePos.load(std::memory_order_relaxed);
+    Slot *slot;
+    for (;;) {
+        slot = &m_slots[pos & (QUEUE_CAPACITY - 1)];
+        const quint64 sequence = slot->sequence.load(std::memory_order_acquire);
+        const qint64 diff = static_cast<qint64>(sequence - pos);
+        if (diff == 0) {
+            // 槽位空闲, 抢占写入位置
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // 消费端还没有取走一整圈之前的数据, 队列已满
+            return false;
+        } else {
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    entry.sequence = pos;
+    slot->entry = entry;
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool LogBuffer::tryDequeue(LogEntry &entry)
+{
+    Slot *slot = &m_slots[m_dequeuePos & (QUEUE_CAPACITY - 1)];
+    if (slot->sequence.load(std::memory_order_acquire) != m_dequeuePos + 1) {
+        return false;
+    }
+
+    entry = slot->entry;
+    slot->entry.message.clear();
+    slot->sequence.store(m_dequeuePos + QUEUE_CAPACITY, std::memory_order_release);
+    ++m_dequeuePos;
+    return true;
+}
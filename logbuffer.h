@@ -0,0 +1,74 @@
+#ifndef LOGBUFFER_H
+#define LOGBUFFER_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <atomic>
+#include <memory>
+
+// 一条日志
+struct LogEntry {
+    quint64 sequence;   // 全局递增序号
+    qint64 timestamp;   // 自1970年起的毫秒数
+    QString message;
+};
+
+// 有界结构化日志
+// 任意线程调用 append() 时把日志写入无锁环形队列 (多生产者单消费者, 每个槽位带序号),
+// 写满时丢弃并计数, 不会阻塞工作线程. 所属线程合并处理排队的日志:
+// 移入有界的历史记录, 并通过 entriesAdded() 只发送新增的条目, 界面可以增量追加.
+class LogBuffer : public QObject
+{
+    Q_OBJECT
+public:
+    explicit LogBuffer(QObject *parent = nullptr);
+
+    // 线程安全, 不加锁
+    void append(const QString &message);
+
+    // 是否同时通过 qDebug 输出
+    void setEchoToDebug(bool enabled);
+    bool isEchoToDebug() const;
+
+    // 保留的历史记录 (只能在所属线程调用)
+    QVector<LogEntry> entries() const;
+    QString toString() const;
+    quint64 getDroppedCount() const;
+
+    static QString formatEntry(const LogEntry &entry);
+
+    // 排队中的最大条目数 (2的幂) 和保留的历史条目数
+    static const int QUEUE_CAPACITY = 1024;
+    static const int HISTORY_CAPACITY = 10000;
+
+signals:
+    void entriesAdded(const QVector<LogEntry> &entries);
+
+public slots:
+    // 取出排队的日志并发送 entriesAdded(), 由 append() 自动投递到所属线程
+    void flush();
+
+private:
+    struct Slot {
+        std::atomic<quint64> sequence;
+        LogEntry entry;
+    };
+
+    bool tryEnqueue(LogEntry &entry);
+    bool tryDequeue(LogEntry &entry);
+
+    std::unique_ptr<Slot[]> m_slots;
+    std::atomic<quint64> m_enqueuePos;
+    quint64 m_dequeuePos;           // 只由所属线程访问
+    std::atomic<bool> m_flushPending;
+    std::atomic<bool> m_echoToDebug;
+    std::atomic<quint64> m_dropped;
+    quint64 m_reportedDropped;
+
+    // 历史记录环形缓冲区
+    QVector<LogEntry> m_history;
+    int m_historyStart;
+};
+
+#endif // LOGBUFFER_H
@@ -0,0 +1,220 @@
+#include "lowpassfilter.h"
+
+#include "simdkernels.h"
+
+#include <QtMath>
+
+LowPassFilter::LowPassFilter() :
+    m_type(Boxcar),
+    m_cutoff(500.0),
+    m_samplingRate(8000.0),
+    m_order(4),
+    m_ripple(1.0)
+{
+    design();
+}
+
+void LowPassFilter::setType(Type type)
+{
+    if (type == m_type) {
+        return;
+    }
+    m_type = type;
+    design();
+
+    // 新类型之前保存的状态已经过时
+    switch (m_type) {
+    case Boxcar:
+    case Cic:
+        m_movingAverage.reset();
+        break;
+    case WindowedSinc:
+        m_fir.reset();
+        break;
+    default:
+        m_biquads.reset();
+        break;
+    }
+}
+
+LowPassFilter::Type LowPassFilter::getType() const
+{
+    return m_type;
+}
+
+void LowPassFilter::setCutoff(double cutoffFrequency)
+{
+    if (cutoffFrequency > 0.0 && cutoffFrequency != m_cutoff) {
+        m_cutoff = cutoffFrequency;
+        design();
+    }
+}
+
+double LowPassFilter::getCutoff() const
+{
+    return m_cutoff;
+}
+
+void LowPassFilter::setSamplingRate(double samplingRate)
+{
+    if (samplingRate > 0.0 && samplingRate != m_samplingRate) {
+        m_samplingRate = samplingRate;
+        design();
+    }
+}
+
+double LowPassFilter::getSamplingRate() const
+{
+    return m_samplingRate;
+}
+
+void LowPassFilter::setOrder(int order)
+{
+    order = qBound(1, order, BiquadCascade::MAX_ORDER);
+    if (order != m_order) {
+        m_order = order;
+        design();
+    }
+}
+
+int LowPassFilter::getOrder() const
+{
+    return m_order;
+}
+
+void LowPassFilter::setRipple(double rippleDb)
+{
+    if (rippleDb > 0.0 && rippleDb != m_ripple) {
+        m_ripple = rippleDb;
+        design();
+    }
+}
+
+double LowPassFilter::getRipple() const
+{
+    return m_ripple;
+}
+
+int LowPassFilter::getLength() const
+{
+    switch (m_type) {
+    case Boxcar:
+    case Cic:
+        return m_movingAverage.getLength();
+    case WindowedSinc:
+        return m_fir.getLength();
+    default:
+        return m_biquads.getSections().size();
+    }
+}
+
+void LowPassFilter::reset()
+{
+    m_movingAverage.reset();
+    m_fir.reset();
+    m_biquads.reset();
+}
+
+void LowPassFilter::saveState(State &state) const
+{
+    state.type = m_type;
+    state.cutoff = m_cutoff;
+    state.order = m_order;
+    state.ripple = m_ripple;
+    switch (m_type) {
+    case Boxcar:
+    case Cic:
+        m_movingAverage.saveState(state.history);
+        break;
+    case WindowedSinc:
+        m_fir.saveState(state.history);
+        break;
+    default:
+        m_biquads.saveState(state.history);
+        break;
+    }
+}
+
+void LowPassFilter::restoreState(const State &state)
+{
+    if (state.type != m_type || state.cutoff != m_cutoff || state.order != m_order || state.ripple != m_ripple) {
+        m_type = state.type;
+        m_cutoff = state.cutoff;
+        m_order = state.order;
+        m_ripple = state.ripple;
+        design();
+    }
+    switch (m_type) {
+    case Boxcar:
+    case Cic:
+        m_movingAverage.restoreState(state.history);
+        break;
+    case WindowedSinc:
+        m_fir.restoreState(state.history);
+        break;
+    default:
+        m_biquads.restoreState(state.history);
+        break;
+    }
+}
+
+void LowPassFilter::design()
+{
+    const double cutoff = qMin(m_cutoff, 0.49 * m_samplingRate);
+    switch (m_type) {
+    case Boxcar:
+    case Cic: {
+        // 窗口长度为 fs / fc 时第一个零点在 fc
+        const int order = m_type == Boxcar ? 1 : qMin(m_order, MovingAverage::MAX_ORDER);
+        if (order != m_movingAverage.getOrder()) {
+            m_movingAverage.setOrder(order);
+        }
+        m_movingAverage.setLength(qMax(1, qRound(m_samplingRate / cutoff)));
+        break;
+    }
+    case WindowedSinc: {
+        // Blackman 窗过渡带宽约 5.5 * fs / N, 取 N = 11 * fs / fc 使过渡带约为 fc / 2
+        const int length = qBound(3, static_cast<int>(std::ceil(11.0 * m_samplingRate / cutoff)),
+                                  MAX_FIR_LENGTH) | 1;
+        if (m_window.size() != length) {
+            m_window = WindowFunction::generate(WindowFunction::Blackman, length);
+        }
+        m_fir.setTaps(FirFilter::lowPassTaps(cutoff, m_samplingRate, length, m_window));
+        break;
+    }
+    case Butterworth:
+        m_biquads.setSections(BiquadCascade::butterworthLowPass(m_order, cutoff, m_samplingRate));
+        break;
+    case Chebyshev:
+        m_biquads.setSections(BiquadCascade::chebyshevLowPass(m_order, m_ripple, cutoff, m_samplingRate));
+        break;
+    }
+}
+
+void LowPassFilter::process(const double *input, double *output, int numSamples)
+{
+    switch (m_type) {
+    case Boxcar:
+    case Cic:
+        m_movingAverage.process(input, output, numSamples);
+        break;
+    case WindowedSinc:
+        m_fir.process(input, output, numSamples);
+        break;
+    default:
+        m_biquads.process(input, output, numSamples);
+        break;
+    }
+}
+
+void LowPassFilter::process(const qint16 *input, qint16 *output, int numSamples)
+{
+    m_tile.resize(TILE_SIZE);
+    double *tile = m_tile.data();
+    for (int start = 0; start < numSamples; start += TILE_SIZE) {
+        const int count = qMin(TILE_SIZE, numSamples - start);
+        SimdKernels::convertFromInt16(input + start, tile, count);
+        process(tile, tile, count);
+        SimdKernels::convertToInt16(tile, output + start, count);
+    }
+}
@@ -0,0 +1,85 @@
+#ifndef LOWPASSFILTER_H
+#define LOWPASSFILTER_H
+
+#include <QVector>
+
+#include "biquadcascade.h"
+#include "firfilter.h"
+#include "movingaverage.h"
+
+// 接收端的流式低通滤波器
+// 按类型选择滑动平均/CIC, 窗函数法FIR 或 巴特沃斯/切比雪夫 IIR, 状态在块之间保留, 数据可以按任意长度分块送入.
+// 改变截止频率只重新设计当前类型的系数 (O(滤波器长度), 不做迭代优化), 各滤波器保留历史样本/状态, 输出不中断.
+// 窗函数在FIR长度不变时复用, 只重新计算 sinc.
+class LowPassFilter
+{
+public:
+    enum Type {
+        Boxcar,         // 滑动平均, 窗口长度 fs / fc
+        Cic,            // order 级滑动平均级联
+        WindowedSinc,   // Blackman 窗 sinc, 过渡带约为 fc / 2
+        Butterworth,    // order 阶
+        Chebyshev       // order 阶切比雪夫I型, 通带波纹 ripple dB
+    };
+
+    // 重新处理同一段数据用的快照: 设计参数和当前类型滤波器的状态.
+    // 同一个 State 反复用于 saveState() 时不重新分配内存
+    struct State {
+        Type type;
+        double cutoff;
+        int order;
+        double ripple;
+        QVector<double> history;
+    };
+
+    LowPassFilter();
+
+    // 改变类型时清空新类型滤波器的状态
+    void setType(Type type);
+    Type getType() const;
+    void setCutoff(double cutoffFrequency);
+    double getCutoff() const;
+    void setSamplingRate(double samplingRate);
+    double getSamplingRate() const;
+    // CIC 的级数或IIR的阶数, 其他类型忽略
+    void setOrder(int order);
+    int getOrder() const;
+    void setRipple(double rippleDb);
+    double getRipple() const;
+
+    // 当前设计的长度: 滑动平均窗口长度, FIR抽头数, IIR节数
+    int getLength() const;
+
+    // 清空状态 (之前的输入视为0)
+    void reset();
+    // 保存/恢复快照; 恢复时参数与当前不同则重新设计 (采样率不在快照中, 应保持不变).
+    // 其他类型滤波器的状态不恢复, 之后切换类型时照常清空
+    void saveState(State &state) const;
+    void restoreState(const State &state);
+
+    // output 可以与 input 相同
+    void process(const double *input, double *output, int numSamples);
+    // 16位定点数据按 TILE_SIZE 分段转换为 double 滤波后再饱和转换回来
+    void process(const qint16 *input, qint16 *output, int numSamples);
+
+    static const int MAX_FIR_LENGTH = 8191;
+    static const int TILE_SIZE = 1024;
+
+private:
+    // 按当前参数重新设计当前类型, 保留状态
+    void design();
+
+    Type m_type;
+    double m_cutoff;
+    double m_samplingRate;
+    int m_order;
+    double m_ripple;
+
+    MovingAverage m_movingAverage;
+    FirFilter m_fir;
+    BiquadCascade m_biquads;
+    QVector<double> m_window;       // FIR窗函数, 长度变化时才重新生成
+    QVector<double> m_tile;         // 16位数据的转换缓冲区
+};
+
+#endif // LOWPASSFILTER_H
@@ -1,11 +1,25 @@
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
+#include "simdkernels.h"
 #include <QMessageBox>
 #include <QScrollBar>
 #include <QFileDialog>
+#include <QFileInfo>
+#include <QSignalBlocker>
 #include <limits>
 #include <algorithm>
 
+// 图表最多显示的点数
+static const int MAX_DISPLAY_POINTS = 1000;
+
+// 16位数据只转换图表要显示的部分
+static QVector<double> toDisplayData(const QVector<qint16> &data)
+{
+    QVector<double> result(qMin(MAX_DISPLAY_POINTS, data.size()));
+    SimdKernels::convertFromInt16(data.constData(), result.data(), result.size());
+    return result;
+}
+
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
@@ -57,7 +71,28 @@ void MainWindow::on_signalTypeComboBox_currentIndexChanged(int index)
         case 2: // 三角波
             m_signalGenerator->setSignalType(TRIANGLE_WAVE);
             break;
-        case 3: // 文件数据
+        case 3: // 锯齿波
+            m_signalGenerator->setSignalType(SAWTOOTH_WAVE);
+            break;
+        case 4: // 多音信号
+            m_signalGenerator->setSignalType(MULTI_TONE);
+            break;
+        case 5: // AM调制
+            m_signalGenerator->setSignalType(AM_SIGNAL);
+            break;
+        case 6: // FM调制
+            m_signalGenerator->setSignalType(FM_SIGNAL);
+            break;
+        case 7: // BPSK调制
+            m_signalGenerator->setSignalType(BPSK_SIGNAL);
+            break;
+        case 8: // QPSK调制
+            m_signalGenerator->setSignalType(QPSK_SIGNAL);
+            break;
+        case 9: // 16-QAM调制
+            m_signalGenerator->setSignalType(QAM16_SIGNAL);
+            break;
+        case 10: // 文件数据
             on_loadFileButton_clicked();
             break;
     }
@@ -94,22 +129,139 @@ void MainWindow::on_samplingRateComboBox_currentIndexChanged(int index)
             m_signalGenerator->setSamplingRate(RATE_8KHZ);
             break;
     }
+    m_channelModule->setSamplingRate(m_signalGenerator->getSamplingRate());
+    m_receiveAnalyzer->setSamplingRate(m_signalGenerator->getSamplingRate());
 }
 
 void MainWindow::on_loadFileButton_clicked()
 {
-    QString filePath = QFileDialog::getOpenFileName(this, "选择数据文件", "", "文本文件 (*.txt);;所有文件 (*)");
+    QString filePath = QFileDialog::getOpenFileName(this, "选择数据文件", "", "文本文件 (*.txt);;二进制采样文件 (*.sgc *.wav *.raw *.pcm *.i16 *.f32 *.f64);;所有文件 (*)");
     if (!filePath.isEmpty()) {
         ui->filePathEdit->setText(filePath);
+        // 采样率取自文件头时通过 samplingRateChanged() 同步
         m_signalGenerator->setDataFromFile(filePath);
     }
 }
 
+void MainWindow::onGeneratorSamplingRateChanged(SamplingRate rate)
+{
+    // 只同步选择框的显示, 不再触发 on_samplingRateComboBox_currentIndexChanged
+    const int index = rate == RATE_1KHZ ? 0 : rate == RATE_2KHZ ? 1 : rate == RATE_4KHZ ? 2 : 3;
+    const QSignalBlocker blocker(ui->samplingRateComboBox);
+    ui->samplingRateComboBox->setCurrentIndex(index);
+    m_channelModule->setSamplingRate(rate);
+    m_receiveAnalyzer->setSamplingRate(rate);
+}
+
+void MainWindow::on_multiToneEdit_editingFinished()
+{
+    QVector<MultiToneGenerator::Tone> tones;
+    if (!MultiToneGenerator::parseTones(ui->multiToneEdit->text(), tones)) {
+        QMessageBox::warning(this, "参数错误", "多音参数格式应为 频率:幅度[:相位], 多个单音用逗号分隔");
+        return;
+    }
+    m_signalGenerator->setTones(tones);
+}
+
+void MainWindow::on_chirpEdit_editingFinished()
+{
+    QString text = ui->chirpEdit->text().trimmed();
+    if (text.isEmpty()) {
+        m_signalGenerator->setChirp(0.0, 0.0, 1.0, 0.0);
+        return;
+    }
+
+    QStringList fields = text.split(':');
+    bool ok = fields.size() == 4;
+    double values[4] = {0.0, 0.0, 0.0, 0.0};
+    for (int i = 0; ok && i < 4; ++i) {
+        values[i] = fields[i].trimmed().toDouble(&ok);
+    }
+    if (!ok || values[2] <= 0.0) {
+        QMessageBox::warning(this, "参数错误", "扫频参数格式应为 起始频率:终止频率:时长(秒):幅度");
+        return;
+    }
+    m_signalGenerator->setChirp(values[0], values[1], values[2], values[3]);
+}
+
+void MainWindow::on_compositeNoiseSpinBox_valueChanged(double value)
+{
+    m_signalGenerator->setCompositeNoise(value);
+}
+
+void MainWindow::on_symbolRateSpinBox_valueChanged(double value)
+{
+    m_signalGenerator->setSymbolRate(value);
+}
+
+void MainWindow::on_bitSourceComboBox_currentIndexChanged(int index)
+{
+    static const Modulator::BitSource sources[] = {
+        Modulator::PRBS7, Modulator::PRBS9, Modulator::PRBS15,
+        Modulator::PRBS23, Modulator::PRBS31, Modulator::CustomBits
+    };
+    if (index >= 0 && index < 6) {
+        m_signalGenerator->setBitSource(sources[index]);
+    }
+}
+
+void MainWindow::on_customBitsEdit_editingFinished()
+{
+    QVector<quint8> bits;
+    const QString text = ui->customBitsEdit->text();
+    for (const QChar &c : text) {
+        if (c == '0' || c == '1') {
+            bits.append(c == '1' ? 1 : 0);
+        } else if (!c.isSpace()) {
+            QMessageBox::warning(this, "参数错误", "自定义比特序列只能包含0和1");
+            return;
+        }
+    }
+    m_signalGenerator->setCustomBits(bits);
+}
+
+void MainWindow::on_rollOffSpinBox_valueChanged(double value)
+{
+    m_signalGenerator->setRollOff(value);
+}
+
+void MainWindow::on_modulationIndexSpinBox_valueChanged(double value)
+{
+    m_signalGenerator->setModulationIndex(value);
+}
+
+void MainWindow::on_frequencyDeviationSpinBox_valueChanged(double value)
+{
+    m_signalGenerator->setFrequencyDeviation(value);
+}
+
+void MainWindow::on_antiAliasingCheckBox_toggled(bool checked)
+{
+    m_signalGenerator->setAntiAliasing(checked);
+}
+
+void MainWindow::on_streamingModeCheckBox_toggled(bool checked)
+{
+    m_signalGenerator->setStreamingMode(checked);
+}
+
+void MainWindow::on_int16PipelineCheckBox_toggled(bool checked)
+{
+    m_signalGenerator->setSampleFormat(checked ? INT16_SAMPLES : DOUBLE_SAMPLES);
+}
+
+void MainWindow::on_blockSizeSpinBox_valueChanged(int value)
+{
+    m_signalGenerator->setBlockSize(value);
+}
+
 void MainWindow::on_startGeneratorButton_clicked()
 {
     m_signalGenerator->startGeneration();
     ui->startGeneratorButton->setEnabled(false);
     ui->stopGeneratorButton->setEnabled(true);
+    ui->streamingModeCheckBox->setEnabled(false);
+    ui->int16PipelineCheckBox->setEnabled(false);
 }
 
 void MainWindow::on_stopGeneratorButton_clicked()
@@ -117,12 +269,16 @@ void MainWindow::on_stopGeneratorButton_clicked()
     m_signalGenerator->stopGeneration();
     ui->startGeneratorButton->setEnabled(true);
     ui->stopGeneratorButton->setEnabled(false);
+    ui->streamingModeCheckBox->setEnabled(true);
+    ui->int16PipelineCheckBox->setEnabled(true);
 }
 
 // 信道控制相关
 void MainWindow::setupChannelModule()
 {
     m_channelModule = new ChannelModule(this);
+    m_channelModule->setSamplingRate(m_signalGenerator->getSamplingRate());
+    m_berSweep = new BerSweep(this);
 }
 
 void MainWindow::on_noiseAmplitudeSlider_valueChanged(int value)
@@ -132,10 +288,101 @@ void MainWindow::on_noiseAmplitudeSlider_valueChanged(int value)
     m_channelModule->setNoiseAmplitude(amplitude);
 }
 
+void MainWindow::on_berSweepButton_clicked()
+{
+    if (m_berSweep->isRunning()) {
+        m_berSweep->requestInterruption();
+        return;
+    }
+
+    // 噪声幅度网格: 起始:终止:点数
+    QStringList fields = ui->berSweepEdit->text().split(':');
+    bool ok = fields.size() == 3;
+    double values[3] = {0.0, 0.0, 0.0};
+    for (int i = 0; ok && i < 3; ++i) {
+        values[i] = fields[i].trimmed().toDouble(&ok);
+    }
+    const int count = static_cast<int>(values[2]);
+    if (!ok || values[0] < 0.0 || values[1] < 0.0 || count < 1) {
+        QMessageBox::warning(this, "参数错误", "误码率扫描参数格式应为 起始噪声幅度:终止噪声幅度:点数");
+        return;
+    }
+
+    BerSweep::Settings settings;
+    settings.noiseAmplitudes.clear();
+    for (int i = 0; i < count; ++i) {
+        settings.noiseAmplitudes.append(count == 1 ? values[0] : values[0] + (values[1] - values[0]) * i / (count - 1));
+    }
+
+    // 当前信号是 BPSK/QPSK/16-QAM 时只扫描该调制方式, 否则三种都扫描
+    switch (ui->signalTypeComboBox->currentIndex()) {
+        case 7:
+            settings.schemes = { Modulator::BPSK };
+            break;
+        case 8:
+            settings.schemes = { Modulator::QPSK };
+            break;
+        case 9:
+            settings.schemes = { Modulator::QAM16 };
+            break;
+        default:
+            settings.schemes = { Modulator::BPSK, Modulator::QPSK, Modulator::QAM16 };
+            break;
+    }
+    settings.symbolRates = { ui->symbolRateSpinBox->value() };
+    settings.samplingRate = m_signalGenerator->getSamplingRate();
+    settings.carrierFrequency = ui->frequencySpinBox->value();
+    settings.amplitude = ui->amplitudeSpinBox->value();
+    settings.rollOff = ui->rollOffSpinBox->value();
+
+    if (!m_berSweep->setSettings(settings)) {
+        QMessageBox::warning(this, "参数错误", m_berSweep->errorString());
+        return;
+    }
+
+    ui->berResultTextEdit->clear();
+    ui->berSweepButton->setText("停止误码率扫描");
+    m_berSweep->start();
+}
+
+void MainWindow::onBerPointFinished(int index)
+{
+    const BerSweep::PointResult result = m_berSweep->getResult(index);
+    ui->berResultTextEdit->appendPlainText(
+        QString("%1 %2Bd 噪声%3: SNR %4dB Eb/N0 %5dB, BER %6 [%7, %8], 误比特 %9/%10%11")
+            .arg(BerSweep::schemeName(result.scheme))
+            .arg(result.symbolRate)
+            .arg(result.noiseAmplitude)
+            .arg(result.snrDb, 0, 'f', 2)
+            .arg(result.ebN0Db, 0, 'f', 2)
+            .arg(result.ber, 0, 'e', 3)
+            .arg(result.berLower, 0, 'e', 2)
+            .arg(result.berUpper, 0, 'e', 2)
+            .arg(result.bitErrors)
+            .arg(result.bits)
+            .arg(result.converged ? "" : " (未收敛)"));
+}
+
+void MainWindow::onBerSweepFinished()
+{
+    ui->berSweepButton->setText("开始误码率扫描");
+}
+
 // 接收分析相关
 void MainWindow::setupReceiveAnalyzer()
 {
     m_receiveAnalyzer = new ReceiveAnalyzer(this);
+    m_receiveAnalyzer->setSamplingRate(m_signalGenerator->getSamplingRate());
+    m_streamRecorder = new StreamRecorder(this);
+    m_recordingTimer = new QTimer(this);
+    m_recordingTimer->setInterval(500);
+}
+
+void MainWindow::on_decimationComboBox_currentIndexChanged(int index)
+{
+    if (!m_receiveAnalyzer->setDecimation(ui->decimationComboBox->itemText(index).toInt())) {
+        QMessageBox::warning(this, "参数错误", m_receiveAnalyzer->errorString());
+    }
 }
 
 void MainWindow::on_filterCutoffSpinBox_valueChanged(double value)
@@ -143,18 +390,136 @@ void MainWindow::on_filterCutoffSpinBox_valueChanged(double value)
     m_receiveAnalyzer->setFilterCutoff(value);
 }
 
+void MainWindow::on_filterTypeComboBox_currentIndexChanged(int index)
+{
+    // 下拉框顺序与 LowPassFilter::Type 相同
+    m_receiveAnalyzer->setFilterType(static_cast<LowPassFilter::Type>(index));
+}
+
+void MainWindow::on_filterOrderSpinBox_valueChanged(int value)
+{
+    m_receiveAnalyzer->setFilterOrder(value);
+}
+
+void MainWindow::on_spectrumWindowComboBox_currentIndexChanged(int index)
+{
+    static const WindowFunction::Type windows[] = {
+        WindowFunction::Hann, WindowFunction::BlackmanHarris, WindowFunction::FlatTop
+    };
+    SpectrumAnalyzer::Settings settings = m_receiveAnalyzer->getSpectrumSettings();
+    settings.window = windows[qBound(0, index, 2)];
+    m_receiveAnalyzer->setSpectrumSettings(settings);
+}
+
+void MainWindow::on_fftSizeComboBox_currentIndexChanged(int index)
+{
+    SpectrumAnalyzer::Settings settings = m_receiveAnalyzer->getSpectrumSettings();
+    settings.fftSize = ui->fftSizeComboBox->itemText(index).toInt();
+    if (!m_receiveAnalyzer->setSpectrumSettings(settings)) {
+        QMessageBox::warning(this, "参数错误", m_receiveAnalyzer->errorString());
+    }
+}
+
+void MainWindow::on_spectrumAveragingComboBox_currentIndexChanged(int index)
+{
+    // 下拉框顺序与 SpectrumAnalyzer::Averaging 相同
+    SpectrumAnalyzer::Settings settings = m_receiveAnalyzer->getSpectrumSettings();
+    settings.averaging = static_cast<SpectrumAnalyzer::Averaging>(index);
+    m_receiveAnalyzer->setSpectrumSettings(settings);
+}
+
 void MainWindow::on_saveDataButton_clicked()
 {
-    QString filePath = QFileDialog::getSaveFileName(this, "保存数据", "", "文本文件 (*.txt);;所有文件 (*)");
-    if (!filePath.isEmpty()) {
+    QString filePath = QFileDialog::getSaveFileName(this, "保存数据", "", "采集文件 (*.sgc);;文本文件 (*.txt);;所有文件 (*)");
+    if (filePath.isEmpty()) {
+        return;
+    }
+
+    // 文本格式在界面线程中写入; 其余保存为采集文件, 由后台线程写入, 写完后在 onCaptureSaved 中提示
+    if (QFileInfo(filePath).suffix().toLower() == "txt") {
         if (m_receiveAnalyzer->saveDataToFile(m_receiveAnalyzer->getRawData(), filePath)) {
             QMessageBox::information(this, "保存成功", "数据已成功保存到文件！");
         } else {
             QMessageBox::warning(this, "保存失败", "保存数据时出错！");
         }
+    } else if (!m_receiveAnalyzer->saveCaptureFile(filePath)) {
+        QMessageBox::warning(this, "保存失败", m_receiveAnalyzer->errorString());
+    }
+}
+
+void MainWindow::onCaptureSaved(bool ok, const QString &errorString)
+{
+    if (ok) {
+        QMessageBox::information(this, "保存成功", "数据已成功保存到文件！");
+    } else {
+        QMessageBox::warning(this, "保存失败", errorString);
     }
 }
 
+void MainWindow::on_recordButton_clicked()
+{
+    if (m_streamRecorder->isRecording()) {
+        // 剩余数据由后台线程写完, 在 onRecordingFinished 中提示
+        m_streamRecorder->stop();
+        m_recordingTimer->stop();
+        updateRecordingStatus();
+        ui->recordButton->setText("开始录制");
+        ui->samplingRateComboBox->setEnabled(true);
+        ui->decimationComboBox->setEnabled(true);
+        return;
+    }
+
+    StreamRecorder::Settings settings;
+    settings.taps = (ui->recordGeneratorCheckBox->isChecked() ? StreamRecorder::GeneratorTap : 0) |
+                    (ui->recordChannelCheckBox->isChecked() ? StreamRecorder::ChannelTap : 0) |
+                    (ui->recordFilteredCheckBox->isChecked() ? StreamRecorder::FilteredTap : 0);
+    settings.sampleFormat = m_signalGenerator->getSampleFormat() == INT16_SAMPLES ?
+                CaptureFormat::Int16 : CaptureFormat::Float32;
+    settings.samplingRate = m_signalGenerator->getSamplingRate();
+    settings.filteredSamplingRate = m_receiveAnalyzer->getAnalysisSamplingRate();
+    // 界面线程不等待磁盘, 写不过来时丢弃并在状态栏显示
+    settings.timeout = 0;
+
+    QString basePath = QFileDialog::getSaveFileName(this, "录制数据", "", "采集文件 (*.sgc)");
+    if (basePath.isEmpty()) {
+        return;
+    }
+    if (!m_streamRecorder->start(basePath, settings)) {
+        QMessageBox::warning(this, "录制失败", m_streamRecorder->errorString());
+        return;
+    }
+
+    ui->recordButton->setText("停止录制");
+    // 文件头中的采样率在录制期间不能改变
+    ui->samplingRateComboBox->setEnabled(false);
+    ui->decimationComboBox->setEnabled(false);
+    m_recordingTimer->start();
+    updateRecordingStatus();
+}
+
+void MainWindow::onRecordingFinished(bool ok)
+{
+    updateRecordingStatus();
+    if (!ok) {
+        QMessageBox::warning(this, "录制失败", m_streamRecorder->errorString());
+    }
+}
+
+void MainWindow::updateRecordingStatus()
+{
+    const StreamRecorder::Statistics statistics = m_streamRecorder->getTotalStatistics();
+    QString status = QString("%1录制: %2 个样本, %3 MB")
+            .arg(m_streamRecorder->isRecording() ? "正在" : "已停止")
+            .arg(statistics.framesWritten)
+            .arg(statistics.bytesWritten / (1024.0 * 1024.0), 0, 'f', 1);
+    if (statistics.droppedBlocks > 0) {
+        status += QString(", 磁盘写入跟不上, 丢弃 %1 块 (%2 个样本)")
+                .arg(statistics.droppedBlocks)
+                .arg(statistics.droppedSamples);
+    }
+    ui->statusbar->showMessage(status);
+}
+
 // 示波器控制相关
 void MainWindow::setupOscilloscope()
 {
@@ -326,7 +691,7 @@ void MainWindow::connectSignals()
     
     // 信道到接收分析器
     connect(m_channelModule, &ChannelModule::signalProcessed,
-            m_receiveAnalyzer, &ReceiveAnalyzer::onSignalReceived);
+            m_receiveAnalyzer, qOverload<const QVector<double> &>(&ReceiveAnalyzer::onSignalReceived));
     
     // 信号发生器到示波器 (通道0)
     connect(m_signalGenerator, &SignalGenerator::signalGenerated,
@@ -340,14 +705,38 @@ void MainWindow::connectSignals()
                 m_oscilloscope->onSignalReceived(1, data);
             });
     
+    // 误码率扫描的结果逐点显示
+    connect(m_berSweep, &BerSweep::pointFinished, this, &MainWindow::onBerPointFinished);
+    connect(m_berSweep, &BerSweep::finished, this, &MainWindow::onBerSweepFinished);
+    
+    // 16位定点数据通路, 与上面的连接一一对应
+    connect(m_signalGenerator, &SignalGenerator::signalGenerated16,
+            m_channelModule, &ChannelModule::onSignalReceived16);
+    
+    connect(m_channelModule, &ChannelModule::signalProcessed16,
+            m_receiveAnalyzer, qOverload<const QVector<qint16> &>(&ReceiveAnalyzer::onSignalReceived16));
+    
+    connect(m_signalGenerator, &SignalGenerator::signalGenerated16,
+            [this](const QVector<qint16> &data) {
+                m_oscilloscope->onSignalReceived16(0, data);
+            });
+    
+    connect(m_channelModule, &ChannelModule::signalProcessed16,
+            [this](const QVector<qint16> &data) {
+                m_oscilloscope->onSignalReceived16(1, data);
+            });
+    
     // 日志更新
-    connect(m_signalGenerator, &SignalGenerator::logUpdated,
-            this, &MainWindow::updateLogText);
+    connect(m_signalGenerator, &SignalGenerator::logEntriesAdded,
+            this, &MainWindow::appendLogEntries);
     
     // UI 更新
     connect(m_signalGenerator, &SignalGenerator::signalGenerated,
             this, &MainWindow::updateGeneratorUI);
     
+    connect(m_signalGenerator, &SignalGenerator::samplingRateChanged,
+            this, &MainWindow::onGeneratorSamplingRateChanged);
+    
     connect(m_channelModule, &ChannelModule::signalProcessed,
             this, &MainWindow::updateChannelUI);
     
@@ -357,13 +746,50 @@ void MainWindow::connectSignals()
     connect(m_receiveAnalyzer, &ReceiveAnalyzer::spectrumDataReady,
             this, &MainWindow::updateSpectrumUI);
     
+    connect(m_receiveAnalyzer, &ReceiveAnalyzer::captureSaved,
+            this, &MainWindow::onCaptureSaved);
+    
+    // 连续录制: 按数据通路的样本格式录制各节点
+    connect(m_signalGenerator, &SignalGenerator::signalGenerated,
+            m_streamRecorder, &StreamRecorder::onGeneratorData);
+    connect(m_signalGenerator, &SignalGenerator::signalGenerated16,
+            m_streamRecorder, &StreamRecorder::onGeneratorData16);
+    connect(m_channelModule, &ChannelModule::signalProcessed,
+            m_streamRecorder, &StreamRecorder::onChannelData);
+    connect(m_channelModule, &ChannelModule::signalProcessed16,
+            m_streamRecorder, &StreamRecorder::onChannelData16);
+    connect(m_receiveAnalyzer, &ReceiveAnalyzer::filteredBlockReady,
+            m_streamRecorder, &StreamRecorder::onFilteredData);
+    connect(m_receiveAnalyzer, &ReceiveAnalyzer::filteredBlockReady16,
+            m_streamRecorder, &StreamRecorder::onFilteredData16);
+    connect(m_streamRecorder, &StreamRecorder::finished,
+            this, &MainWindow::onRecordingFinished);
+    connect(m_recordingTimer, &QTimer::timeout,
+            this, &MainWindow::updateRecordingStatus);
+    
     connect(m_oscilloscope, &Oscilloscope::dataUpdated,
             this, &MainWindow::updateOscilloscopeUI);
     
+    connect(m_signalGenerator, &SignalGenerator::signalGenerated16,
+            this, &MainWindow::updateGeneratorUI16);
+    
+    connect(m_channelModule, &ChannelModule::signalProcessed16,
+            this, &MainWindow::updateChannelUI16);
+    
+    connect(m_receiveAnalyzer, &ReceiveAnalyzer::filteredDataReady16,
+            this, &MainWindow::updateReceiverUI16);
+    
+    connect(m_oscilloscope, &Oscilloscope::dataUpdated16,
+            this, &MainWindow::updateOscilloscopeUI16);
+    
     // 添加这些连接，确保示波器启动后能够获取现有数据
     connect(ui->startOscilloscopeButton, &QPushButton::clicked, [this]() {
         // 如果信号发生器已经生成了数据，立即发送给示波器
-        if (m_signalGenerator->isGenerating()) {
+        if (m_signalGenerator->isGenerating() && m_signalGenerator->getSampleFormat() == INT16_SAMPLES) {
+            QVector<qint16> generatedData = m_signalGenerator->getGeneratedData16();
+            m_oscilloscope->onSignalReceived16(0, generatedData);
+            m_oscilloscope->onSignalReceived16(1, m_channelModule->processSignal(generatedData));
+        } else if (m_signalGenerator->isGenerating()) {
             m_oscilloscope->onSignalReceived(0, m_signalGenerator->getGeneratedData());
             
             // 如果信道也有数据，发送给示波器通道1
@@ -374,6 +800,26 @@ void MainWindow::connectSignals()
 }
 
 // UI 更新函数
+void MainWindow::updateGeneratorUI16(const QVector<qint16> &data)
+{
+    updateGeneratorUI(toDisplayData(data));
+}
+
+void MainWindow::updateChannelUI16(const QVector<qint16> &data)
+{
+    updateChannelUI(toDisplayData(data));
+}
+
+void MainWindow::updateReceiverUI16(const QVector<qint16> &filteredData)
+{
+    updateReceiverUI(toDisplayData(filteredData));
+}
+
+void MainWindow::updateOscilloscopeUI16(int channel, const QVector<qint16> &data)
+{
+    updateOscilloscopeUI(channel, toDisplayData(data));
+}
+
 void MainWindow::updateGeneratorUI(const QVector<double> &data)
 {
     if (data.isEmpty()) return;
@@ -442,10 +888,8 @@ void MainWindow::updateReceiverUI(const QVector<double> &filteredData)
     
     m_receiverSeries->clear();
     
-    double timeStep = 1.0 / static_cast<double>(
-        ui->samplingRateComboBox->currentIndex() == 0 ? RATE_1KHZ :
-        ui->samplingRateComboBox->currentIndex() == 1 ? RATE_2KHZ :
-        ui->samplingRateComboBox->currentIndex() == 2 ? RATE_4KHZ : RATE_8KHZ);
+    // 滤波结果按抽取后的采样率
+    double timeStep = 1.0 / m_receiveAnalyzer->getAnalysisSamplingRate();
     
     // 查找最大值和最小值
     double minValue = filteredData[0];
@@ -532,8 +976,11 @@ void MainWindow::updateOscilloscopeUI(int channel, const QVector<double> &data)
     }
 }
 
-void MainWindow::updateLogText(const QString &log)
+void MainWindow::appendLogEntries(const QVector<LogEntry> &entries)
 {
-    ui->logTextEdit->setPlainText(log);
+    // 只追加新条目, 文本框保留的行数有上限
+    for (const LogEntry &entry : entries) {
+        ui->logTextEdit->appendPlainText(LogBuffer::formatEntry(entry));
+    }
     ui->logTextEdit->verticalScrollBar()->setValue(ui->logTextEdit->verticalScrollBar()->maximum());
 }
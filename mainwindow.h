@@ -5,9 +5,12 @@
 #include <QComboBox>
 #include <QSlider>
 #include <QDoubleSpinBox>
+#include <QSpinBox>
+#include <QCheckBox>
 #include <QPushButton>
 #include <QLineEdit>
 #include <QTextEdit>
+#include <QPlainTextEdit>
 #include <QFileDialog>
 #include <QLabel>
 #include <QGroupBox>
@@ -18,11 +21,14 @@
 #include <QtMath>
 #include <QMessageBox>
 #include <QScrollBar>
+#include <QTimer>
 
 #include "signalgenerator.h"
 #include "channelmodule.h"
+#include "bersweep.h"
 #include "receiveanalyzer.h"
 #include "oscilloscope.h"
+#include "streamrecorder.h"
 
 QT_CHARTS_USE_NAMESPACE
 
@@ -48,15 +54,42 @@ private slots:
     void on_dcOffsetSpinBox_valueChanged(double value);
     void on_samplingRateComboBox_currentIndexChanged(int index);
     void on_loadFileButton_clicked();
+    void onGeneratorSamplingRateChanged(SamplingRate rate);
+    void on_multiToneEdit_editingFinished();
+    void on_chirpEdit_editingFinished();
+    void on_compositeNoiseSpinBox_valueChanged(double value);
+    void on_symbolRateSpinBox_valueChanged(double value);
+    void on_bitSourceComboBox_currentIndexChanged(int index);
+    void on_customBitsEdit_editingFinished();
+    void on_rollOffSpinBox_valueChanged(double value);
+    void on_modulationIndexSpinBox_valueChanged(double value);
+    void on_frequencyDeviationSpinBox_valueChanged(double value);
+    void on_antiAliasingCheckBox_toggled(bool checked);
+    void on_streamingModeCheckBox_toggled(bool checked);
+    void on_int16PipelineCheckBox_toggled(bool checked);
+    void on_blockSizeSpinBox_valueChanged(int value);
     void on_startGeneratorButton_clicked();
     void on_stopGeneratorButton_clicked();
     
     // 信道控制
     void on_noiseAmplitudeSlider_valueChanged(int value);
+    void on_berSweepButton_clicked();
+    void onBerPointFinished(int index);
+    void onBerSweepFinished();
     
     // 接收分析控制
+    void on_decimationComboBox_currentIndexChanged(int index);
     void on_filterCutoffSpinBox_valueChanged(double value);
+    void on_filterTypeComboBox_currentIndexChanged(int index);
+    void on_filterOrderSpinBox_valueChanged(int value);
+    void on_spectrumWindowComboBox_currentIndexChanged(int index);
+    void on_fftSizeComboBox_currentIndexChanged(int index);
+    void on_spectrumAveragingComboBox_currentIndexChanged(int index);
     void on_saveDataButton_clicked();
+    void onCaptureSaved(bool ok, const QString &errorString);
+    void on_recordButton_clicked();
+    void onRecordingFinished(bool ok);
+    void updateRecordingStatus();
     
     // 示波器控制
     void on_timePerDivSpinBox_valueChanged(double value);
@@ -72,7 +105,12 @@ private slots:
     void updateReceiverUI(const QVector<double> &filteredData);
     void updateSpectrumUI(const QVector<double> &spectrumData, const QVector<double> &freqAxis);
     void updateOscilloscopeUI(int channel, const QVector<double> &data);
-    void updateLogText(const QString &log);
+    // 16位定点数据通路: 只把要显示的点转换为double
+    void updateGeneratorUI16(const QVector<qint16> &data);
+    void updateChannelUI16(const QVector<qint16> &data);
+    void updateReceiverUI16(const QVector<qint16> &filteredData);
+    void updateOscilloscopeUI16(int channel, const QVector<qint16> &data);
+    void appendLogEntries(const QVector<LogEntry> &entries);
 
 private:
     Ui::MainWindow *ui;
@@ -80,8 +118,11 @@ private:
     // 模块实例
     SignalGenerator *m_signalGenerator;
     ChannelModule *m_channelModule;
+    BerSweep *m_berSweep;
     ReceiveAnalyzer *m_receiveAnalyzer;
     Oscilloscope *m_oscilloscope;
+    StreamRecorder *m_streamRecorder;
+    QTimer *m_recordingTimer;
     
     // 图表
     QChart *m_generatorChart;
@@ -0,0 +1,310 @@
+#include "modulator.h"
+
+#include "nco.h"
+#include "simdkernels.h"
+
+#include <QtMath>
+
+// 星座归一化系数: QPSK 1/sqrt(2), 16-QAM 1/sqrt(10), 平均符号功率为1
+static const double QPSK_SCALE = 0.70710678118654752440;
+static const double QAM16_SCALE = 0.31622776601683793320;
+
+// 根升余弦脉冲, t 以符号周期为单位
+static double rootRaisedCosine(double t, double beta)
+{
+    if (std::fabs(t) < 1e-9) {
+        return 1.0 - beta + 4.0 * beta / M_PI;
+    }
+    if (std::fabs(std::fabs(t) - 1.0 / (4.0 * beta)) < 1e-9) {
+        return beta / std::sqrt(2.0) * ((1.0 + 2.0 / M_PI) * std::sin(M_PI / (4.0 * beta)) +
+                                        (1.0 - 2.0 / M_PI) * std::cos(M_PI / (4.0 * beta)));
+    }
+    double x = 4.0 * beta * t;
+    return (std::sin(M_PI * t * (1.0 - beta)) + x * std::cos(M_PI * t * (1.0 + beta))) /
+           (M_PI * t * (1.0 - x * x));
+}
+
+Modulator::Modulator() :
+    m_scheme(BPSK),
+    m_samplingRate(1000.0),
+    m_symbolRate(100.0),
+    m_samplesPerSymbol(10),
+    m_bitSource(PRBS9),
+    m_lfsr(0),
+    m_customPos(0),
+    m_rollOff(0.35),
+    m_filterSpan(8),
+    m_historyPos(0),
+    m_sampleInSymbol(0),
+    m_carrierPhase(0),
+    m_carrierIncrement(0),
+    m_carrierFrequency(100.0),
+    m_modulationIndex(0.5),
+    m_frequencyDeviation(50.0)
+{
+    setCarrier(m_carrierFrequency, m_samplingRate);
+    reset();
+}
+
+void Modulator::setScheme(Scheme scheme)
+{
+    m_scheme = scheme;
+}
+
+Modulator::Scheme Modulator::getScheme() const
+{
+    return m_scheme;
+}
+
+void Modulator::setCarrier(double frequency, double samplingRate)
+{
+    bool rateChanged = samplingRate != m_samplingRate;
+    m_carrierFrequency = frequency;
+    m_samplingRate = samplingRate;
+    m_carrierIncrement = cyclesToPhase(frequency / samplingRate);
+    if (rateChanged || m_taps.isEmpty()) {
+        setSymbolRate(m_symbolRate);
+    }
+}
+
+void Modulator::setSymbolRate(double symbolRate)
+{
+    if (symbolRate <= 0.0) {
+        return;
+    }
+
+    // 每个符号至少2个样本
+    m_symbolRate = symbolRate;
+    m_samplesPerSymbol = qMax(2, qRound(m_samplingRate / symbolRate));
+    designFilter();
+}
+
+double Modulator::getSymbolRate() const
+{
+    return m_samplingRate / m_samplesPerSymbol;
+}
+
+int Modulator::getSamplesPerSymbol() const
+{
+    return m_samplesPerSymbol;
+}
+
+void Modulator::setBitSource(BitSource source)
+{
+    m_bitSource = source;
+    m_lfsr = source == CustomBits ? 0 : (1u << source) - 1;
+    m_customPos = 0;
+}
+
+Modulator::BitSource Modulator::getBitSource() const
+{
+    return m_bitSource;
+}
+
+void Modulator::setCustomBits(const QVector<quint8> &bits)
+{
+    m_customBits = bits;
+    m_customPos = 0;
+}
+
+void Modulator::setBitSourceState(quint64 state)
+{
+    if (m_bitSource == CustomBits) {
+        m_customPos = m_customBits.isEmpty() ? 0 : static_cast<int>(state % static_cast<quint64>(m_customBits.size()));
+        return;
+    }
+
+    // m 序列遍历所有非零的寄存器状态, 每个状态对应序列中的一个位置
+    const quint32 mask = (1u << m_bitSource) - 1;
+    m_lfsr = static_cast<quint32>(state) & mask;
+    if (m_lfsr == 0) {
+        m_lfsr = mask;
+    }
+}
+
+void Modulator::setRollOff(double rollOff)
+{
+    m_rollOff = qBound(0.01, rollOff, 1.0);
+    designFilter();
+}
+
+double Modulator::getRollOff() const
+{
+    return m_rollOff;
+}
+
+void Modulator::setFilterSpan(int symbols)
+{
+    m_filterSpan = qBound(2, symbols, 32);
+    designFilter();
+}
+
+int Modulator::getFilterSpan() const
+{
+    return m_filterSpan;
+}
+
+QVector<double> Modulator::getFilterTaps() const
+{
+    return m_taps;
+}
+
+void Modulator::setModulationIndex(double index)
+{
+    m_modulationIndex = qBound(0.0, index, 1.0);
+}
+
+void Modulator::setFrequencyDeviation(double deviation)
+{
+    // 采样率的1/4的限制在 generate() 中按当时的采样率施加, 之后降低采样率时同样有效
+    m_frequencyDeviation = qMax(0.0, deviation);
+}
+
+void Modulator::reset()
+{
+    setBitSource(m_bitSource);
+    m_historyI.fill(0.0);
+    m_historyQ.fill(0.0);
+    m_historyPos = 0;
+    m_sampleInSymbol = 0;
+    m_carrierPhase = 0;
+}
+
+int Modulator::bitsPerSymbol(Scheme scheme)
+{
+    return scheme == QPSK ? 2 : scheme == QAM16 ? 4 : 1;
+}
+
+void Modulator::generate(double *output, int numSamples, double amplitude, double offset)
+{
+    const int sps = m_samplesPerSymbol;
+    const int span = m_filterSpan;
+
+    // (c, s) 每个样本转过一个载波相位增量
+    double c = std::cos(phaseToRadians(m_carrierPhase));
+    double s = std::sin(phaseToRadians(m_carrierPhase));
+    const double stepC = std::cos(phaseToRadians(m_carrierIncrement));
+    const double stepS = std::sin(phaseToRadians(m_carrierIncrement));
+    // 成形后的基带有过冲, 频偏限制在采样率的1/4以内避免瞬时频率超过奈奎斯特频率
+    const double deviationCycles = qBound(0.0, m_frequencyDeviation, m_samplingRate / 4.0) / m_samplingRate;
+
+    for (int n = 0; n < numSamples; ++n) {
+        if (m_sampleInSymbol == 0) {
+            m_historyPos = m_historyPos + 1 == span ? 0 : m_historyPos + 1;
+            nextSymbol(m_historyI[m_historyPos], m_historyQ[m_historyPos]);
+        }
+
+        // 成形滤波: 当前样本受最近 span 个符号影响
+        const double *taps = m_taps.constData() + m_sampleInSymbol;
+        double baseI = 0.0;
+        double baseQ = 0.0;
+        int index = m_historyPos;
+        for (int k = 0; k < span; ++k) {
+            baseI += taps[k * sps] * m_historyI[index];
+            baseQ += taps[k * sps] * m_historyQ[index];
+            index = index == 0 ? span - 1 : index - 1;
+        }
+
+        double y;
+        switch (m_scheme) {
+            case AM:
+                y = (1.0 + m_modulationIndex * baseI) * c;
+                break;
+            case FM:
+                y = std::cos(phaseToRadians(m_carrierPhase));
+                // 按周期数回绕后再换算成整数相位, 任何基带幅度都不会超出 64 位范围
+                m_carrierPhase += cyclesToPhase(deviationCycles * baseI);
+                break;
+            default:
+                y = baseI * c - baseQ * s;
+                break;
+        }
+        output[n] = amplitude * y + offset;
+
+        double nextC = c * stepC - s * stepS;
+        s = c * stepS + s * stepC;
+        c = nextC;
+        m_carrierPhase += m_carrierIncrement;
+
+        if (++m_sampleInSymbol == sps) {
+            m_sampleInSymbol = 0;
+        }
+    }
+
+    SimdKernels::clamp(output, numSamples, -32768.0, 32767.0);
+}
+
+void Modulator::designFilter()
+{
+    const int sps = m_samplesPerSymbol;
+    const int length = m_filterSpan * sps;
+    m_taps.resize(length);
+
+    // 滤波器居中放置, 归一化为直流增益1 (恒定符号序列输出恒定幅度)
+    double sum = 0.0;
+    for (int j = 0; j < length; ++j) {
+        double t = (j - (length - 1) / 2.0) / sps;
+        m_taps[j] = rootRaisedCosine(t, m_rollOff);
+        sum += m_taps[j];
+    }
+    for (int j = 0; j < length; ++j) {
+        m_taps[j] *= sps / sum;
+    }
+
+    if (m_historyI.size() != m_filterSpan) {
+        m_historyI = QVector<double>(m_filterSpan, 0.0);
+        m_historyQ = QVector<double>(m_filterSpan, 0.0);
+        m_historyPos = 0;
+    }
+    m_sampleInSymbol = 0;
+}
+
+int Modulator::nextBit()
+{
+    if (m_bitSource == CustomBits) {
+        if (m_customBits.isEmpty()) {
+            return 0;
+        }
+        int bit = m_customBits[m_customPos] & 1;
+        m_customPos = (m_customPos + 1) % m_customBits.size();
+        return bit;
+    }
+
+    // 斐波那契LFSR, 反馈抽头取自 ITU-T O.150
+    const int order = m_bitSource;
+    const int tap = order == PRBS7 ? 6 :
+                    order == PRBS9 ? 5 :
+                    order == PRBS15 ? 14 :
+                    order == PRBS23 ? 18 : 28;
+    const quint32 mask = (1u << order) - 1;
+    quint32 bit = ((m_lfsr >> (order - 1)) ^ (m_lfsr >> (tap - 1))) & 1u;
+    m_lfsr = ((m_lfsr << 1) | bit) & mask;
+    return static_cast<int>(bit);
+}
+
+void Modulator::nextSymbol(double &i, double &q)
+{
+    switch (m_scheme) {
+        case QPSK: {
+            int b0 = nextBit();
+            int b1 = nextBit();
+            i = (1 - 2 * b0) * QPSK_SCALE;
+            q = (1 - 2 * b1) * QPSK_SCALE;
+            break;
+        }
+        case QAM16: {
+            // 每个分量2比特格雷码: 00 -> -3, 01 -> -1, 11 -> +1, 10 -> +3
+            int b0 = nextBit();
+            int b1 = nextBit();
+            int b2 = nextBit();
+            int b3 = nextBit();
+            i = (b0 ? 1 : -1) * (b1 ? 1 : 3) * QAM16_SCALE;
+            q = (b2 ? 1 : -1) * (b3 ? 1 : 3) * QAM16_SCALE;
+            break;
+        }
+        default:
+            i = 1 - 2 * nextBit();
+            q = 0.0;
+            break;
+    }
+}
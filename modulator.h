@@ -0,0 +1,102 @@
+#ifndef MODULATOR_H
+#define MODULATOR_H
+
+#include <QVector>
+
+// 数字调制信号源 (AM / FM / BPSK / QPSK / 16-QAM)
+// 比特来自PRBS序列或循环播放的自定义比特序列, 映射成符号后经过根升余弦 (RRC) 成形滤波,
+// 再调制到载波上. 成形滤波器的符号历史, 符号内的样本位置, 比特源和载波相位都在块之间保持,
+// 可以按流模式无限长地连续输出.
+class Modulator
+{
+public:
+    enum Scheme {
+        AM,         // 成形后的双极性比特流做幅度调制
+        FM,         // 成形后的双极性比特流做频率调制
+        BPSK,
+        QPSK,       // 格雷码
+        QAM16       // 格雷码, 平均功率归一化为1
+    };
+
+    // PRBS阶数 (ITU-T O.150 多项式), 0 表示使用自定义比特序列
+    enum BitSource {
+        CustomBits = 0,
+        PRBS7 = 7,
+        PRBS9 = 9,
+        PRBS15 = 15,
+        PRBS23 = 23,
+        PRBS31 = 31
+    };
+
+    Modulator();
+
+    void setScheme(Scheme scheme);
+    Scheme getScheme() const;
+
+    // 载波频率和采样率, 每个符号的样本数 = round(samplingRate / symbolRate)
+    void setCarrier(double frequency, double samplingRate);
+    void setSymbolRate(double symbolRate);
+    double getSymbolRate() const;   // 取整后实际使用的符号率
+    int getSamplesPerSymbol() const;
+
+    void setBitSource(BitSource source);
+    BitSource getBitSource() const;
+    void setCustomBits(const QVector<quint8> &bits);
+    // 比特源从序列中的另一个位置继续: PRBS 寄存器置为 state 的低位 (为0时置为全1),
+    // 自定义比特从第 state % 长度 个开始. reset() 会回到序列开头
+    void setBitSourceState(quint64 state);
+
+    // 根升余弦滤波器滚降系数 (0, 1] 和长度 (符号数)
+    void setRollOff(double rollOff);
+    double getRollOff() const;
+    void setFilterSpan(int symbols);
+    int getFilterSpan() const;
+    // 成形滤波器系数 (长度 span * sps, 对称), 接收端可直接用作匹配滤波器
+    QVector<double> getFilterTaps() const;
+
+    // AM调制深度 (0, 1], FM频偏 (Hz, 生成时限制在当前采样率的1/4以内)
+    void setModulationIndex(double index);
+    void setFrequencyDeviation(double deviation);
+
+    // 比特源, 滤波器和载波回到初始状态
+    void reset();
+
+    // 输出 amplitude * 已调信号 + offset, 限制在16位有符号整数范围内
+    void generate(double *output, int numSamples, double amplitude, double offset);
+
+    static int bitsPerSymbol(Scheme scheme);
+
+private:
+    void designFilter();
+    int nextBit();
+    void nextSymbol(double &i, double &q);
+
+    Scheme m_scheme;
+    double m_samplingRate;
+    double m_symbolRate;
+    int m_samplesPerSymbol;
+
+    // 比特源
+    BitSource m_bitSource;
+    quint32 m_lfsr;
+    QVector<quint8> m_customBits;
+    int m_customPos;
+
+    // 成形滤波器: m_taps[k * sps + p] 为第 k 个历史符号在符号内第 p 个样本上的系数
+    double m_rollOff;
+    int m_filterSpan;
+    QVector<double> m_taps;
+    QVector<double> m_historyI;     // 环形缓冲区, m_historyPos 为最新的符号
+    QVector<double> m_historyQ;
+    int m_historyPos;
+    int m_sampleInSymbol;
+
+    // 载波
+    quint64 m_carrierPhase;
+    quint64 m_carrierIncrement;
+    double m_carrierFrequency;
+    double m_modulationIndex;
+    double m_frequencyDeviation;
+};
+
+#endif // MODULATOR_H
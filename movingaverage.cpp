@@ -0,0 +1,129 @@
+#include "movingaverage.h"
+
+#include <QtGlobal>
+#include <cstring>
+
+MovingAverage::MovingAverage() :
+    m_length(1)
+{
+    setOrder(1);
+}
+
+void MovingAverage::setLength(int length)
+{
+    length = qMax(length, 1);
+    if (length == m_length) {
+        return;
+    }
+
+    const int oldHistory = m_length - 1;
+    const int history = length - 1;
+    for (Stage &stage : m_stages) {
+        if (history > oldHistory) {
+            stage.history.insert(0, history - oldHistory, 0.0);
+        } else {
+            stage.history.remove(0, oldHistory - history);
+        }
+        // 下一块开始时重新求和
+        stage.sinceResum = length;
+    }
+    m_length = length;
+}
+
+int MovingAverage::getLength() const
+{
+    return m_length;
+}
+
+void MovingAverage::setOrder(int order)
+{
+    m_stages.resize(qBound(1, order, MAX_ORDER));
+    reset();
+}
+
+int MovingAverage::getOrder() const
+{
+    return m_stages.size();
+}
+
+void MovingAverage::reset()
+{
+    for (Stage &stage : m_stages) {
+        stage.history.fill(0.0, m_length - 1);
+        stage.sum = 0.0;
+        stage.sinceResum = 0;
+    }
+}
+
+void MovingAverage::saveState(QVector<double> &state) const
+{
+    // 每级: 历史样本, 和, 上次重新求和之后的样本数
+    const int history = m_length - 1;
+    state.resize(m_stages.size() * (history + 2));
+    double *data = state.data();
+    for (const Stage &stage : m_stages) {
+        std::memcpy(data, stage.history.constData(), sizeof(double) * history);
+        data[history] = stage.sum;
+        data[history + 1] = static_cast<double>(stage.sinceResum);
+        data += history + 2;
+    }
+}
+
+void MovingAverage::restoreState(const QVector<double> &state)
+{
+    const int history = m_length - 1;
+    if (state.size() != m_stages.size() * (history + 2)) {
+        reset();
+        return;
+    }
+    const double *data = state.constData();
+    for (Stage &stage : m_stages) {
+        std::memcpy(stage.history.data(), data, sizeof(double) * history);
+        stage.sum = data[history];
+        stage.sinceResum = static_cast<qint64>(data[history + 1]);
+        data += history + 2;
+    }
+}
+
+void MovingAverage::process(const double *input, double *output, int numSamples)
+{
+    if (numSamples <= 0) {
+        return;
+    }
+
+    // 第一级从 input 读, 之后各级在 output 上原地进行
+    processStage(m_stages[0], input, output, numSamples);
+    for (int s = 1; s < m_stages.size(); ++s) {
+        processStage(m_stages[s], output, output, numSamples);
+    }
+}
+
+void MovingAverage::processStage(Stage &stage, const double *input, double *output, int numSamples)
+{
+    const int history = m_length - 1;
+    m_buffer.resize(history + numSamples);
+    double *buffer = m_buffer.data();
+    std::memcpy(buffer, stage.history.constData(), sizeof(double) * history);
+    std::memcpy(buffer + history, input, sizeof(double) * numSamples);
+
+    double sum = stage.sum;
+    if (stage.sinceResum >= m_length) {
+        sum = 0.0;
+        for (int i = 0; i < history; ++i) {
+            sum += buffer[i];
+        }
+        stage.sinceResum = 0;
+    }
+
+    // 窗口 [i, i + W - 1] 对应第 i 个输出
+    const double scale = 1.0 / m_length;
+    for (int i = 0; i < numSamples; ++i) {
+        sum += buffer[history + i];
+        output[i] = sum * scale;
+        sum -= buffer[i];
+    }
+
+    stage.sum = sum;
+    stage.sinceResum += numSamples;
+    std::memcpy(stage.history.data(), buffer + numSamples, sizeof(double) * history);
+}
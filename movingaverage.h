@@ -0,0 +1,48 @@
+#ifndef MOVINGAVERAGE_H
+#define MOVINGAVERAGE_H
+
+#include <QVector>
+
+// 流式滑动平均 (盒式) 滤波器及其级联
+// 每级 y[n] = (x[n] + x[n-1] + ... + x[n-W+1]) / W, 用滑动和实现: 每个样本一次加一次减, 开销与窗口长度 W 无关.
+// order 级级联即不抽取的 CIC 滤波器 (积分-梳状), 增益已归一化为1, 第一旁瓣衰减约 13.3 * order dB.
+// 每级保存最近 W-1 个输入, 数据可以按任意长度分块连续送入; 每处理 W 个样本重新对历史求一次和,
+// 消除滑动和累积的舍入误差, 平均到每个样本仍是 O(1).
+class MovingAverage
+{
+public:
+    MovingAverage();
+
+    // 改变窗口长度时保留历史样本 (长度增加时更早的样本视为0)
+    void setLength(int length);
+    int getLength() const;
+    // 级数 1..MAX_ORDER, 改变时清空状态
+    void setOrder(int order);
+    int getOrder() const;
+
+    // 清空历史 (之前的输入视为0)
+    void reset();
+    // 状态快照 (与当前设计对应), 写入 state 时复用它的内存; 恢复时长度不符 (设计已改变) 则清空状态
+    void saveState(QVector<double> &state) const;
+    void restoreState(const QVector<double> &state);
+
+    // output 可以与 input 相同
+    void process(const double *input, double *output, int numSamples);
+
+    static const int MAX_ORDER = 8;
+
+private:
+    struct Stage {
+        QVector<double> history;    // 最近 W-1 个输入
+        double sum;                 // history 之和
+        qint64 sinceResum;          // 上次重新求和之后处理的样本数
+    };
+
+    void processStage(Stage &stage, const double *input, double *output, int numSamples);
+
+    int m_length;
+    QVector<Stage> m_stages;
+    QVector<double> m_buffer;       // [历史 | 当前块]
+};
+
+#endif // MOVINGAVERAGE_H
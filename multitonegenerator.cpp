@@ -0,0 +1,310 @@
+#include "multitonegenerator.h"
+
+#include "nco.h"
+#include "simdkernels.h"
+
+#include <QStringList>
+#include <QtMath>
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+// 频率是否为 0.001 Hz 的整数倍, 是则返回以毫赫兹为单位的整数值
+static bool toMillihertz(double frequency, qint64 &millihertz)
+{
+    double scaled = frequency * 1000.0;
+    if (!(std::fabs(scaled) < 1e15)) {
+        return false;
+    }
+    millihertz = std::llround(scaled);
+    return std::fabs(scaled - millihertz) < 1e-6;
+}
+
+MultiToneGenerator::MultiToneGenerator() :
+    m_samplingRate(1000.0),
+    m_sampleIndex(0),
+    m_periodPending(false),
+    m_chirpStart(0.0),
+    m_chirpStop(0.0),
+    m_chirpDuration(1.0),
+    m_chirpAmplitude(0.0),
+    m_chirpPhase(0.0),
+    m_chirpSample(0),
+    m_noiseAmplitude(0.0)
+{
+}
+
+void MultiToneGenerator::setSamplingRate(double samplingRate)
+{
+    // 采样率不变时保留周期表 (例如只修改了其他信号源的频率)
+    if (samplingRate == m_samplingRate) {
+        return;
+    }
+    m_samplingRate = samplingRate;
+    updateTones();
+}
+
+double MultiToneGenerator::getSamplingRate() const
+{
+    return m_samplingRate;
+}
+
+void MultiToneGenerator::setTones(const QVector<Tone> &tones)
+{
+    m_tones = tones;
+    updateTones();
+}
+
+QVector<MultiToneGenerator::Tone> MultiToneGenerator::getTones() const
+{
+    return m_tones;
+}
+
+void MultiToneGenerator::setChirp(double startFrequency, double stopFrequency, double duration, double amplitude)
+{
+    m_chirpStart = startFrequency;
+    m_chirpStop = stopFrequency;
+    m_chirpDuration = duration > 0.0 ? duration : 1.0;
+    m_chirpAmplitude = amplitude;
+    m_chirpSample = 0;
+}
+
+bool MultiToneGenerator::isChirpEnabled() const
+{
+    return m_chirpAmplitude != 0.0;
+}
+
+void MultiToneGenerator::setNoiseAmplitude(double amplitude)
+{
+    m_noiseAmplitude = qMax(0.0, amplitude);
+}
+
+double MultiToneGenerator::getNoiseAmplitude() const
+{
+    return m_noiseAmplitude;
+}
+
+void MultiToneGenerator::reset()
+{
+    m_sampleIndex = 0;
+    m_chirpPhase = 0.0;
+    m_chirpSample = 0;
+}
+
+bool MultiToneGenerator::isPeriodic() const
+{
+    return !m_period.isEmpty();
+}
+
+bool MultiToneGenerator::isPeriodTablePending() const
+{
+    return m_periodPending;
+}
+
+QVector<double> MultiToneGenerator::buildPeriodTable(const QVector<Tone> &tones, double samplingRate)
+{
+    const int period = periodLength(tones, samplingRate);
+    if (period == 0) {
+        return QVector<double>();
+    }
+
+    // 用独立的振荡器组从时间0开始合成一个周期
+    MultiToneGenerator generator;
+    generator.m_samplingRate = samplingRate;
+    generator.m_tones = tones;
+    generator.updateTones();
+
+    QVector<double> table(period, 0.0);
+    generator.beginTones(0);
+    for (int start = 0; start < table.size(); start += TILE_SIZE) {
+        generator.accumulateTones(table.data() + start, qMin(TILE_SIZE, table.size() - start));
+    }
+    return table;
+}
+
+bool MultiToneGenerator::setPeriodTable(const QVector<Tone> &tones, double samplingRate,
+                                        const QVector<double> &table)
+{
+    if (samplingRate != m_samplingRate || tones.size() != m_tones.size()) {
+        return false;
+    }
+    for (int k = 0; k < tones.size(); ++k) {
+        if (tones[k].frequency != m_tones[k].frequency || tones[k].amplitude != m_tones[k].amplitude ||
+                tones[k].phase != m_tones[k].phase) {
+            return false;
+        }
+    }
+
+    // 周期表从时间0开始, copyFromPeriod 按当前时间取模, 与振荡器组的输出连续
+    m_period = table;
+    m_periodPending = false;
+    return true;
+}
+
+void MultiToneGenerator::generate(double *output, int numSamples, double offset)
+{
+    if (m_period.isEmpty()) {
+        beginTones(m_sampleIndex);
+    }
+
+    for (int start = 0; start < numSamples; start += TILE_SIZE) {
+        double *tile = output + start;
+        const int count = qMin(TILE_SIZE, numSamples - start);
+
+        if (m_period.isEmpty()) {
+            std::fill(tile, tile + count, offset);
+            accumulateTones(tile, count);
+        } else {
+            copyFromPeriod(tile, count);
+            if (offset != 0.0) {
+                for (int i = 0; i < count; ++i) {
+                    tile[i] += offset;
+                }
+            }
+        }
+        m_sampleIndex += count;
+
+        if (m_chirpAmplitude != 0.0) {
+            addChirp(tile, count);
+        }
+        if (m_noiseAmplitude > 0.0) {
+            addNoise(tile, count);
+        }
+        SimdKernels::clamp(tile, count, -32768.0, 32767.0);
+    }
+}
+
+bool MultiToneGenerator::parseTones(const QString &text, QVector<Tone> &tones)
+{
+    QVector<Tone> parsed;
+    QString normalized = text;
+    normalized.replace(";", ",").replace("\n", ",");
+
+    const QStringList entries = normalized.split(',');
+    for (const QString &entry : entries) {
+        if (entry.trimmed().isEmpty()) {
+            continue;
+        }
+
+        const QStringList fields = entry.trimmed().split(':');
+        if (fields.size() < 2 || fields.size() > 3) {
+            return false;
+        }
+
+        bool ok[3] = {true, true, true};
+        Tone tone;
+        tone.frequency = fields[0].trimmed().toDouble(&ok[0]);
+        tone.amplitude = fields[1].trimmed().toDouble(&ok[1]);
+        tone.phase = fields.size() == 3 ? fields[2].trimmed().toDouble(&ok[2]) : 0.0;
+        if (!ok[0] || !ok[1] || !ok[2]) {
+            return false;
+        }
+        parsed.append(tone);
+    }
+
+    tones = parsed;
+    return true;
+}
+
+void MultiToneGenerator::updateTones()
+{
+    const int toneCount = m_tones.size();
+    m_phaseOffsets.resize(toneCount);
+    m_phaseIncrements.resize(toneCount);
+    m_stepRe.resize(toneCount);
+    m_stepIm.resize(toneCount);
+    m_toneRe.resize(toneCount);
+    m_toneIm.resize(toneCount);
+
+    for (int k = 0; k < toneCount; ++k) {
+        const Tone &tone = m_tones[k];
+        m_phaseOffsets[k] = cyclesToPhase(tone.phase / 360.0);
+        m_phaseIncrements[k] = cyclesToPhase(tone.frequency / m_samplingRate);
+
+        const double step = phaseToRadians(m_phaseIncrements[k]);
+        m_stepRe[k] = std::cos(step);
+        m_stepIm[k] = std::sin(step);
+    }
+
+    m_period.clear();
+    m_periodPending = true;
+}
+
+int MultiToneGenerator::periodLength(const QVector<Tone> &tones, double samplingRate)
+{
+    // 查找公共周期: P = fs / gcd(fs, f1, f2, ...), 以毫赫兹为单位计算
+    qint64 fsMillihertz = 0;
+    if (tones.isEmpty() || !toMillihertz(samplingRate, fsMillihertz) || fsMillihertz <= 0) {
+        return 0;
+    }
+
+    qint64 divisor = fsMillihertz;
+    for (const Tone &tone : tones) {
+        qint64 millihertz = 0;
+        if (!toMillihertz(tone.frequency, millihertz)) {
+            return 0;
+        }
+        divisor = std::gcd(divisor, millihertz < 0 ? -millihertz : millihertz);
+    }
+
+    const qint64 period = fsMillihertz / divisor;
+    return period > MAX_PERIOD ? 0 : static_cast<int>(period);
+}
+
+void MultiToneGenerator::beginTones(qint64 startIndex)
+{
+    // z = A * e^(j(angle - pi/2)), 实部即 A * sin(angle)
+    for (int k = 0; k < m_tones.size(); ++k) {
+        const quint64 phase = m_phaseOffsets[k] + static_cast<quint64>(startIndex) * m_phaseIncrements[k];
+        const double angle = phaseToRadians(phase);
+        m_toneRe[k] = m_tones[k].amplitude * std::sin(angle);
+        m_toneIm[k] = -m_tones[k].amplitude * std::cos(angle);
+    }
+}
+
+void MultiToneGenerator::accumulateTones(double *output, int numSamples)
+{
+    for (int k = 0; k < m_tones.size(); ++k) {
+        SimdKernels::accumulateTone(m_toneRe[k], m_toneIm[k], m_stepRe[k], m_stepIm[k],
+                                    output, numSamples);
+    }
+}
+
+void MultiToneGenerator::copyFromPeriod(double *output, int numSamples)
+{
+    const int period = m_period.size();
+    int position = static_cast<int>(m_sampleIndex % period);
+    int written = 0;
+    while (written < numSamples) {
+        const int count = qMin(numSamples - written, period - position);
+        std::memcpy(output + written, m_period.constData() + position, sizeof(double) * count);
+        written += count;
+        position = 0;
+    }
+}
+
+void MultiToneGenerator::addChirp(double *output, int numSamples)
+{
+    // 瞬时频率在一次扫频内线性变化, 相位连续累加
+    const qint64 sweepLength = qMax<qint64>(1, std::llround(m_chirpDuration * m_samplingRate));
+    const double startStep = m_chirpStart / m_samplingRate;
+    const double slope = (m_chirpStop - m_chirpStart) / m_samplingRate / sweepLength;
+
+    for (int i = 0; i < numSamples; ++i) {
+        output[i] += m_chirpAmplitude * std::sin(2.0 * M_PI * m_chirpPhase);
+
+        m_chirpPhase += startStep + slope * m_chirpSample;
+        m_chirpPhase -= std::floor(m_chirpPhase);
+        if (++m_chirpSample >= sweepLength) {
+            m_chirpSample = 0;
+        }
+    }
+}
+
+// 每次最多处理一块 (TILE_SIZE 个样本)
+void MultiToneGenerator::addNoise(double *output, int numSamples)
+{
+    double noise[TILE_SIZE];
+    m_noise.generate(noise, numSamples);
+    SimdKernels::addScaledNoise(output, noise, m_noiseAmplitude, output, numSamples);
+}
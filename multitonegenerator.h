@@ -0,0 +1,100 @@
+#ifndef MULTITONEGENERATOR_H
+#define MULTITONEGENERATOR_H
+
+#include <QString>
+#include <QVector>
+
+#include "gaussiannoise.h"
+
+// 多音复合信号合成器: N 个单音 + 可选线性扫频 + 可选高斯噪声
+// 单音用复数旋转因子递推 (每个样本几次乘加, 不计算正弦), 每次 generate() 的起点由样本序号算出.
+// 所有单音频率 (以及采样率) 都是 0.001 Hz 的整数倍且公共周期不超过 MAX_PERIOD 时,
+// 预先合成一个完整周期, 之后按周期表输出, 每个样本的开销与单音数量无关.
+// 合成周期表的计算量可达 MAX_PERIOD * 单音数, 不在设置函数中进行: 修改单音或采样率后先用振荡器组输出
+// (结果相同, 只是较慢), 调用者在锁外用 buildPeriodTable() 合成后通过 setPeriodTable() 装入.
+class MultiToneGenerator
+{
+public:
+    struct Tone {
+        double frequency;   // Hz
+        double amplitude;
+        double phase;       // 初相位 (度)
+    };
+
+    MultiToneGenerator();
+
+    void setSamplingRate(double samplingRate);
+    double getSamplingRate() const;
+
+    void setTones(const QVector<Tone> &tones);
+    QVector<Tone> getTones() const;
+
+    // 线性扫频: duration 秒内从 startFrequency 扫到 stopFrequency 后重新开始, amplitude 为0时关闭
+    void setChirp(double startFrequency, double stopFrequency, double duration, double amplitude);
+    bool isChirpEnabled() const;
+
+    // 高斯噪声的标准差, 0表示不加噪声
+    void setNoiseAmplitude(double amplitude);
+    double getNoiseAmplitude() const;
+
+    // 时间回到0
+    void reset();
+
+    // 生成下一个数据块, 结果加上 offset 后限制在16位有符号整数范围内
+    void generate(double *output, int numSamples, double offset);
+
+    // 是否正在使用周期表
+    bool isPeriodic() const;
+    // 修改单音或采样率后还没有装入周期表
+    bool isPeriodTablePending() const;
+
+    // 合成一个公共周期的单音之和, 不满足条件 (频率不是 0.001 Hz 的整数倍或周期太长) 时返回空表.
+    // 不访问任何对象, 可以在任意线程中调用
+    static QVector<double> buildPeriodTable(const QVector<Tone> &tones, double samplingRate);
+    // 装入 buildPeriodTable(tones, samplingRate) 的结果; 单音或采样率已经被修改时不装入, 返回 false
+    bool setPeriodTable(const QVector<Tone> &tones, double samplingRate, const QVector<double> &table);
+
+    // 解析 "频率:幅度[:相位], ..." 形式的单音列表, 分隔符可以是逗号, 分号或换行
+    static bool parseTones(const QString &text, QVector<Tone> &tones);
+
+    static const int TILE_SIZE = 512;
+    static const int MAX_PERIOD = 1 << 20;
+
+private:
+    // 重新计算各单音的相位增量和旋转因子, 周期表失效
+    void updateTones();
+    // 公共周期的样本数, 没有或超过 MAX_PERIOD 时返回0
+    static int periodLength(const QVector<Tone> &tones, double samplingRate);
+    void beginTones(qint64 startIndex);
+    void accumulateTones(double *output, int numSamples);
+    void copyFromPeriod(double *output, int numSamples);
+    void addChirp(double *output, int numSamples);
+    void addNoise(double *output, int numSamples);
+
+    double m_samplingRate;
+    QVector<Tone> m_tones;
+    qint64 m_sampleIndex;       // 当前块第一个样本的时间 (样本数)
+
+    // 每个单音的整数相位 (2^64 对应一个周期) 与旋转因子
+    QVector<quint64> m_phaseOffsets;
+    QVector<quint64> m_phaseIncrements;
+    QVector<double> m_stepRe;
+    QVector<double> m_stepIm;
+    QVector<double> m_toneRe;
+    QVector<double> m_toneIm;
+
+    QVector<double> m_period;   // 一个公共周期的单音之和, 为空时使用振荡器组
+    bool m_periodPending;       // 当前单音和采样率的周期表还没有装入
+
+    double m_chirpStart;
+    double m_chirpStop;
+    double m_chirpDuration;
+    double m_chirpAmplitude;
+    double m_chirpPhase;        // 周期
+    qint64 m_chirpSample;       // 当前扫频内的样本序号
+
+    double m_noiseAmplitude;
+    GaussianNoise m_noise;
+};
+
+#endif // MULTITONEGENERATOR_H
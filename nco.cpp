@@ -0,0 +1,79 @@
+#include "nco.h"
+
+#include "simdkernels.h"
+
+#include <QtMath>
+
+Nco::Nco() :
+    m_phase(0),
+    m_phaseIncrement(0),
+    m_bandLimited(false)
+{
+}
+
+void Nco::setFrequency(double frequency, double samplingRate)
+{
+    // 高于采样率的频率按混叠后的结果处理
+    m_phaseIncrement = cyclesToPhase(frequency / samplingRate);
+}
+
+double Nco::getFrequencyRatio() const
+{
+    return m_phaseIncrement / PHASE_SCALE;
+}
+
+void Nco::setPhase(double cycles)
+{
+    m_phase = cyclesToPhase(cycles);
+}
+
+double Nco::getPhase() const
+{
+    return m_phase / PHASE_SCALE;
+}
+
+void Nco::reset()
+{
+    m_phase = 0;
+}
+
+void Nco::setBandLimited(bool enabled)
+{
+    m_bandLimited = enabled;
+}
+
+bool Nco::isBandLimited() const
+{
+    return m_bandLimited;
+}
+
+void Nco::generate(Waveform waveform, double *output, int numSamples, double amplitude, double offset)
+{
+    // 内核按当前CPU支持的指令集分发, 并推进相位累加器
+    switch (waveform) {
+        case Sine:
+            SimdKernels::generateSine(m_phase, m_phaseIncrement, amplitude, offset, output, numSamples);
+            break;
+        case Square:
+            if (m_bandLimited) {
+                SimdKernels::generateSquareBandLimited(m_phase, m_phaseIncrement, amplitude, offset, output, numSamples);
+            } else {
+                SimdKernels::generateSquare(m_phase, m_phaseIncrement, amplitude, offset, output, numSamples);
+            }
+            break;
+        case Triangle:
+            if (m_bandLimited) {
+                SimdKernels::generateTriangleBandLimited(m_phase, m_phaseIncrement, amplitude, offset, output, numSamples);
+            } else {
+                SimdKernels::generateTriangle(m_phase, m_phaseIncrement, amplitude, offset, output, numSamples);
+            }
+            break;
+        case Sawtooth:
+            if (m_bandLimited) {
+                SimdKernels::generateSawtoothBandLimited(m_phase, m_phaseIncrement, amplitude, offset, output, numSamples);
+            } else {
+                SimdKernels::generateSawtooth(m_phase, m_phaseIncrement, amplitude, offset, output, numSamples);
+            }
+            break;
+    }
+}
@@ -0,0 +1,62 @@
+#ifndef NCO_H
+#define NCO_H
+
+#include <QtGlobal>
+#include <QtMath>
+
+// 64位相位累加器: 相位 = 周期 * 2^64, 整数加法自然回绕. 各振荡器和向量内核共用下面的换算
+static const double PHASE_SCALE = 18446744073709551616.0; // 2^64
+
+// 任意周期数先折叠到 [0, 1) 再换算; NaN 和无穷大得到0
+inline quint64 cyclesToPhase(double cycles)
+{
+    cycles -= std::floor(cycles);
+    const double phase = cycles * PHASE_SCALE;
+    return phase >= 0.0 && phase < PHASE_SCALE ? static_cast<quint64>(phase) : 0;
+}
+
+// 64位相位按有符号数解释为 [-0.5, 0.5) 周期后换算成弧度, 保留全部精度
+inline double phaseToRadians(quint64 phase)
+{
+    return static_cast<qint64>(phase) * (2.0 * M_PI / PHASE_SCALE);
+}
+
+// 数控振荡器 (NCO)
+// 使用64位整数相位累加器, 相位每个样本只做一次整数加法并自然回绕,
+// 不会像 i * timeStep 那样随样本数增大而丢失精度, 可以长时间连续运行.
+// 所有波形共享同一个累加器, 切换波形时相位保持连续.
+class Nco
+{
+public:
+    enum Waveform {
+        Sine,       // 正弦波
+        Square,     // 方波
+        Triangle,   // 三角波
+        Sawtooth    // 锯齿波
+    };
+
+    Nco();
+
+    // 设置输出频率, 相位增量 = frequency / samplingRate * 2^64
+    void setFrequency(double frequency, double samplingRate);
+    double getFrequencyRatio() const;
+
+    // 相位以周期为单位, 范围 [0, 1)
+    void setPhase(double cycles);
+    double getPhase() const;
+    void reset();
+
+    // 带限模式: 方波, 三角波, 锯齿波使用 PolyBLEP/PolyBLAMP 修正, 直接在目标采样率下抗混叠
+    void setBandLimited(bool enabled);
+    bool isBandLimited() const;
+
+    // 生成 amplitude * waveform + offset, 结果限制在16位有符号整数范围内
+    void generate(Waveform waveform, double *output, int numSamples, double amplitude, double offset);
+
+private:
+    quint64 m_phase;
+    quint64 m_phaseIncrement;
+    bool m_bandLimited;
+};
+
+#endif // NCO_H
@@ -1,4 +1,91 @@
 #include "oscilloscope.h"
+#include "simdkernels.h"
+
+#include <algorithm>
+
+// 查找触发点 (上升沿), 没有触发或自动模式返回 -1, double 和 16位定点通道共用
+template <typename T>
+static int findTrigger(const T *data, int numSamples, Oscilloscope::TriggerMode triggerMode, double triggerLevel)
+{
+    if (triggerMode == Oscilloscope::AUTO) {
+        return -1;
+    }
+    
+    for (int i = 1; i < numSamples; ++i) {
+        // 上升沿触发
+        if (data[i-1] < triggerLevel && 
+            data[i] >= triggerLevel) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// 按触发点重排后存入通道: 从触发点开始的数据在前, 剩余的数据补在后面, 一次拷贝完成
+template <typename T>
+static void storeChannel(QVector<T> &channel, const T *data, int numSamples, int triggerIndex)
+{
+    channel.resize(numSamples);
+    T *output = channel.data();
+    if (triggerIndex > 0) {
+        output = std::copy(data + triggerIndex, data + numSamples, output);
+        std::copy(data, data + triggerIndex, output);
+    } else {
+        std::copy(data, data + numSamples, output);
+    }
+}
+
+// 用于处理两个通道的时间同步
+template <typename T>
+static void alignSignals(const QVector<T> &channel0, QVector<T> &channel1)
+{
+    // 只有当两个通道都有足够的数据时才进行同步
+    if (channel0.size() < 10 || channel1.size() < 10) {
+        return;
+    }
+    
+    // 为了简化，我们假设两个通道的采样率相同，
+    // 只是通过简单地对齐起始点来同步
+    
+    // 寻找两个信号中的第一个显著特征点（例如，最大值位置）
+    int maxIndex0 = 0;
+    int maxIndex1 = 0;
+    T maxVal0 = channel0[0];
+    T maxVal1 = channel1[0];
+    
+    for (int i = 1; i < qMin(channel0.size(), channel1.size()); ++i) {
+        if (channel0[i] > maxVal0) {
+            maxVal0 = channel0[i];
+            maxIndex0 = i;
+        }
+        
+        if (channel1[i] > maxVal1) {
+            maxVal1 = channel1[i];
+            maxIndex1 = i;
+        }
+    }
+    
+    // 计算偏移量
+    int offset = maxIndex1 - maxIndex0;
+    
+    // 如果偏移量显著，则原地平移第二个通道的数据, 空出的部分用零填充
+    if (qAbs(offset) > 5) {
+        T *data = channel1.data();
+        const int size = channel1.size();
+        offset = qBound(-size, offset, size);
+        
+        if (offset > 0) {
+            // 第二个通道需要向左移动
+            std::copy(data + offset, data + size, data);
+            std::fill(data + size - offset, data + size, T(0));
+        } else {
+            // 第二个通道需要向右移动
+            offset = -offset;
+            std::copy_backward(data, data + size - offset, data + size);
+            std::fill(data, data + offset, T(0));
+        }
+    }
+}
 
 Oscilloscope::Oscilloscope(QObject *parent) : QObject(parent),
     m_timePerDiv(0.1),
@@ -8,6 +95,7 @@ Oscilloscope::Oscilloscope(QObject *parent) : QObject(parent),
 {
     // 初始化两个通道
     m_channelData.resize(2);
+    m_channelData16.resize(2);
     m_voltPerDiv.resize(2);
     m_voltPerDiv[0] = 1.0;
     m_voltPerDiv[1] = 1.0;
@@ -75,6 +163,9 @@ void Oscilloscope::startOscilloscope()
             if (!m_channelData[i].isEmpty()) {
                 emit dataUpdated(i, m_channelData[i]);
             }
+            if (!m_channelData16[i].isEmpty()) {
+                emit dataUpdated16(i, m_channelData16[i]);
+            }
         }
         emit timeAxisUpdated(m_timeAxis);
     }
@@ -93,7 +184,12 @@ QVector<double> Oscilloscope::getChannelData(int channel) const
     
     QVector<double> result;
     m_mutex.lock();
-    result = m_channelData[channel];
+    if (!m_channelData16[channel].isEmpty()) {
+        result.resize(m_channelData16[channel].size());
+        SimdKernels::convertFromInt16(m_channelData16[channel].constData(), result.data(), result.size());
+    } else {
+        result = m_channelData[channel];
+    }
     m_mutex.unlock();
     return result;
 }
@@ -115,67 +211,104 @@ void Oscilloscope::onSignalReceived(int channel, const QVector<double> &data)
     
     m_mutex.lock();
     
-    // 存储通道数据
-    m_channelData[channel] = data;
+    // 复制到本通道的缓冲区, 不持有发送方的数据 (例如 GeneratorWorker 轮转使用的块)
+    const int triggerIndex = findTrigger(data.constData(), data.size(), m_triggerMode, m_triggerLevel);
+    storeChannel(m_channelData[channel], data.constData(), data.size(), triggerIndex);
+    m_channelData16[channel].clear();
+    alignChannels();
     
-    // 处理数据
-    processData(channel);
+    m_mutex.unlock();
     
-    // 如果两个通道都有数据，则处理时间同步
-    if (!m_channelData[0].isEmpty() && !m_channelData[1].isEmpty()) {
-        alignSignals();
+    emitChannel(channel);
+}
+
+void Oscilloscope::onSignalReceived16(int channel, const QVector<qint16> &data)
+{
+    if (channel < 0 || channel >= m_channelData16.size()) {
+        return;
     }
     
-    // 保存数据副本，在mutex外发送信号
-    QVector<double> channelDataCopy = m_channelData[channel];
-    QVector<double> timeAxisCopy = m_timeAxis;
+    m_mutex.lock();
+    
+    // 触发和同步直接在16位样本上进行, 同样复制到本通道的缓冲区
+    const int triggerIndex = findTrigger(data.constData(), data.size(), m_triggerMode, m_triggerLevel);
+    storeChannel(m_channelData16[channel], data.constData(), data.size(), triggerIndex);
+    m_channelData[channel].clear();
+    alignChannels();
     
     m_mutex.unlock();
     
-    // 只有在示波器运行时才发送更新信号
-    if (m_isRunning) {
-        // 发送更新信号
-        emit dataUpdated(channel, channelDataCopy);
-        emit timeAxisUpdated(timeAxisCopy);
+    emitChannel(channel);
+}
+
+void Oscilloscope::onSignalReceived(int channel, const double *data, int numSamples)
+{
+    if (channel < 0 || channel >= m_channelData.size()) {
+        return;
+    }
+    
+    m_mutex.lock();
+    
+    // 存储通道数据, 触发重排在拷贝时完成
+    const int triggerIndex = findTrigger(data, numSamples, m_triggerMode, m_triggerLevel);
+    storeChannel(m_channelData[channel], data, numSamples, triggerIndex);
+    m_channelData16[channel].clear();
+    alignChannels();
+    
+    m_mutex.unlock();
+    
+    emitChannel(channel);
+}
+
+void Oscilloscope::onSignalReceived16(int channel, const qint16 *data, int numSamples)
+{
+    if (channel < 0 || channel >= m_channelData16.size()) {
+        return;
     }
+    
+    m_mutex.lock();
+    
+    const int triggerIndex = findTrigger(data, numSamples, m_triggerMode, m_triggerLevel);
+    storeChannel(m_channelData16[channel], data, numSamples, triggerIndex);
+    m_channelData[channel].clear();
+    alignChannels();
+    
+    m_mutex.unlock();
+    
+    emitChannel(channel);
 }
 
-void Oscilloscope::processData(int channel)
+void Oscilloscope::alignChannels()
 {
-    // 根据触发条件处理数据
-    if (m_channelData[channel].isEmpty()) {
+    // 如果两个通道都有数据，则处理时间同步
+    if (!m_channelData[0].isEmpty() && !m_channelData[1].isEmpty()) {
+        alignSignals(m_channelData[0], m_channelData[1]);
+    }
+    if (!m_channelData16[0].isEmpty() && !m_channelData16[1].isEmpty()) {
+        alignSignals(m_channelData16[0], m_channelData16[1]);
+    }
+}
+
+void Oscilloscope::emitChannel(int channel)
+{
+    // 只有在示波器运行时才发送更新信号
+    if (!m_isRunning) {
         return;
     }
     
-    // 查找触发点
-    int triggerIndex = -1;
+    // 保存数据副本 (隐式共享, 不复制样本)，在mutex外发送信号
+    m_mutex.lock();
+    QVector<double> channelDataCopy = m_channelData[channel];
+    QVector<qint16> channelDataCopy16 = m_channelData16[channel];
+    QVector<double> timeAxisCopy = m_timeAxis;
+    m_mutex.unlock();
     
-    if (m_triggerMode != AUTO) {
-        for (int i = 1; i < m_channelData[channel].size(); ++i) {
-            // 上升沿触发
-            if (m_channelData[channel][i-1] < m_triggerLevel && 
-                m_channelData[channel][i] >= m_triggerLevel) {
-                triggerIndex = i;
-                break;
-            }
-        }
-        
-        // 如果找到触发点，重新排列数据
-        if (triggerIndex > 0) {
-            QVector<double> temp = m_channelData[channel];
-            m_channelData[channel].clear();
-            
-            // 从触发点开始重排数据
-            for (int i = triggerIndex; i < temp.size(); ++i) {
-                m_channelData[channel].append(temp[i]);
-            }
-            
-            // 补充剩余的数据
-            for (int i = 0; i < triggerIndex; ++i) {
-                m_channelData[channel].append(temp[i]);
-            }
-        }
+    if (!channelDataCopy16.isEmpty()) {
+        emit dataUpdated16(channel, channelDataCopy16);
+    } else {
+        emit dataUpdated(channel, channelDataCopy);
     }
+    emit timeAxisUpdated(timeAxisCopy);
 }
 
 void Oscilloscope::updateTimeAxis()
@@ -192,66 +325,3 @@ void Oscilloscope::updateTimeAxis()
         m_timeAxis.append(i * timeStep);
     }
 }
-
-void Oscilloscope::alignSignals()
-{
-    // 只有当两个通道都有足够的数据时才进行同步
-    if (m_channelData[0].size() < 10 || m_channelData[1].size() < 10) {
-        return;
-    }
-    
-    // 为了简化，我们假设两个通道的采样率相同，
-    // 只是通过简单地对齐起始点来同步
-    
-    // 寻找两个信号中的第一个显著特征点（例如，最大值位置）
-    int maxIndex0 = 0;
-    int maxIndex1 = 0;
-    double maxVal0 = m_channelData[0][0];
-    double maxVal1 = m_channelData[1][0];
-    
-    for (int i = 1; i < qMin(m_channelData[0].size(), m_channelData[1].size()); ++i) {
-        if (m_channelData[0][i] > maxVal0) {
-            maxVal0 = m_channelData[0][i];
-            maxIndex0 = i;
-        }
-        
-        if (m_channelData[1][i] > maxVal1) {
-            maxVal1 = m_channelData[1][i];
-            maxIndex1 = i;
-        }
-    }
-    
-    // 计算偏移量
-    int offset = maxIndex1 - maxIndex0;
-    
-    // 如果偏移量显著，则调整第二个通道的数据
-    if (qAbs(offset) > 5) {
-        QVector<double> temp = m_channelData[1];
-        m_channelData[1].clear();
-        
-        if (offset > 0) {
-            // 第二个通道需要向左移动
-            for (int i = offset; i < temp.size(); ++i) {
-                m_channelData[1].append(temp[i]);
-            }
-            
-            // 用零填充末尾
-            for (int i = 0; i < offset; ++i) {
-                m_channelData[1].append(0.0);
-            }
-        } else {
-            // 第二个通道需要向右移动
-            offset = -offset;
-            
-            // 用零填充开头
-            for (int i = 0; i < offset; ++i) {
-                m_channelData[1].append(0.0);
-            }
-            
-            // 添加剩余数据
-            for (int i = 0; i < temp.size() - offset; ++i) {
-                m_channelData[1].append(temp[i]);
-            }
-        }
-    }
-} 
\ No newline at end of file
@@ -33,18 +33,25 @@ public:
     void stopOscilloscope();
     
     // 获取示波器数据
-    QVector<double> getChannelData(int channel) const;
+    QVector<double> getChannelData(int channel) const;  // 16位通道会转换为double
     QVector<double> getTimeAxis() const;
     
+    // 无拷贝版本 (直接调用, 不作为槽连接): 数据按触发点重排的同时复制到通道缓冲区, 只复制一次
+    void onSignalReceived(int channel, const double *data, int numSamples);
+    void onSignalReceived16(int channel, const qint16 *data, int numSamples);
+    
 signals:
     void dataUpdated(int channel, const QVector<double> &data);
+    void dataUpdated16(int channel, const QVector<qint16> &data);
     void timeAxisUpdated(const QVector<double> &timeAxis);
     
 public slots:
     void onSignalReceived(int channel, const QVector<double> &data);
+    void onSignalReceived16(int channel, const QVector<qint16> &data);
     
 private:
     QVector<QVector<double>> m_channelData; // 存储两个通道的数据
+    QVector<QVector<qint16>> m_channelData16; // 16位定点模式下的通道数据
     QVector<double> m_timeAxis;
     
     double m_timePerDiv;
@@ -57,9 +64,9 @@ private:
     QThread m_thread;
     mutable QRecursiveMutex m_mutex;
     
-    void processData(int channel);
     void updateTimeAxis();
-    void alignSignals(); // 用于处理两个通道的时间同步
+    void alignChannels();
+    void emitChannel(int channel);
 };
 
 #endif // OSCILLOSCOPE_H 
\ No newline at end of file
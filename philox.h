@@ -0,0 +1,39 @@
+#ifndef PHILOX_H
+#define PHILOX_H
+
+#include <QtGlobal>
+
+// Philox4x32-10 计数器型随机数发生器 (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3", SC'11)
+// 输出只取决于 64 位密钥和 128 位计数器, 任意位置的随机数都可以直接计算而不需要按顺序推进状态,
+// 因此一段随机序列可以任意分块并行生成, 结果与分块方式和线程数无关.
+// 向量化版本见 simdkernels_p.h, 两者逐位一致.
+namespace Philox {
+
+static const quint32 MULTIPLIER0 = 0xD2511F53u;
+static const quint32 MULTIPLIER1 = 0xCD9E8D57u;
+static const quint32 KEY_STEP0 = 0x9E3779B9u;    // 黄金分割比
+static const quint32 KEY_STEP1 = 0xBB67AE85u;    // sqrt(3) - 1
+static const int ROUNDS = 10;
+
+// block 输入为计数器, 输出为 4 个 32 位随机数
+inline void generate(const quint32 *key, quint32 *block)
+{
+    quint32 k0 = key[0];
+    quint32 k1 = key[1];
+    for (int round = 0; round < ROUNDS; ++round) {
+        const quint64 p0 = static_cast<quint64>(MULTIPLIER0) * block[0];
+        const quint64 p1 = static_cast<quint64>(MULTIPLIER1) * block[2];
+        const quint32 x0 = static_cast<quint32>(p1 >> 32) ^ block[1] ^ k0;
+        const quint32 x2 = static_cast<quint32>(p0 >> 32) ^ block[3] ^ k1;
+        block[0] = x0;
+        block[1] = static_cast<quint32>(p1);
+        block[2] = x2;
+        block[3] = static_cast<quint32>(p0);
+        k0 += KEY_STEP0;
+        k1 += KEY_STEP1;
+    }
+}
+
+} // namespace Philox
+
+#endif // PHILOX_H
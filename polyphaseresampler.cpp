@@ -0,0 +1,123 @@
+#include "polyphaseresampler.h"
+
+#include "firfilter.h"
+#include "simdkernels.h"
+#include "windowfunction.h"
+
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+PolyphaseResampler::PolyphaseResampler() :
+    m_interpolation(1),
+    m_decimation(1),
+    m_tapsPerPhase(1),
+    m_phaseTaps(1, 1.0),
+    m_time(0)
+{
+    reset();
+}
+
+bool PolyphaseResampler::setRatio(int interpolation, int decimation, double passband, double attenuationDb)
+{
+    if (interpolation <= 0 || decimation <= 0 || !(passband > 0.0 && passband < 1.0) ||
+            !(attenuationDb >= 20.0 && attenuationDb <= 200.0)) {
+        return false;
+    }
+    const int divisor = std::gcd(interpolation, decimation);
+    const int l = interpolation / divisor;
+    const int m = decimation / divisor;
+
+    // 原型在 L * fs 上设计: 较低的奈奎斯特频率归一化后为 1 / (2 * max(L, M)), 通带到其 passband 倍,
+    // 阻带从它开始. Kaiser 经验公式 N = (A - 7.95) / (14.36 * 过渡带宽) + 1
+    const double nyquist = 0.5 / qMax(l, m);
+    const double transition = (1.0 - passband) * nyquist;
+    int length = 1;
+    if (l > 1 || m > 1) {
+        const double estimate = std::ceil((attenuationDb - 7.95) / (14.36 * transition)) + 1.0;
+        if (estimate > MAX_PROTOTYPE_LENGTH - l) {
+            return false;
+        }
+        length = static_cast<int>(estimate) | 1;
+    }
+    const int tapsPerPhase = (length + l - 1) / l;
+
+    QVector<double> prototype(1, 1.0);
+    if (length > 1) {
+        const QVector<double> window = WindowFunction::generate(WindowFunction::Kaiser, length,
+                                                                WindowFunction::kaiserBeta(attenuationDb));
+        prototype = FirFilter::lowPassTaps(0.5 * (1.0 + passband) * nyquist, 1.0, length, window);
+    }
+
+    // 子滤波器 p 的第 k 个抽头 (乘 x[n - k]) 为 h[p + k * L], 增益 L 补偿插入的零
+    m_phaseTaps.fill(0.0, l * tapsPerPhase);
+    for (int n = 0; n < prototype.size(); ++n) {
+        const int phase = n % l;
+        const int k = n / l;
+        m_phaseTaps[phase * tapsPerPhase + tapsPerPhase - 1 - k] = prototype[n] * l;
+    }
+
+    m_interpolation = l;
+    m_decimation = m;
+    m_tapsPerPhase = tapsPerPhase;
+    reset();
+    return true;
+}
+
+int PolyphaseResampler::getInterpolation() const
+{
+    return m_interpolation;
+}
+
+int PolyphaseResampler::getDecimation() const
+{
+    return m_decimation;
+}
+
+int PolyphaseResampler::getTapsPerPhase() const
+{
+    return m_tapsPerPhase;
+}
+
+void PolyphaseResampler::reset()
+{
+    m_buffer.fill(0.0, m_tapsPerPhase - 1);
+    m_time = 0;
+}
+
+int PolyphaseResampler::getMaxOutputSize(int numSamples) const
+{
+    if (numSamples <= 0) {
+        return 0;
+    }
+    const qint64 span = static_cast<qint64>(numSamples) * m_interpolation;
+    return static_cast<int>((span + m_decimation - 1) / m_decimation);
+}
+
+int PolyphaseResampler::process(const double *input, int numSamples, double *output)
+{
+    if (numSamples <= 0) {
+        return 0;
+    }
+
+    const int history = m_tapsPerPhase - 1;
+    m_buffer.resize(history + numSamples);
+    double *buffer = m_buffer.data();
+    std::memcpy(buffer + history, input, sizeof(double) * numSamples);
+
+    // 输出 m 位于 L 倍速率上的 t = m * M: 用相位 t % L 的子滤波器, 最新的输入为 x[t / L]
+    const qint64 span = static_cast<qint64>(numSamples) * m_interpolation;
+    int count = 0;
+    for (; m_time < span; m_time += m_decimation) {
+        const int index = static_cast<int>(m_time / m_interpolation);
+        const int phase = static_cast<int>(m_time % m_interpolation);
+        SimdKernels::convolve(buffer + index, m_phaseTaps.constData() + phase * m_tapsPerPhase,
+                              m_tapsPerPhase, output + count, 1);
+        ++count;
+    }
+    m_time -= span;
+
+    std::memmove(buffer, buffer + numSamples, sizeof(double) * history);
+    m_buffer.resize(history);
+    return count;
+}
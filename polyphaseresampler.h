@@ -0,0 +1,43 @@
+#ifndef POLYPHASERESAMPLER_H
+#define POLYPHASERESAMPLER_H
+
+#include <QVector>
+
+// 有理数倍率的流式多相重采样器: 输出采样率 = 输入采样率 * L / M
+// 原型低通 (Kaiser 窗 sinc) 在 L 倍速率上设计, 拆成 L 个子滤波器 (多相分量), 每个输出只计算它所在相位的
+// 子滤波器: 插入的零和被抽掉的样本都不参与计算, 每个输出 ceil(N / L) 次乘加 (N 为原型长度).
+// 保护 [0, passband * 较低的奈奎斯特频率] 不被混叠或镜像污染, 过渡带结束于较低的奈奎斯特频率.
+// 内部保存最近 ceil(N / L) - 1 个输入样本和相位, 数据可以按任意长度分块连续送入, 结果与一次性处理整段数据相同.
+class PolyphaseResampler
+{
+public:
+    PolyphaseResampler();
+
+    // 设置倍率 (自动约分) 并重新设计原型, 清空状态. 参数超出范围时返回 false, 保持原来的设计
+    bool setRatio(int interpolation, int decimation, double passband = 0.8, double attenuationDb = 80.0);
+    int getInterpolation() const;
+    int getDecimation() const;
+    // 每个相位的抽头数
+    int getTapsPerPhase() const;
+
+    // 清空历史 (之前的输入视为0) 和相位
+    void reset();
+
+    // numSamples 个输入最多产生的输出数
+    int getMaxOutputSize(int numSamples) const;
+    // 返回输出样本数; output 至少 getMaxOutputSize(numSamples) 个样本, 不能与 input 重叠
+    int process(const double *input, int numSamples, double *output);
+
+    // L * ceil(N / L) 的上限
+    static const int MAX_PROTOTYPE_LENGTH = 1 << 16;
+
+private:
+    int m_interpolation;
+    int m_decimation;
+    int m_tapsPerPhase;
+    QVector<double> m_phaseTaps;    // L 个子滤波器, 每个 m_tapsPerPhase 个抽头, 按时间倒序 (与 SimdKernels::convolve 一致)
+    QVector<double> m_buffer;       // [最近 m_tapsPerPhase - 1 个历史样本 | 当前块]
+    qint64 m_time;                  // 下一个输出在 L 倍速率上相对当前块第一个样本的位置
+};
+
+#endif // POLYPHASERESAMPLER_H
@@ -0,0 +1,221 @@
+#include "realfft.h"
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QtMath>
+#include <algorithm>
+#include <cstring>
+
+RealFft::RealFft(int size) :
+    m_size(size > 0 ? size : 1),
+    m_packed(m_size % 2 == 0),
+    m_fft(Fft::plan(m_packed ? m_size / 2 : m_size))
+{
+    if (!m_packed) {
+        return;
+    }
+
+    const int half = m_size / 2;
+    m_twiddles.resize(2 * (half / 2 + 1));
+    for (int k = 0; k <= half / 2; ++k) {
+        const double angle = -2.0 * M_PI * k / m_size;
+        m_twiddles[2 * k] = std::cos(angle);
+        m_twiddles[2 * k + 1] = std::sin(angle);
+    }
+}
+
+std::shared_ptr<const RealFft> RealFft::plan(int size)
+{
+    static QMutex mutex;
+    static QVector<std::shared_ptr<const RealFft>> cache;   // 最近使用的在最后
+
+    QMutexLocker locker(&mutex);
+    for (int i = cache.size() - 1; i >= 0; --i) {
+        if (cache[i]->getSize() == size) {
+            std::shared_ptr<const RealFft> plan = cache[i];
+            cache.remove(i);
+            cache.append(plan);
+            return plan;
+        }
+    }
+
+    std::shared_ptr<const RealFft> plan = std::make_shared<const RealFft>(size);
+    if (cache.size() >= PLAN_CACHE_SIZE) {
+        cache.removeFirst();
+    }
+    cache.append(plan);
+    return plan;
+}
+
+int RealFft::getSize() const
+{
+    return m_size;
+}
+
+int RealFft::getOutputSize() const
+{
+    return m_size / 2 + 1;
+}
+
+int RealFft::getWorkspaceSize() const
+{
+    return m_packed ? m_fft->getWorkspaceSize() : m_size + m_fft->getWorkspaceSize();
+}
+
+void RealFft::forward(const double *input, std::complex<double> *output,
+                      std::complex<double> *workspace) const
+{
+    QVector<std::complex<double>> buffer;
+    if (!workspace && getWorkspaceSize() > 0) {
+        buffer.resize(getWorkspaceSize());
+        workspace = buffer.data();
+    }
+
+    if (!m_packed) {
+        for (int n = 0; n < m_size; ++n) {
+            workspace[n] = std::complex<double>(input[n], 0.0);
+        }
+        forwardOdd(output, workspace);
+        return;
+    }
+
+    std::memcpy(reinterpret_cast<double *>(output), input, sizeof(double) * m_size);
+    m_fft->forward(output, workspace);
+    split(output);
+}
+
+void RealFft::forward(const qint16 *input, std::complex<double> *output,
+                      std::complex<double> *workspace) const
+{
+    QVector<std::complex<double>> buffer;
+    if (!workspace && getWorkspaceSize() > 0) {
+        buffer.resize(getWorkspaceSize());
+        workspace = buffer.data();
+    }
+
+    if (!m_packed) {
+        for (int n = 0; n < m_size; ++n) {
+            workspace[n] = std::complex<double>(input[n], 0.0);
+        }
+        forwardOdd(output, workspace);
+        return;
+    }
+
+    for (int n = 0; n < m_size / 2; ++n) {
+        output[n] = std::complex<double>(input[2 * n], input[2 * n + 1]);
+    }
+    m_fft->forward(output, workspace);
+    split(output);
+}
+
+void RealFft::inverse(const std::complex<double> *input, double *output,
+                      std::complex<double> *workspace) const
+{
+    QVector<std::complex<double>> buffer;
+    if (!workspace && getWorkspaceSize() > 0) {
+        buffer.resize(getWorkspaceSize());
+        workspace = buffer.data();
+    }
+
+    if (!m_packed) {
+        // 补全共轭对称的负频率部分后做 N 点复数逆变换
+        workspace[0] = std::complex<double>(input[0].real(), 0.0);
+        for (int k = 1; k < getOutputSize(); ++k) {
+            workspace[k] = input[k];
+            workspace[m_size - k] = std::conj(input[k]);
+        }
+        m_fft->inverse(workspace, workspace + m_size);
+        for (int n = 0; n < m_size; ++n) {
+            output[n] = workspace[n].real();
+        }
+        return;
+    }
+
+    // 打包序列 z[n] = x[2n] + j*x[2n+1] 的内存布局与 output 相同, 逆变换后直接得到 x
+    std::complex<double> *packed = reinterpret_cast<std::complex<double> *>(output);
+    merge(input, packed);
+    m_fft->inverse(packed, workspace);
+}
+
+void RealFft::forwardOdd(std::complex<double> *output, std::complex<double> *workspace) const
+{
+    m_fft->forward(workspace, workspace + m_size);
+    std::copy(workspace, workspace + getOutputSize(), output);
+}
+
+// Z 为打包序列的 N/2 点变换, M = N/2:
+//   Fe[k] = (Z[k] + conj(Z[M-k])) / 2,  Fo[k] = -j * (Z[k] - conj(Z[M-k])) / 2
+//   X[k] = Fe[k] + W^k * Fo[k],  X[M-k] = conj(Fe[k] - W^k * Fo[k])
+// 每次同时算出 k 和 M-k 两个频点, 原地完成
+void RealFft::split(std::complex<double> *data) const
+{
+    const int half = m_size / 2;
+    double *values = reinterpret_cast<double *>(data);
+
+    const double re0 = values[0];
+    const double im0 = values[1];
+    values[0] = re0 + im0;
+    values[1] = 0.0;
+    values[2 * half] = re0 - im0;
+    values[2 * half + 1] = 0.0;
+
+    const double *w = m_twiddles.constData();
+    for (int k = 1; k <= half / 2; ++k) {
+        double *a = values + 2 * k;
+        double *b = values + 2 * (half - k);
+        const double evenRe = 0.5 * (a[0] + b[0]);
+        const double evenIm = 0.5 * (a[1] - b[1]);
+        const double oddRe = 0.5 * (a[1] + b[1]);
+        const double oddIm = 0.5 * (b[0] - a[0]);
+
+        const double wRe = w[2 * k];
+        const double wIm = w[2 * k + 1];
+        const double rotRe = wRe * oddRe - wIm * oddIm;
+        const double rotIm = wRe * oddIm + wIm * oddRe;
+
+        a[0] = evenRe + rotRe;
+        a[1] = evenIm + rotIm;
+        // k == M-k 时两个结果相同 (虚部的 Fo 项为0)
+        if (2 * k != half) {
+            b[0] = evenRe - rotRe;
+            b[1] = rotIm - evenIm;
+        }
+    }
+}
+
+// split 的逆过程, M = N/2:
+//   Fe[k] = (X[k] + conj(X[M-k])) / 2,  Fo[k] = (X[k] - conj(X[M-k])) * conj(W^k) / 2
+//   Z[k] = Fe[k] + j * Fo[k],  Z[M-k] = conj(Fe[k]) + j * conj(Fo[k])
+void RealFft::merge(const std::complex<double> *input, std::complex<double> *output) const
+{
+    const int half = m_size / 2;
+    const double *in = reinterpret_cast<const double *>(input);
+    double *out = reinterpret_cast<double *>(output);
+
+    // k = 0: Fe = (X[0] + X[M]) / 2, Fo = (X[0] - X[M]) / 2, 两者均为实数
+    out[0] = 0.5 * (in[0] + in[2 * half]);
+    out[1] = 0.5 * (in[0] - in[2 * half]);
+
+    const double *w = m_twiddles.constData();
+    for (int k = 1; k <= half / 2; ++k) {
+        const double *a = in + 2 * k;
+        const double *b = in + 2 * (half - k);
+        const double evenRe = 0.5 * (a[0] + b[0]);
+        const double evenIm = 0.5 * (a[1] - b[1]);
+        const double diffRe = 0.5 * (a[0] - b[0]);
+        const double diffIm = 0.5 * (a[1] + b[1]);
+
+        // Fo = diff * conj(W^k)
+        const double wRe = w[2 * k];
+        const double wIm = w[2 * k + 1];
+        const double oddRe = diffRe * wRe + diffIm * wIm;
+        const double oddIm = diffIm * wRe - diffRe * wIm;
+
+        out[2 * k] = evenRe - oddIm;
+        out[2 * k + 1] = evenIm + oddRe;
+        if (2 * k != half) {
+            out[2 * (half - k)] = evenRe + oddIm;
+            out[2 * (half - k) + 1] = oddRe - evenIm;
+        }
+    }
+}
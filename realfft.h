@@ -0,0 +1,54 @@
+#ifndef REALFFT_H
+#define REALFFT_H
+
+#include <QVector>
+#include <complex>
+#include <memory>
+
+#include "fft.h"
+
+// 实数输入FFT: 长度为 N 的实序列只输出非负频率的 N/2+1 个频点 (N/2 向下取整)
+// N 为偶数时, 偶数/奇数下标的样本打包成长度 N/2 的复序列 z[n] = x[2n] + j*x[2n+1] (与 double 数组的内存布局相同, 直接拷贝),
+// 做一次 N/2 点复数FFT, 再用旋转因子 W^k = e^(-j*2*pi*k/N) 把结果拆分成 X[k]; 计算量和工作区都约为同长度复数FFT的一半.
+// N 为奇数时无法打包, 在工作区中做 N 点复数FFT后取前一半频点.
+// 逆变换 (非负频点 -> 实序列) 按相反的步骤进行, 包含 1/N 缩放.
+// 计划按长度缓存共享, 变换是 const 的, 可以并发调用.
+class RealFft
+{
+public:
+    explicit RealFft(int size);
+
+    // 长度为 size 的共享计划, 最近用过的 PLAN_CACHE_SIZE 个长度只构造一次 (线程安全)
+    static std::shared_ptr<const RealFft> plan(int size);
+
+    int getSize() const;
+    int getOutputSize() const;      // N/2 + 1
+    int getWorkspaceSize() const;   // 变换需要的工作区 (复数个数)
+
+    // output 至少容纳 getOutputSize() 个复数 (N 为偶数时同时用作工作区);
+    // workspace 为空且需要工作区时临时分配
+    void forward(const double *input, std::complex<double> *output,
+                 std::complex<double> *workspace = nullptr) const;
+    void forward(const qint16 *input, std::complex<double> *output,
+                 std::complex<double> *workspace = nullptr) const;
+    // input 为 getOutputSize() 个频点 (共轭对称的另一半由此确定, 直流和奈奎斯特频点的虚部被忽略),
+    // output 为 N 个实数样本 (N 为偶数时同时用作工作区), 不能与 input 重叠: inverse(forward(x)) == x
+    void inverse(const std::complex<double> *input, double *output,
+                 std::complex<double> *workspace = nullptr) const;
+
+    static const int PLAN_CACHE_SIZE = 16;
+
+private:
+    void split(std::complex<double> *data) const;
+    // split 的逆过程: 由非负频点得到打包序列的 N/2 点频谱
+    void merge(const std::complex<double> *input, std::complex<double> *output) const;
+    // N 为奇数: workspace 前 N 个复数已是输入, 在其后的工作区中变换并取出非负频点
+    void forwardOdd(std::complex<double> *output, std::complex<double> *workspace) const;
+
+    int m_size;
+    bool m_packed;                      // N 为偶数, 打包成 N/2 点复数FFT
+    std::shared_ptr<const Fft> m_fft;   // N/2 点 (偶数) 或 N 点 (奇数) 复数FFT
+    QVector<double> m_twiddles;         // k = 0..N/4 的 W^k 实部虚部
+};
+
+#endif // REALFFT_H
@@ -1,97 +1,76 @@
 #include "receiveanalyzer.h"
+#include "simdkernels.h"
 
-ReceiveAnalyzer::ReceiveAnalyzer(QObject *parent) : QObject(parent),
-    m_filterCutoff(500.0),
-    m_samplingRate(8000)
+#include <QThread>
+#include <climits>
+
+// 后台计算线程
+class ReceiveAnalyzer::Worker : public QThread
+{
+public:
+    explicit Worker(ReceiveAnalyzer *analyzer) : m_analyzer(analyzer) {}
+
+protected:
+    void run() override
+    {
+        m_analyzer->runWorker();
+    }
+
+private:
+    ReceiveAnalyzer *m_analyzer;
+};
+
+bool ReceiveAnalyzer::RateParameters::operator==(const RateParameters &other) const
 {
+    return samplingRate == other.samplingRate && decimation == other.decimation;
 }
 
-QVector<double> ReceiveAnalyzer::applyLowPassFilter(const QVector<double> &inputSignal, double cutoffFrequency, int samplingRate)
+bool ReceiveAnalyzer::FilterParameters::operator==(const FilterParameters &other) const
 {
-    if (inputSignal.isEmpty()) {
-        return QVector<double>();
-    }
-    
-    // 简单的移动平均滤波器
-    int windowSize = static_cast<int>(samplingRate / cutoffFrequency);
-    if (windowSize < 3) windowSize = 3;
-    if (windowSize % 2 == 0) windowSize++; // 确保窗口大小为奇数
-    
-    int halfWindow = windowSize / 2;
-    QVector<double> filteredSignal;
-    filteredSignal.reserve(inputSignal.size());
-    
-    for (int i = 0; i < inputSignal.size(); ++i) {
-        double sum = 0.0;
-        int count = 0;
-        
-        for (int j = -halfWindow; j <= halfWindow; ++j) {
-            int index = i + j;
-            if (index >= 0 && index < inputSignal.size()) {
-                sum += inputSignal[index];
-                count++;
-            }
-        }
-        
-        filteredSignal.append(sum / count);
-    }
-    
-    return filteredSignal;
+    return type == other.type && cutoff == other.cutoff && order == other.order;
 }
 
-QVector<double> ReceiveAnalyzer::calculateFFT(const QVector<double> &inputSignal, int samplingRate)
+ReceiveAnalyzer::ReceiveAnalyzer(QObject *parent) : QObject(parent),
+    m_int16Samples(false),
+    m_rawDataTime(0),
+    m_pendingSamples(0),
+    m_droppedSamples(0),
+    m_dirtyStages(0),
+    m_busy(false),
+    m_stopping(false),
+    m_hasBlock(false)
 {
-    if (inputSignal.isEmpty()) {
-        return QVector<double>();
-    }
+    m_rateParameters.samplingRate = 8000.0;
+    m_rateParameters.decimation = 1;
+    m_appliedRate = m_rateParameters;
     
-    // 找到最接近的2的幂次方
-    int fftSize = 1;
-    while (fftSize < inputSignal.size()) {
-        fftSize <<= 1;
-    }
+    m_lowPassFilter.setSamplingRate(m_rateParameters.samplingRate);
+    m_lowPassFilter.setCutoff(500.0);
+    m_lowPassFilter.saveState(m_filterAtBlockStart);
+    m_filterParameters.type = m_lowPassFilter.getType();
+    m_filterParameters.cutoff = m_lowPassFilter.getCutoff();
+    m_filterParameters.order = m_lowPassFilter.getOrder();
+    m_appliedFilter = m_filterParameters;
     
-    // 将信号转换为复数格式并填充零
-    QVector<std::complex<double>> complexSignal;
-    complexSignal.reserve(fftSize);
+    m_spectrumSettings.samplingRate = m_rateParameters.samplingRate;
+    m_spectrumAnalyzer.setSettings(m_spectrumSettings);
+    m_frequencyAxis = m_spectrumAnalyzer.getFrequencyAxis();
     
-    for (int i = 0; i < fftSize; ++i) {
-        if (i < inputSignal.size()) {
-            complexSignal.append(std::complex<double>(inputSignal[i], 0.0));
-        } else {
-            complexSignal.append(std::complex<double>(0.0, 0.0));
-        }
-    }
-    
-    // 执行FFT
-    fft(complexSignal);
-    
-    // 计算幅度谱
-    QVector<double> magnitudeSpectrum;
-    magnitudeSpectrum.reserve(fftSize / 2);
-    
-    for (int i = 0; i < fftSize / 2; ++i) {
-        double magnitude = std::abs(complexSignal[i]) * 2.0 / fftSize;
-        magnitudeSpectrum.append(magnitude);
-    }
-    
-    // 创建频率轴
-    m_frequencyAxis = getFrequencyAxis(fftSize, samplingRate);
-    
-    return magnitudeSpectrum;
+    m_worker.reset(new Worker(this));
+    m_worker->start();
+
+    connect(&m_captureWriter, &CaptureWriter::finished, this, [this](bool ok) {
+        emit captureSaved(ok, ok ? QString() : m_captureWriter.errorString());
+    });
 }
 
-QVector<double> ReceiveAnalyzer::getFrequencyAxis(int fftSize, int samplingRate)
+ReceiveAnalyzer::~ReceiveAnalyzer()
 {
-    QVector<double> freqAxis;
-    freqAxis.reserve(fftSize / 2);
-    
-    for (int i = 0; i < fftSize / 2; ++i) {
-        double frequency = static_cast<double>(i) * samplingRate / fftSize;
-        freqAxis.append(frequency);
-    }
-    
-    return freqAxis;
+    m_mutex.lock();
+    m_stopping = true;
+    m_wakeUp.wakeAll();
+    m_mutex.unlock();
+    m_worker->wait();
 }
 
 bool ReceiveAnalyzer::saveDataToFile(const QVector<double> &data, const QString &filePath)
@@ -117,72 +96,450 @@ bool ReceiveAnalyzer::saveDataToFile(const QVector<double> &data, const QString
     return true;
 }
 
+bool ReceiveAnalyzer::saveCaptureFile(const QString &filePath)
+{
+    QMutexLocker locker(&m_mutex);
+    const QVector<double> data = m_rawData;
+    const QVector<qint16> data16 = m_rawData16;
+    const bool int16Samples = m_int16Samples;
+
+    CaptureWriter::Settings settings;
+    settings.sampleFormat = int16Samples ? CaptureFormat::Int16 : CaptureFormat::Float64;
+    settings.samplingRate = m_rateParameters.samplingRate;
+    const int size = int16Samples ? data16.size() : data.size();
+    settings.startTime = m_rawDataTime - qRound64(size * 1000.0 / settings.samplingRate);
+    locker.unlock();
+
+    if (!m_captureWriter.open(filePath, settings)) {
+        locker.relock();
+        m_errorString = m_captureWriter.errorString();
+        return false;
+    }
+
+    // 数据与接收缓冲区共享, 不复制
+    if (int16Samples) {
+        m_captureWriter.write(data16);
+    } else {
+        m_captureWriter.write(data);
+    }
+    m_captureWriter.close();
+    return true;
+}
+
 QVector<double> ReceiveAnalyzer::getRawData() const
 {
+    QMutexLocker locker(&m_mutex);
+    if (m_int16Samples) {
+        QVector<double> data(m_rawData16.size());
+        SimdKernels::convertFromInt16(m_rawData16.constData(), data.data(), data.size());
+        return data;
+    }
     return m_rawData;
 }
 
 QVector<double> ReceiveAnalyzer::getFilteredData() const
 {
+    QMutexLocker locker(&m_mutex);
+    if (!m_filteredData16.isEmpty()) {
+        QVector<double> data(m_filteredData16.size());
+        SimdKernels::convertFromInt16(m_filteredData16.constData(), data.data(), data.size());
+        return data;
+    }
     return m_filteredData;
 }
 
 QVector<double> ReceiveAnalyzer::getSpectrumData() const
 {
+    QMutexLocker locker(&m_mutex);
     return m_spectrumData;
 }
 
 QVector<double> ReceiveAnalyzer::getFrequencyData() const
 {
+    QMutexLocker locker(&m_mutex);
     return m_frequencyAxis;
 }
 
+bool ReceiveAnalyzer::waitForIdle(int timeout)
+{
+    QMutexLocker locker(&m_mutex);
+    while (m_busy || !m_pendingBlocks.isEmpty() || m_dirtyStages != 0) {
+        if (!m_idle.wait(&m_mutex, timeout < 0 ? ULONG_MAX : static_cast<unsigned long>(timeout))) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void ReceiveAnalyzer::onSignalReceived(const QVector<double> &signal)
 {
-    m_rawData = signal;
-    emit dataReceived(m_rawData);
-    processReceivedData();
+    // 与发送方共享数据, 不复制
+    Block block;
+    block.samples = signal;
+    block.int16Samples = false;
+    
+    QMutexLocker locker(&m_mutex);
+    enqueueBlock(block);
+    const QVector<double> data = m_rawData;
+    locker.unlock();
+    emit dataReceived(data);
 }
 
-void ReceiveAnalyzer::processReceivedData()
+void ReceiveAnalyzer::onSignalReceived16(const QVector<qint16> &signal)
+{
+    Block block;
+    block.samples16 = signal;
+    block.int16Samples = true;
+    
+    QMutexLocker locker(&m_mutex);
+    enqueueBlock(block);
+}
+
+void ReceiveAnalyzer::onSignalReceived(const double *signal, int numSamples)
 {
-    // 应用低通滤波
-    m_filteredData = applyLowPassFilter(m_rawData, m_filterCutoff, m_samplingRate);
-    emit filteredDataReady(m_filteredData);
+    QMutexLocker locker(&m_mutex);
+    m_rawData.resize(numSamples);
+    std::copy(signal, signal + numSamples, m_rawData.data());
     
-    // 执行频谱分析
-    m_spectrumData = calculateFFT(m_rawData, m_samplingRate);
-    emit spectrumDataReady(m_spectrumData, m_frequencyAxis);
+    Block block;
+    block.samples = m_rawData;
+    block.int16Samples = false;
+    enqueueBlock(block);
+    const QVector<double> data = m_rawData;
+    locker.unlock();
+    emit dataReceived(data);
+}
+
+void ReceiveAnalyzer::onSignalReceived16(const qint16 *signal, int numSamples)
+{
+    QMutexLocker locker(&m_mutex);
+    m_rawData16.resize(numSamples);
+    std::copy(signal, signal + numSamples, m_rawData16.data());
+    
+    Block block;
+    block.samples16 = m_rawData16;
+    block.int16Samples = true;
+    enqueueBlock(block);
+}
+
+void ReceiveAnalyzer::processReceivedData()
+{
+    QMutexLocker locker(&m_mutex);
+    Block block;
+    block.samples = m_rawData;
+    block.samples16 = m_rawData16;
+    block.int16Samples = m_int16Samples;
+    enqueueBlock(block);
+}
+
+void ReceiveAnalyzer::enqueueBlock(const Block &block)
+{
+    // 原始数据立即更新; 后台线程跟不上时丢弃最早排队的块, 内存占用有上限
+    m_rawData = block.samples;
+    m_rawData16 = block.samples16;
+    m_int16Samples = block.int16Samples;
+    m_rawDataTime = QDateTime::currentMSecsSinceEpoch();
+    m_pendingBlocks.append(block);
+    m_pendingSamples += block.size();
+    while (m_pendingSamples > MAX_PENDING_SAMPLES && m_pendingBlocks.size() > 1) {
+        const int dropped = m_pendingBlocks.takeFirst().size();
+        m_pendingSamples -= dropped;
+        m_droppedSamples += dropped;
+    }
+    m_wakeUp.wakeAll();
+}
+
+void ReceiveAnalyzer::invalidate(int stages)
+{
+    m_dirtyStages |= stages;
+    m_wakeUp.wakeAll();
 }
 
 void ReceiveAnalyzer::setFilterCutoff(double cutoffFrequency)
 {
-    m_filterCutoff = cutoffFrequency;
-    if (!m_rawData.isEmpty()) {
-        processReceivedData();
+    QMutexLocker locker(&m_mutex);
+    m_filterParameters.cutoff = cutoffFrequency;
+    invalidate(FilterStage);
+}
+
+void ReceiveAnalyzer::setFilterType(LowPassFilter::Type type)
+{
+    QMutexLocker locker(&m_mutex);
+    m_filterParameters.type = type;
+    invalidate(FilterStage);
+}
+
+void ReceiveAnalyzer::setFilterOrder(int order)
+{
+    QMutexLocker locker(&m_mutex);
+    m_filterParameters.order = qBound(1, order, BiquadCascade::MAX_ORDER);
+    invalidate(FilterStage);
+}
+
+LowPassFilter::Type ReceiveAnalyzer::getFilterType() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_filterParameters.type;
+}
+
+int ReceiveAnalyzer::getFilterOrder() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_filterParameters.order;
+}
+
+void ReceiveAnalyzer::setSamplingRate(double samplingRate)
+{
+    if (!(samplingRate > 0.0)) {
+        return;
+    }
+    QMutexLocker locker(&m_mutex);
+    m_rateParameters.samplingRate = samplingRate;
+    m_spectrumSettings.samplingRate = samplingRate / m_rateParameters.decimation;
+    invalidate(DecimationStage | SpectrumStage);
+}
+
+double ReceiveAnalyzer::getSamplingRate() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_rateParameters.samplingRate;
+}
+
+bool ReceiveAnalyzer::setDecimation(int factor)
+{
+    QMutexLocker locker(&m_mutex);
+    if (factor < 1 || factor > Decimator::MAX_FACTOR) {
+        m_errorString = QString("抽取倍数应在 1 到 %1 之间").arg(Decimator::MAX_FACTOR);
+        return false;
     }
+    m_rateParameters.decimation = factor;
+    m_spectrumSettings.samplingRate = m_rateParameters.samplingRate / factor;
+    invalidate(DecimationStage | SpectrumStage);
+    return true;
+}
+
+int ReceiveAnalyzer::getDecimation() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_rateParameters.decimation;
 }
 
-void ReceiveAnalyzer::fft(QVector<std::complex<double>> &x)
+double ReceiveAnalyzer::getAnalysisSamplingRate() const
 {
-    const size_t N = x.size();
-    if (N <= 1) return;
+    QMutexLocker locker(&m_mutex);
+    return m_rateParameters.samplingRate / m_rateParameters.decimation;
+}
+
+bool ReceiveAnalyzer::setSpectrumSettings(const SpectrumAnalyzer::Settings &settings)
+{
+    QMutexLocker locker(&m_mutex);
+    SpectrumAnalyzer::Settings adjusted = settings;
+    adjusted.samplingRate = m_rateParameters.samplingRate / m_rateParameters.decimation;
     
-    // 分治法: 分离偶数和奇数下标
-    QVector<std::complex<double>> even(N/2), odd(N/2);
-    for (size_t i = 0; i < N/2; ++i) {
-        even[i] = x[2*i];
-        odd[i] = x[2*i + 1];
+    if (!SpectrumAnalyzer::checkSettings(adjusted, &m_errorString)) {
+        return false;
+    }
+    m_spectrumSettings = adjusted;
+    invalidate(SpectrumStage);
+    return true;
+}
+
+SpectrumAnalyzer::Settings ReceiveAnalyzer::getSpectrumSettings() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_spectrumSettings;
+}
+
+QString ReceiveAnalyzer::errorString() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_errorString;
+}
+
+void ReceiveAnalyzer::runWorker()
+{
+    QMutexLocker locker(&m_mutex);
+    for (;;) {
+        while (!m_stopping && m_pendingBlocks.isEmpty() && m_dirtyStages == 0) {
+            m_busy = false;
+            m_idle.wakeAll();
+            m_wakeUp.wait(&m_mutex);
+        }
+        if (m_stopping) {
+            m_busy = false;
+            m_idle.wakeAll();
+            return;
+        }
+        
+        // 取出这一轮的工作和最新的参数, 计算期间的修改留到下一轮
+        m_busy = true;
+        const int dirty = m_dirtyStages;
+        m_dirtyStages = 0;
+        const RateParameters rateParameters = m_rateParameters;
+        const FilterParameters filterParameters = m_filterParameters;
+        const SpectrumAnalyzer::Settings spectrumSettings = m_spectrumSettings;
+        const bool newBlock = !m_pendingBlocks.isEmpty();
+        const Block block = newBlock ? m_pendingBlocks.takeFirst() : Block();
+        m_pendingSamples -= block.size();
+        const qint64 droppedSamples = newBlock ? m_droppedSamples : 0;
+        if (newBlock) {
+            m_droppedSamples = 0;
+        }
+        locker.unlock();
+        
+        int filterUpdates = 0;
+        int spectrumFrames = 0;
+        QVector<double> filtered;
+        QVector<qint16> filtered16;
+        
+        // 采样率或抽取倍数改变: 抽取器和滤波器从头开始, 当前块重新抽取后作为新的一块滤波和分析
+        bool restart = false;
+        if ((dirty & DecimationStage) && !(rateParameters == m_appliedRate)) {
+            applyRate(rateParameters);
+            restart = m_hasBlock;
+            if (restart) {
+                runDecimationStage(m_currentInput, m_currentBlock);
+            }
+        }
+        
+        // 参数修改只作用于已经处理过的当前块; 参数与缓存结果相同时跳过
+        if (restart || (m_hasBlock && (dirty & FilterStage) && !(filterParameters == m_appliedFilter))) {
+            runFilterStage(m_currentBlock, filterParameters, restart, filtered, filtered16);
+            ++filterUpdates;
+        }
+        if (restart || ((dirty & SpectrumStage) && spectrumSettings != m_spectrumAnalyzer.getSettings())) {
+            m_spectrumAnalyzer.setSettings(spectrumSettings);
+            spectrumFrames = m_hasBlock ? runSpectrumStage(m_currentBlock) : 0;
+            
+            locker.relock();
+            m_frequencyAxis = m_spectrumAnalyzer.getFrequencyAxis();
+            m_spectrumData.clear();
+            locker.unlock();
+        }
+        
+        if (newBlock) {
+            m_currentInput = block;
+            runDecimationStage(block, m_currentBlock);
+            m_hasBlock = true;
+            runFilterStage(m_currentBlock, filterParameters, true, filtered, filtered16);
+            ++filterUpdates;
+            spectrumFrames += runSpectrumStage(m_currentBlock);
+        }
+        
+        // 发布结果; 信号在锁外发出
+        QVector<double> spectrum;
+        QVector<double> axis;
+        QVector<double> frames;
+        const int bins = m_spectrumAnalyzer.getBinCount();
+        if (spectrumFrames > 0) {
+            spectrum.resize(bins);
+            m_spectrumAnalyzer.amplitudeSpectrum(spectrum.data());
+            if (spectrumSettings.spectrogramDepth > 0) {
+                frames = m_spectrumAnalyzer.getLatestFrames(spectrumFrames);
+            }
+        }
+        
+        locker.relock();
+        if (filterUpdates > 0) {
+            m_filteredData = filtered;
+            m_filteredData16 = filtered16;
+        }
+        if (spectrumFrames > 0) {
+            m_spectrumData = spectrum;
+            axis = m_frequencyAxis;
+        }
+        locker.unlock();
+        
+        if (filterUpdates > 0) {
+            if (m_currentBlock.int16Samples) {
+                emit filteredDataReady16(filtered16);
+            } else {
+                emit filteredDataReady(filtered);
+            }
+        }
+        if (newBlock) {
+            // 重新滤波和新块在同一轮时 filtered 是新块的结果
+            const int decimation = m_appliedRate.decimation;
+            const qint64 missingSamples = (droppedSamples + decimation / 2) / decimation;
+            if (m_currentBlock.int16Samples) {
+                emit filteredBlockReady16(filtered16, missingSamples);
+            } else {
+                emit filteredBlockReady(filtered, missingSamples);
+            }
+        }
+        if (spectrumFrames > 0) {
+            emit spectrumDataReady(spectrum, axis);
+            if (!frames.isEmpty()) {
+                emit spectrogramFramesReady(frames, bins);
+            }
+        }
+        locker.relock();
+    }
+}
+
+void ReceiveAnalyzer::applyRate(const RateParameters &parameters)
+{
+    m_decimator.setFactor(parameters.decimation);
+    m_lowPassFilter.setSamplingRate(parameters.samplingRate / parameters.decimation);
+    m_lowPassFilter.reset();
+    m_lowPassFilter.saveState(m_filterAtBlockStart);
+    m_appliedRate = parameters;
+}
+
+void ReceiveAnalyzer::runDecimationStage(const Block &input, Block &output)
+{
+    if (m_decimator.getFactor() == 1) {
+        output = input;
+        return;
     }
     
-    // 递归地处理子问题
-    fft(even);
-    fft(odd);
+    // 抽取器的状态在块之间接续, 块长不是倍数的整数倍时输出数逐块略有不同
+    output.int16Samples = input.int16Samples;
+    if (input.int16Samples) {
+        QVector<qint16> decimated(m_decimator.getMaxOutputSize(input.samples16.size()));
+        decimated.resize(m_decimator.process(input.samples16.constData(), input.samples16.size(), decimated.data()));
+        output.samples16 = decimated;
+        output.samples.clear();
+    } else {
+        QVector<double> decimated(m_decimator.getMaxOutputSize(input.samples.size()));
+        decimated.resize(m_decimator.process(input.samples.constData(), input.samples.size(), decimated.data()));
+        output.samples = decimated;
+        output.samples16.clear();
+    }
+}
+
+void ReceiveAnalyzer::runFilterStage(const Block &block, const FilterParameters &parameters, bool newBlock,
+                                     QVector<double> &filtered, QVector<qint16> &filtered16)
+{
+    // 新的一块: 记下滤波器在块开始时的状态; 重新滤波: 回到这个状态再应用新参数
+    if (newBlock) {
+        m_lowPassFilter.saveState(m_filterAtBlockStart);
+    } else {
+        m_lowPassFilter.restoreState(m_filterAtBlockStart);
+    }
+    m_lowPassFilter.setType(parameters.type);
+    m_lowPassFilter.setOrder(parameters.order);
+    m_lowPassFilter.setCutoff(parameters.cutoff);
+    m_appliedFilter = parameters;
     
-    // 合并结果
-    for (size_t k = 0; k < N/2; ++k) {
-        std::complex<double> t = std::polar(1.0, -2 * M_PI * k / N) * odd[k];
-        x[k] = even[k] + t;
-        x[k + N/2] = even[k] - t;
+    // 流式低通滤波, 状态接续上一块
+    if (block.int16Samples) {
+        const int numSamples = block.samples16.size();
+        filtered16.resize(numSamples);
+        filtered.clear();
+        m_lowPassFilter.process(block.samples16.constData(), filtered16.data(), numSamples);
+    } else {
+        const int numSamples = block.samples.size();
+        filtered.resize(numSamples);
+        filtered16.clear();
+        m_lowPassFilter.process(block.samples.constData(), filtered.data(), numSamples);
     }
-} 
\ No newline at end of file
+}
+
+int ReceiveAnalyzer::runSpectrumStage(const Block &block)
+{
+    // 短时频谱分析只处理新到的样本, 没有凑够一帧时保留上一次的频谱
+    return block.int16Samples
+            ? m_spectrumAnalyzer.process(block.samples16.constData(), block.samples16.size())
+            : m_spectrumAnalyzer.process(block.samples.constData(), block.samples.size());
+}
@@ -7,51 +7,182 @@
 #include <QTextStream>
 #include <QDateTime>
 #include <QDebug>
-#include <complex>
 #include <QFileDialog>
+#include <QMutex>
+#include <QWaitCondition>
+#include <memory>
 
+#include "capturewriter.h"
+#include "decimator.h"
+#include "lowpassfilter.h"
+#include "spectrumanalyzer.h"
+
+// 接收分析: 接收数据流经过整数倍抽取 (抽取阶段, 可选), 低通滤波 (滤波阶段) 和短时频谱分析 (频谱阶段) 三个缓存的计算阶段.
+// 窄带信号先抽取到较低的采样率, 滤波和FFT的计算量随之按抽取倍数减少.
+// 计算在后台线程中进行, 接收数据的槽和参数设置只记录输入并标记受影响的阶段, 立即返回:
+//  - 新的一块: 三个阶段都要处理 (块按到达顺序排队, 抽取器, 滤波器和频谱的状态在块之间接续)
+//  - 采样率/抽取倍数: 三个阶段从头开始 (清空状态), 重新处理当前块
+//  - 滤波器类型/截止频率/阶数: 只有滤波阶段, 从当前块开始时保存的滤波器状态重新滤波当前块
+//  - 频谱设置: 只有频谱阶段, 清空平均结果后重新分析当前块
+// 后台线程每一轮读取最新的参数, 计算期间的多次修改 (例如拖动数值框) 合并为下一轮的一次计算;
+// 参数与缓存结果所用的参数相同时 (例如改回原值) 不重新计算. 结果信号从后台线程发出.
 class ReceiveAnalyzer : public QObject
 {
     Q_OBJECT
 public:
     explicit ReceiveAnalyzer(QObject *parent = nullptr);
-    
-    // 滤波处理
-    QVector<double> applyLowPassFilter(const QVector<double> &inputSignal, double cutoffFrequency, int samplingRate);
-    
-    // 频谱分析
-    QVector<double> calculateFFT(const QVector<double> &inputSignal, int samplingRate);
-    QVector<double> getFrequencyAxis(int fftSize, int samplingRate);
-    
-    // 保存接收数据到文件
+    ~ReceiveAnalyzer();
+
+    // 接收数据的采样率, 默认 8000 Hz; 应与信号发生器一致
+    void setSamplingRate(double samplingRate);
+    double getSamplingRate() const;
+    // 滤波和频谱分析之前的整数倍抽取 (见 Decimator), 1 表示不抽取; 超出范围时返回 false, 原因见 errorString()
+    bool setDecimation(int factor);
+    int getDecimation() const;
+    // 滤波结果和频谱的采样率: 接收采样率 / 抽取倍数
+    double getAnalysisSamplingRate() const;
+
+    // 接收数据流的短时频谱分析 (窗函数, 帧长, 重叠, 平均方式); 采样率使用抽取后的采样率.
+    // 参数超出范围时返回 false, 原因见 errorString()
+    bool setSpectrumSettings(const SpectrumAnalyzer::Settings &settings);
+    SpectrumAnalyzer::Settings getSpectrumSettings() const;
+    QString errorString() const;
+
+    // 保存接收数据到文本文件 (每行一个样本), 在调用线程中写入
     bool saveDataToFile(const QVector<double> &data, const QString &filePath);
-    
-    // 获取当前数据
+    // 把当前的原始数据保存为采集文件 (见 CaptureFormat, 16位数据按 int16, 否则按 float64 无损压缩存储):
+    // 只排队数据, 由后台线程写入, 立即返回, 写完后发出 captureSaved(). 无法创建文件或上一次保存还没写完时返回 false
+    bool saveCaptureFile(const QString &filePath);
+
+    // 接收数据流的低通滤波器类型和阶数 (CIC 级数 / IIR 阶数); 改变后用新参数重新滤波当前块
+    void setFilterType(LowPassFilter::Type type);
+    LowPassFilter::Type getFilterType() const;
+    void setFilterOrder(int order);
+    int getFilterOrder() const;
+
+    // 获取当前数据 (滤波和频谱为后台线程最近一次完成的结果)
     QVector<double> getRawData() const;
     QVector<double> getFilteredData() const;
     QVector<double> getSpectrumData() const;
     QVector<double> getFrequencyData() const;
 
+    // 等待后台线程处理完已收到的块和参数修改; timeout 为毫秒, 负数表示一直等待. 超时返回 false
+    bool waitForIdle(int timeout = -1);
+
+    // 无拷贝版本 (直接调用, 不作为槽连接): 数据只复制一次到内部缓冲区 (分析结果需要保留), 缓冲区在块之间复用
+    void onSignalReceived(const double *signal, int numSamples);
+    void onSignalReceived16(const qint16 *signal, int numSamples);
+
+    // 后台线程来不及处理时最多排队的样本数, 超过时丢弃最早的块 (最新的一块总是保留)
+    static const int MAX_PENDING_SAMPLES = 1 << 22;
+
 signals:
     void dataReceived(const QVector<double> &data);
     void filteredDataReady(const QVector<double> &filteredData);
+    void filteredDataReady16(const QVector<qint16> &filteredData);
+    // 只在新的一块滤波后发出 (修改参数后重新滤波当前块时不发出), 供录制等需要连续数据流的场合使用.
+    // missingSamples: 这一块之前因来不及处理而丢弃的数据折算到输出采样率上的样本数
+    void filteredBlockReady(const QVector<double> &filteredData, qint64 missingSamples);
+    void filteredBlockReady16(const QVector<qint16> &filteredData, qint64 missingSamples);
     void spectrumDataReady(const QVector<double> &spectrumData, const QVector<double> &freqAxis);
+    // 这一块新完成的语谱图帧 (单边功率谱密度, 按时间先后依次存放, 每帧 numBins 个点)
+    void spectrogramFramesReady(const QVector<double> &frames, int numBins);
+    // saveCaptureFile() 写完; ok 为 false 时 errorString 给出原因
+    void captureSaved(bool ok, const QString &errorString);
 
 public slots:
     void onSignalReceived(const QVector<double> &signal);
+    void onSignalReceived16(const QVector<qint16> &signal);
+    // 把当前的原始数据作为新的一块处理
     void processReceivedData();
     void setFilterCutoff(double cutoffFrequency);
 
 private:
-    // 快速傅里叶变换
-    void fft(QVector<std::complex<double>> &x);
-    
+    class Worker;
+
+    // 缓存的计算阶段, 按位组合
+    enum Stage {
+        FilterStage = 0x1,
+        SpectrumStage = 0x2,
+        DecimationStage = 0x4
+    };
+
+    struct RateParameters {
+        double samplingRate;
+        int decimation;
+
+        bool operator==(const RateParameters &other) const;
+    };
+
+    struct FilterParameters {
+        LowPassFilter::Type type;
+        double cutoff;
+        int order;
+
+        bool operator==(const FilterParameters &other) const;
+    };
+
+    struct Block {
+        QVector<double> samples;
+        QVector<qint16> samples16;
+        bool int16Samples;
+
+        int size() const { return int16Samples ? samples16.size() : samples.size(); }
+    };
+
+    // 排队一块数据并唤醒后台线程 (调用者持有 m_mutex)
+    void enqueueBlock(const Block &block);
+    // 标记阶段需要重新计算并唤醒后台线程
+    void invalidate(int stages);
+
+    // 以下在后台线程中运行
+    void runWorker();
+    // 按新的采样率和抽取倍数重新设计抽取器和滤波器, 清空它们的状态
+    void applyRate(const RateParameters &parameters);
+    // 抽取阶段: 不抽取时 output 与 input 共享数据
+    void runDecimationStage(const Block &input, Block &output);
+    // 滤波阶段: newBlock 为 true 时接续上一块的状态, 否则从当前块开始时的状态重新滤波
+    void runFilterStage(const Block &block, const FilterParameters &parameters, bool newBlock,
+                        QVector<double> &filtered, QVector<qint16> &filtered16);
+    // 频谱阶段: 分析 block, 返回完成的帧数
+    int runSpectrumStage(const Block &block);
+
+    // 输入, 参数和结果, 由 m_mutex 保护
+    mutable QMutex m_mutex;
+    QWaitCondition m_wakeUp;            // 有新的块或参数修改
+    QWaitCondition m_idle;              // 后台线程处理完所有工作
     QVector<double> m_rawData;
+    QVector<qint16> m_rawData16;        // 16位定点模式下的数据
+    bool m_int16Samples;                // 最近收到的数据是否为16位定点
+    qint64 m_rawDataTime;               // 最近一块的接收时间, 自1970年起的毫秒数
+    QVector<Block> m_pendingBlocks;
+    qint64 m_pendingSamples;
+    qint64 m_droppedSamples;            // 队列满时丢弃的输入样本, 随下一块交给后台线程
+    int m_dirtyStages;
+    bool m_busy;
+    bool m_stopping;
+    RateParameters m_rateParameters;
+    FilterParameters m_filterParameters;
+    SpectrumAnalyzer::Settings m_spectrumSettings;
+    QString m_errorString;
     QVector<double> m_filteredData;
-    QVector<double> m_spectrumData;
+    QVector<qint16> m_filteredData16;
+    QVector<double> m_spectrumData;     // 接收数据流的平均幅度谱
     QVector<double> m_frequencyAxis;
-    double m_filterCutoff;
-    int m_samplingRate;
+
+    // 只在后台线程中访问
+    Block m_currentInput;               // 最近处理的一块 (抽取前)
+    Block m_currentBlock;               // 最近处理的一块 (抽取后, 滤波和频谱的输入)
+    bool m_hasBlock;
+    RateParameters m_appliedRate;       // 当前抽取器和滤波器所用的参数
+    Decimator m_decimator;
+    FilterParameters m_appliedFilter;   // 当前滤波结果所用的参数
+    LowPassFilter m_lowPassFilter;      // 接收数据流的低通滤波器, 状态在块之间接续
+    LowPassFilter::State m_filterAtBlockStart;  // 当前块开始时的滤波器状态, 每块复用同一块内存
+    SpectrumAnalyzer m_spectrumAnalyzer;    // 接收数据流的频谱, 每凑够一帧更新一次
+
+    std::unique_ptr<Worker> m_worker;
+    CaptureWriter m_captureWriter;
 };
 
-#endif // RECEIVEANALYZER_H 
\ No newline at end of file
+#endif // RECEIVEANALYZER_H
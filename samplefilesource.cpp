@@ -0,0 +1,344 @@
+#include "samplefilesource.h"
+
+#include <QFileInfo>
+#include <QSettings>
+#include <QtEndian>
+#include <cstring>
+
+// 映射内存不保证按样本类型对齐, 统一通过 qFromLittleEndian 读取
+static inline double readInt16(const uchar *p)
+{
+    return qFromLittleEndian<qint16>(p);
+}
+
+static inline double readFloat32(const uchar *p)
+{
+    quint32 bits = qFromLittleEndian<quint32>(p);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static inline double readFloat64(const uchar *p)
+{
+    quint64 bits = qFromLittleEndian<quint64>(p);
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static int bytesPerSample(SampleFileSource::SampleFormat format)
+{
+    switch (format) {
+    case SampleFileSource::Float32:
+        return 4;
+    case SampleFileSource::Float64:
+        return 8;
+    default:
+        return 2;
+    }
+}
+
+SampleFileSource::SampleFileSource() :
+    m_mapping(nullptr),
+    m_mappingSize(0),
+    m_data(nullptr),
+    m_frameCount(0),
+    m_position(0),
+    m_sampleFormat(Int16),
+    m_channelCount(1),
+    m_samplingRate(0),
+    m_dataOffset(0),
+    m_scale(1.0)
+{
+}
+
+SampleFileSource::~SampleFileSource()
+{
+    close();
+}
+
+bool SampleFileSource::isBinaryFile(const QString &filePath)
+{
+    const QString suffix = QFileInfo(filePath).suffix().toLower();
+    return suffix == "wav" || suffix == "raw" || suffix == "pcm" || suffix == "bin" ||
+           suffix == "i16" || suffix == "s16" || suffix == "f32" || suffix == "f64" || suffix == "sgc" ||
+           QFile::exists(filePath + ".meta");
+}
+
+bool SampleFileSource::open(const QString &filePath)
+{
+    close();
+
+    if (CaptureReader::isCaptureFile(filePath)) {
+        return openCapture(filePath);
+    }
+
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_errorString = QString("无法打开文件: %1").arg(m_file.errorString());
+        return false;
+    }
+
+    m_mappingSize = m_file.size();
+    m_mapping = m_mappingSize > 0 ? m_file.map(0, m_mappingSize) : nullptr;
+    if (!m_mapping) {
+        m_errorString = QString("无法映射文件: %1").arg(m_file.errorString());
+        close();
+        return false;
+    }
+
+    bool isWav = m_mappingSize >= 12 && std::memcmp(m_mapping, "RIFF", 4) == 0;
+    bool ok = isWav ? parseWavHeader() : parseRawMetadata(filePath);
+    if (!ok) {
+        close();
+        return false;
+    }
+
+    m_data = m_mapping + m_dataOffset;
+    m_position = 0;
+    return true;
+}
+
+bool SampleFileSource::openCapture(const QString &filePath)
+{
+    if (!m_capture.open(filePath)) {
+        m_errorString = m_capture.errorString();
+        return false;
+    }
+
+    switch (m_capture.getSampleFormat()) {
+    case CaptureFormat::Int16:
+        m_sampleFormat = Int16;
+        break;
+    case CaptureFormat::Float32:
+        m_sampleFormat = Float32;
+        break;
+    default:
+        m_sampleFormat = Float64;
+        break;
+    }
+    m_channelCount = m_capture.getChannelCount();
+    m_samplingRate = qRound(m_capture.getSamplingRate());
+    m_frameCount = m_capture.getFrameCount();
+    m_position = 0;
+    return true;
+}
+
+void SampleFileSource::close()
+{
+    m_capture.close();
+    if (m_mapping) {
+        m_file.unmap(m_mapping);
+    }
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+
+    m_mapping = nullptr;
+    m_mappingSize = 0;
+    m_data = nullptr;
+    m_frameCount = 0;
+    m_position = 0;
+}
+
+bool SampleFileSource::isOpen() const
+{
+    return m_data != nullptr || m_capture.isOpen();
+}
+
+QString SampleFileSource::errorString() const
+{
+    return m_errorString;
+}
+
+SampleFileSource::SampleFormat SampleFileSource::getSampleFormat() const
+{
+    return m_sampleFormat;
+}
+
+int SampleFileSource::getChannelCount() const
+{
+    return m_channelCount;
+}
+
+int SampleFileSource::getSamplingRate() const
+{
+    return m_samplingRate;
+}
+
+qint64 SampleFileSource::getFrameCount() const
+{
+    return m_frameCount;
+}
+
+qint64 SampleFileSource::getPosition() const
+{
+    return m_position;
+}
+
+void SampleFileSource::seek(qint64 frame)
+{
+    m_position = qBound<qint64>(0, frame, m_frameCount);
+}
+
+int SampleFileSource::readBlock(double *output, int maxFrames, int channel)
+{
+    if (!isOpen() || channel < 0 || channel >= m_channelCount) {
+        return 0;
+    }
+
+    const int frames = static_cast<int>(qMin<qint64>(maxFrames, m_frameCount - m_position));
+    if (frames <= 0) {
+        return 0;
+    }
+
+    if (m_capture.isOpen()) {
+        m_capture.seek(m_position);
+        const int read = m_capture.readBlock(output, frames, channel);
+        m_position += read;
+        if (read < frames) {
+            // 遇到损坏的块, 采集文件已截断到该块之前
+            m_errorString = m_capture.errorString();
+            m_frameCount = m_capture.getFrameCount();
+            m_position = qMin(m_position, m_frameCount);
+        }
+        return read;
+    }
+
+    const int sampleBytes = bytesPerSample(m_sampleFormat);
+    const int frameBytes = sampleBytes * m_channelCount;
+    const uchar *src = rawFrames(m_position) + channel * sampleBytes;
+    const double scale = m_scale;
+
+    // 直接从映射内存转换到输出缓冲区
+    if (m_sampleFormat == Int16) {
+        for (int i = 0; i < frames; ++i) {
+            output[i] = readInt16(src + static_cast<qint64>(i) * frameBytes) * scale;
+        }
+    } else if (m_sampleFormat == Float32) {
+        for (int i = 0; i < frames; ++i) {
+            output[i] = readFloat32(src + static_cast<qint64>(i) * frameBytes) * scale;
+        }
+    } else {
+        for (int i = 0; i < frames; ++i) {
+            output[i] = readFloat64(src + static_cast<qint64>(i) * frameBytes) * scale;
+        }
+    }
+
+    m_position += frames;
+    return frames;
+}
+
+const uchar *SampleFileSource::rawFrames(qint64 frame) const
+{
+    if (!m_data) {
+        return nullptr;
+    }
+    return m_data + frame * bytesPerSample(m_sampleFormat) * m_channelCount;
+}
+
+bool SampleFileSource::parseWavHeader()
+{
+    const uchar *p = m_mapping;
+    if (std::memcmp(p + 8, "WAVE", 4) != 0) {
+        m_errorString = "不是有效的WAV文件";
+        return false;
+    }
+
+    bool haveFormat = false;
+    qint64 pos = 12;
+    while (pos + 8 <= m_mappingSize) {
+        const uchar *chunk = p + pos;
+        const quint32 chunkSize = qFromLittleEndian<quint32>(chunk + 4);
+
+        if (std::memcmp(chunk, "fmt ", 4) == 0 && chunkSize >= 16 && pos + 8 + chunkSize <= m_mappingSize) {
+            quint16 formatTag = qFromLittleEndian<quint16>(chunk + 8);
+            const quint16 channels = qFromLittleEndian<quint16>(chunk + 10);
+            const quint32 rate = qFromLittleEndian<quint32>(chunk + 12);
+            const quint16 bits = qFromLittleEndian<quint16>(chunk + 22);
+
+            // WAVE_FORMAT_EXTENSIBLE: 实际格式在子格式GUID的前两个字节
+            if (formatTag == 0xFFFE && chunkSize >= 40) {
+                formatTag = qFromLittleEndian<quint16>(chunk + 8 + 24);
+            }
+
+            if (formatTag == 1 && bits == 16) {
+                m_sampleFormat = Int16;
+                m_scale = 1.0;
+            } else if (formatTag == 3 && bits == 32) {
+                // 浮点WAV按 [-1, 1] 归一化, 换算到16位范围
+                m_sampleFormat = Float32;
+                m_scale = 32767.0;
+            } else {
+                m_errorString = QString("不支持的WAV格式 (格式 %1, %2 位)").arg(formatTag).arg(bits);
+                return false;
+            }
+
+            if (channels == 0) {
+                m_errorString = "WAV文件通道数为0";
+                return false;
+            }
+            m_channelCount = channels;
+            m_samplingRate = static_cast<int>(rate);
+            haveFormat = true;
+        } else if (std::memcmp(chunk, "data", 4) == 0) {
+            if (!haveFormat) {
+                m_errorString = "WAV文件缺少格式块";
+                return false;
+            }
+
+            // 录制中断的文件中数据块长度可能大于实际文件长度
+            m_dataOffset = pos + 8;
+            const qint64 dataSize = qMin<qint64>(chunkSize, m_mappingSize - m_dataOffset);
+            m_frameCount = dataSize / (bytesPerSample(m_sampleFormat) * m_channelCount);
+            return true;
+        }
+
+        // 块按2字节对齐
+        pos += 8 + static_cast<qint64>(chunkSize) + (chunkSize & 1);
+    }
+
+    m_errorString = "WAV文件中没有数据块";
+    return false;
+}
+
+bool SampleFileSource::parseRawMetadata(const QString &filePath)
+{
+    // 默认值: 按扩展名推断格式, 单通道
+    const QString suffix = QFileInfo(filePath).suffix().toLower();
+    QString format = suffix == "f32" ? "float32" : suffix == "f64" ? "float64" : "int16";
+    m_channelCount = 1;
+    m_samplingRate = 0;
+    m_dataOffset = 0;
+    m_scale = 1.0;
+
+    const QString metaPath = filePath + ".meta";
+    if (QFile::exists(metaPath)) {
+        QSettings meta(metaPath, QSettings::IniFormat);
+        format = meta.value("format", format).toString().toLower();
+        m_channelCount = meta.value("channels", 1).toInt();
+        m_samplingRate = meta.value("samplerate", 0).toInt();
+        m_dataOffset = meta.value("offset", 0).toLongLong();
+        m_scale = meta.value("scale", 1.0).toDouble();
+    }
+
+    if (format == "int16" || format == "s16") {
+        m_sampleFormat = Int16;
+    } else if (format == "float32" || format == "f32") {
+        m_sampleFormat = Float32;
+    } else if (format == "float64" || format == "f64") {
+        m_sampleFormat = Float64;
+    } else {
+        m_errorString = QString("不支持的采样格式: %1").arg(format);
+        return false;
+    }
+
+    if (m_channelCount <= 0 || m_dataOffset < 0 || m_dataOffset > m_mappingSize) {
+        m_errorString = "附属文件中的通道数或数据偏移无效";
+        return false;
+    }
+
+    m_frameCount = (m_mappingSize - m_dataOffset) / (bytesPerSample(m_sampleFormat) * m_channelCount);
+    return true;
+}
@@ -0,0 +1,80 @@
+#ifndef SAMPLEFILESOURCE_H
+#define SAMPLEFILESOURCE_H
+
+#include <QFile>
+#include <QString>
+
+#include "capturereader.h"
+
+// 内存映射的二进制采样文件数据源
+// 支持 WAV (16位PCM / 32位浮点) 以及原始 int16 / float32 文件, 文件通过 QFile::map 映射,
+// 读取数据块时直接从映射内存转换到调用方的缓冲区, 不会把整个文件读入内存.
+//
+// 原始文件的格式来自同名的 .meta 附属文件 (INI格式), 例如 capture.raw.meta:
+//   format=int16        ; int16, float32 或 float64
+//   channels=2
+//   samplerate=8000
+//   offset=0            ; 数据起始的字节偏移
+//   scale=1.0           ; 转换为 double 时乘以的系数
+// 没有附属文件时按扩展名推断格式 (.f32 为 float32, .f64 为 float64, 其余为 int16), 单通道.
+// 采集文件 (.sgc, 见 CaptureFormat) 按文件头识别, 由 CaptureReader 读取.
+class SampleFileSource
+{
+public:
+    enum SampleFormat {
+        Int16,
+        Float32,
+        Float64
+    };
+
+    SampleFileSource();
+    ~SampleFileSource();
+
+    // 判断文件是否应该按二进制格式读取 (扩展名或存在 .meta 附属文件)
+    static bool isBinaryFile(const QString &filePath);
+
+    bool open(const QString &filePath);
+    void close();
+    bool isOpen() const;
+    QString errorString() const;
+
+    SampleFormat getSampleFormat() const;
+    int getChannelCount() const;
+    int getSamplingRate() const;
+    qint64 getFrameCount() const;
+
+    // 读取位置 (单位: 帧)
+    qint64 getPosition() const;
+    void seek(qint64 frame);
+
+    // 从当前位置读取最多 maxFrames 帧的指定通道, 转换为 double 写入 output, 返回实际读取的帧数
+    int readBlock(double *output, int maxFrames, int channel = 0);
+
+    // 直接访问映射内存中的原始交织样本 (不拷贝), 格式由 getSampleFormat() 决定;
+    // 采集文件按块存储 (可能压缩), 返回 nullptr
+    const uchar *rawFrames(qint64 frame) const;
+
+private:
+    bool openCapture(const QString &filePath);
+    bool parseWavHeader();
+    bool parseRawMetadata(const QString &filePath);
+
+    QFile m_file;
+    CaptureReader m_capture;    // 采集文件
+    uchar *m_mapping;
+    qint64 m_mappingSize;
+
+    const uchar *m_data;    // 第一帧的位置
+    qint64 m_frameCount;
+    qint64 m_position;
+
+    SampleFormat m_sampleFormat;
+    int m_channelCount;
+    int m_samplingRate;
+    qint64 m_dataOffset;
+    double m_scale;
+
+    QString m_errorString;
+};
+
+#endif // SAMPLEFILESOURCE_H
@@ -5,6 +5,9 @@ greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
 CONFIG += c++17
 
+# 信号处理内核的循环依赖编译器自动向量化
+gcc|clang: QMAKE_CXXFLAGS_RELEASE += -O3
+
 # You can make your code fail to compile if it uses deprecated APIs.
 # In order to do so, uncomment the following line.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
@@ -13,17 +16,87 @@ SOURCES += \
     main.cpp \
     mainwindow.cpp \
     signalgenerator.cpp \
+    generatorworker.cpp \
+    nco.cpp \
+    multitonegenerator.cpp \
+    gaussiannoise.cpp \
+    modulator.cpp \
+    logbuffer.cpp \
+    simdkernels.cpp \
+    samplefilesource.cpp \
+    captureformat.cpp \
+    capturewriter.cpp \
+    capturereader.cpp \
+    streamrecorder.cpp \
+    textsampleparser.cpp \
     channelmodule.cpp \
+    delaylinefilter.cpp \
+    fadingchannel.cpp \
+    carrierimpairment.cpp \
+    clockdrift.cpp \
+    bersweep.cpp \
+    fft.cpp \
+    realfft.cpp \
+    spectrumanalyzer.cpp \
+    windowfunction.cpp \
+    fftconvolver.cpp \
+    firfilter.cpp \
+    movingaverage.cpp \
+    biquadcascade.cpp \
+    lowpassfilter.cpp \
+    polyphaseresampler.cpp \
+    decimator.cpp \
     receiveanalyzer.cpp \
     oscilloscope.cpp
 
 HEADERS += \
     mainwindow.h \
     signalgenerator.h \
+    generatorworker.h \
+    nco.h \
+    multitonegenerator.h \
+    gaussiannoise.h \
+    philox.h \
+    modulator.h \
+    logbuffer.h \
+    simdkernels.h \
+    simdkernels_p.h \
+    samplefilesource.h \
+    captureformat.h \
+    capturewriter.h \
+    capturereader.h \
+    streamrecorder.h \
+    textsampleparser.h \
     channelmodule.h \
+    delaylinefilter.h \
+    fadingchannel.h \
+    carrierimpairment.h \
+    clockdrift.h \
+    bersweep.h \
+    fft.h \
+    realfft.h \
+    spectrumanalyzer.h \
+    windowfunction.h \
+    fftconvolver.h \
+    firfilter.h \
+    movingaverage.h \
+    biquadcascade.h \
+    lowpassfilter.h \
+    polyphaseresampler.h \
+    decimator.h \
     receiveanalyzer.h \
     oscilloscope.h
 
+# x86 上额外编译 SSE2/AVX2/AVX-512 版本的内核 (文件内部切换目标指令集, 不需要额外编译选项),
+# 运行时根据CPUID选择
+contains(QT_ARCH, x86_64)|contains(QT_ARCH, i386) {
+    DEFINES += SIGNAL_GENERATOR_X86_SIMD
+    SOURCES += \
+        simdkernels_sse2.cpp \
+        simdkernels_avx2.cpp \
+        simdkernels_avx512.cpp
+}
+
 FORMS += \
     mainwindow.ui
 
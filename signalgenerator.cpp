@@ -1,4 +1,31 @@
 #include "signalgenerator.h"
+#include "generatorworker.h"
+#include "simdkernels.h"
+#include "textsampleparser.h"
+
+#include <QCoreApplication>
+#include <algorithm>
+#include <climits>
+
+static QString signalTypeName(SignalType type)
+{
+    return type == SINE_WAVE ? "正弦波" :
+           type == SQUARE_WAVE ? "方波" :
+           type == TRIANGLE_WAVE ? "三角波" :
+           type == SAWTOOTH_WAVE ? "锯齿波" :
+           type == MULTI_TONE ? "多音信号" :
+           type == AM_SIGNAL ? "AM调制" :
+           type == FM_SIGNAL ? "FM调制" :
+           type == BPSK_SIGNAL ? "BPSK调制" :
+           type == QPSK_SIGNAL ? "QPSK调制" :
+           type == QAM16_SIGNAL ? "16-QAM调制" : "文件数据";
+}
+
+static QString sampleFormatName(SampleFileSource::SampleFormat format)
+{
+    return format == SampleFileSource::Float32 ? "float32" :
+           format == SampleFileSource::Float64 ? "float64" : "int16";
+}
 
 SignalGenerator::SignalGenerator(QObject *parent) : QObject(parent),
     m_signalType(SINE_WAVE),
@@ -6,9 +33,18 @@ SignalGenerator::SignalGenerator(QObject *parent) : QObject(parent),
     m_amplitude(1.0),
     m_dcOffset(0.0),
     m_samplingRate(RATE_1KHZ),
+    m_fileReadPos(0),
+    m_streamingMode(false),
+    m_blockSize(1024),
+    m_sampleFormat(DOUBLE_SAMPLES),
+    m_worker(nullptr),
     m_isGenerating(false)
 {
+    connect(&m_logBuffer, &LogBuffer::entriesAdded, this, &SignalGenerator::logEntriesAdded);
+    updateFrequencySettings();
     appendToLog("信号发生器已初始化");
+    appendToLog(QString("信号处理内核指令集: %1").arg(
+                SimdKernels::instructionSetName(SimdKernels::activeInstructionSet())));
 }
 
 SignalGenerator::~SignalGenerator()
@@ -18,42 +54,253 @@ SignalGenerator::~SignalGenerator()
 
 void SignalGenerator::setSignalType(SignalType type)
 {
+    m_mutex.lock();
     m_signalType = type;
-    appendToLog(QString("信号类型设置为: %1").arg(
-                type == SINE_WAVE ? "正弦波" :
-                type == SQUARE_WAVE ? "方波" :
-                type == TRIANGLE_WAVE ? "三角波" : "文件数据"));
+    switch (type) {
+        case AM_SIGNAL:
+            m_modulator.setScheme(Modulator::AM);
+            break;
+        case FM_SIGNAL:
+            m_modulator.setScheme(Modulator::FM);
+            break;
+        case BPSK_SIGNAL:
+            m_modulator.setScheme(Modulator::BPSK);
+            break;
+        case QPSK_SIGNAL:
+            m_modulator.setScheme(Modulator::QPSK);
+            break;
+        case QAM16_SIGNAL:
+            m_modulator.setScheme(Modulator::QAM16);
+            break;
+        default:
+            break;
+    }
+    m_mutex.unlock();
+    if (type == MULTI_TONE) {
+        // 采样率可能在播放文件时按文件头改变过
+        updateToneTable();
+    }
+    appendToLog(QString("信号类型设置为: %1").arg(signalTypeName(type)));
 }
 
 void SignalGenerator::setFrequency(double freq)
 {
+    m_mutex.lock();
     m_frequency = freq;
+    updateFrequencySettings();
+    m_mutex.unlock();
     appendToLog(QString("频率设置为: %1 Hz").arg(freq));
 }
 
 void SignalGenerator::setAmplitude(double amp)
 {
+    m_mutex.lock();
     m_amplitude = amp;
+    m_mutex.unlock();
     appendToLog(QString("幅度设置为: %1").arg(amp));
 }
 
 void SignalGenerator::setDCOffset(double offset)
 {
+    m_mutex.lock();
     m_dcOffset = offset;
+    m_mutex.unlock();
     appendToLog(QString("DC偏置设置为: %1").arg(offset));
 }
 
 void SignalGenerator::setSamplingRate(SamplingRate rate)
 {
+    m_mutex.lock();
     m_samplingRate = rate;
+    updateFrequencySettings();
+    m_mutex.unlock();
+    updateToneTable();
     appendToLog(QString("采样率设置为: %1 Hz").arg(static_cast<int>(rate)));
 }
 
 void SignalGenerator::setDataFromFile(const QString &filePath)
 {
     m_filePath = filePath;
-    m_signalType = FILE_DATA;
     appendToLog(QString("数据文件设置为: %1").arg(filePath));
+
+    // 流模式运行中切换文件时立即加载, 工作线程从下一个块开始播放新数据
+    bool reload = m_isGenerating && m_streamingMode;
+    bool binary = SampleFileSource::isBinaryFile(filePath);
+    QVector<double> fileData;
+    if (reload && !binary) {
+        fileData = loadDataFromFile();
+    }
+
+    const SamplingRate previousRate = m_samplingRate;
+    m_mutex.lock();
+    m_signalType = FILE_DATA;
+    if (reload) {
+        m_fileSource.close();
+        m_fileData = fileData;
+        m_fileReadPos = 0;
+        if (binary) {
+            openFileSource();
+        }
+    }
+    m_mutex.unlock();
+
+    // 采样率只在界面线程中修改, 解锁后发出
+    if (m_samplingRate != previousRate) {
+        emit samplingRateChanged(m_samplingRate);
+    }
+}
+
+void SignalGenerator::setAntiAliasing(bool enabled)
+{
+    m_mutex.lock();
+    m_nco.setBandLimited(enabled);
+    m_mutex.unlock();
+    appendToLog(QString("抗混叠(PolyBLEP)生成: %1").arg(enabled ? "开启" : "关闭"));
+}
+
+bool SignalGenerator::isAntiAliasing() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_nco.isBandLimited();
+}
+
+void SignalGenerator::setTones(const QVector<MultiToneGenerator::Tone> &tones)
+{
+    m_mutex.lock();
+    m_multiTone.setTones(tones);
+    m_mutex.unlock();
+    updateToneTable();
+
+    m_mutex.lock();
+    bool periodic = m_multiTone.isPeriodic();
+    m_mutex.unlock();
+    appendToLog(QString("多音信号单音数: %1%2").arg(tones.size()).arg(periodic ? " (周期表)" : ""));
+}
+
+void SignalGenerator::setChirp(double startFrequency, double stopFrequency, double duration, double amplitude)
+{
+    m_mutex.lock();
+    m_multiTone.setChirp(startFrequency, stopFrequency, duration, amplitude);
+    m_mutex.unlock();
+    if (amplitude != 0.0) {
+        appendToLog(QString("扫频: %1 Hz -> %2 Hz, 时长 %3 s, 幅度 %4")
+                    .arg(startFrequency).arg(stopFrequency).arg(duration).arg(amplitude));
+    } else {
+        appendToLog("扫频: 关闭");
+    }
+}
+
+void SignalGenerator::setCompositeNoise(double amplitude)
+{
+    m_mutex.lock();
+    m_multiTone.setNoiseAmplitude(amplitude);
+    m_mutex.unlock();
+    appendToLog(QString("多音信号附加噪声幅度设置为: %1").arg(amplitude));
+}
+
+void SignalGenerator::setSymbolRate(double symbolRate)
+{
+    m_mutex.lock();
+    m_modulator.setSymbolRate(symbolRate);
+    double actualRate = m_modulator.getSymbolRate();
+    int samplesPerSymbol = m_modulator.getSamplesPerSymbol();
+    m_mutex.unlock();
+    appendToLog(QString("符号率设置为: %1 Hz (每符号%2个样本)").arg(actualRate).arg(samplesPerSymbol));
+}
+
+void SignalGenerator::setBitSource(Modulator::BitSource source)
+{
+    m_mutex.lock();
+    m_modulator.setBitSource(source);
+    m_mutex.unlock();
+    appendToLog(source == Modulator::CustomBits ? QString("比特源: 自定义序列")
+                                                : QString("比特源: PRBS%1").arg(static_cast<int>(source)));
+}
+
+void SignalGenerator::setCustomBits(const QVector<quint8> &bits)
+{
+    m_mutex.lock();
+    m_modulator.setCustomBits(bits);
+    m_mutex.unlock();
+    appendToLog(QString("自定义比特序列长度: %1").arg(bits.size()));
+}
+
+void SignalGenerator::setRollOff(double rollOff)
+{
+    m_mutex.lock();
+    m_modulator.setRollOff(rollOff);
+    m_mutex.unlock();
+    appendToLog(QString("成形滤波器滚降系数设置为: %1").arg(rollOff));
+}
+
+void SignalGenerator::setModulationIndex(double index)
+{
+    m_mutex.lock();
+    m_modulator.setModulationIndex(index);
+    m_mutex.unlock();
+    appendToLog(QString("AM调制深度设置为: %1").arg(index));
+}
+
+void SignalGenerator::setFrequencyDeviation(double deviation)
+{
+    m_mutex.lock();
+    m_modulator.setFrequencyDeviation(deviation);
+    m_mutex.unlock();
+    appendToLog(QString("FM频偏设置为: %1 Hz").arg(deviation));
+}
+
+void SignalGenerator::setStreamingMode(bool enabled)
+{
+    if (m_isGenerating) {
+        appendToLog("生成信号过程中不能切换流模式");
+        return;
+    }
+
+    m_streamingMode = enabled;
+    appendToLog(QString("连续流模式: %1").arg(enabled ? "开启" : "关闭"));
+}
+
+bool SignalGenerator::isStreamingMode() const
+{
+    return m_streamingMode;
+}
+
+void SignalGenerator::setBlockSize(int blockSize)
+{
+    blockSize = qBound(MIN_BLOCK_SIZE, blockSize, MAX_BLOCK_SIZE);
+
+    m_mutex.lock();
+    m_blockSize = blockSize;
+    m_mutex.unlock();
+    appendToLog(QString("块大小设置为: %1").arg(blockSize));
+}
+
+int SignalGenerator::getBlockSize() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_blockSize;
+}
+
+void SignalGenerator::setSampleFormat(SampleFormat format)
+{
+    if (m_isGenerating) {
+        appendToLog("生成信号过程中不能切换样本格式");
+        return;
+    }
+
+    m_sampleFormat = format;
+    appendToLog(QString("数据通路样本格式: %1").arg(format == INT16_SAMPLES ? "16位定点" : "double"));
+}
+
+SampleFormat SignalGenerator::getSampleFormat() const
+{
+    return m_sampleFormat;
+}
+
+SamplingRate SignalGenerator::getSamplingRate() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_samplingRate;
 }
 
 void SignalGenerator::startGeneration()
@@ -64,27 +311,74 @@ void SignalGenerator::startGeneration()
     
     m_isGenerating = true;
     appendToLog("开始生成信号");
+    m_generatedData.clear();
+    m_generatedData16.clear();
     
-    // 根据当前设置生成信号数据
-    int numSamples = static_cast<int>(m_samplingRate) * 2; // 生成2秒的数据
+    // 每次启动从零相位开始
+    m_nco.reset();
+    m_multiTone.reset();
+    m_modulator.reset();
+    m_fileReadPos = 0;
+    m_fileData.clear();
+    m_fileSource.close();
+    if (m_signalType == FILE_DATA) {
+        const SamplingRate previousRate = m_samplingRate;
+        if (SampleFileSource::isBinaryFile(m_filePath)) {
+            openFileSource();
+        } else {
+            m_fileData = loadDataFromFile();
+        }
+        // 下游模块在收到数据之前同步采样率
+        if (m_samplingRate != previousRate) {
+            emit samplingRateChanged(m_samplingRate);
+        }
+    }
     
-    switch (m_signalType) {
-        case SINE_WAVE:
-            m_generatedData = generateSineWave(numSamples);
-            break;
-        case SQUARE_WAVE:
-            m_generatedData = generateSquareWave(numSamples);
-            break;
-        case TRIANGLE_WAVE:
-            m_generatedData = generateTriangleWave(numSamples);
-            break;
-        case FILE_DATA:
-            m_generatedData = loadDataFromFile();
-            break;
+    if (m_streamingMode) {
+        appendToLog(QString("以连续流模式运行, 块大小: %1").arg(m_blockSize));
+        m_worker = new GeneratorWorker(this);
+        connect(m_worker, &GeneratorWorker::blockReady,
+                this, &SignalGenerator::onBlockReady, Qt::QueuedConnection);
+        connect(m_worker, &GeneratorWorker::blockReady16,
+                this, &SignalGenerator::onBlockReady16, Qt::QueuedConnection);
+        m_worker->start();
+        return;
+    }
+    
+    // 单次模式: 生成2秒的数据
+    if (m_signalType == FILE_DATA && m_fileSource.isOpen()) {
+        // 单次模式的结果整块交给下游, 只读取文件开头的一段
+        const qint64 frameCount = m_fileSource.getFrameCount();
+        int numSamples = static_cast<int>(qMin<qint64>(frameCount, MAX_ONE_SHOT_FILE_SAMPLES));
+        if (frameCount > numSamples) {
+            appendToLog(QString("文件有 %1 帧, 单次模式只读取前 %2 帧, 完整播放请使用连续流模式")
+                        .arg(frameCount).arg(numSamples));
+        }
+        m_generatedData.resize(numSamples);
+        const int read = m_fileSource.readBlock(m_generatedData.data(), numSamples);
+        if (read < numSamples) {
+            appendToLog(QString("读取文件失败: %1").arg(m_fileSource.errorString()));
+            m_generatedData.resize(read);
+        }
+        SimdKernels::clamp(m_generatedData.data(), read, -32768.0, 32767.0);
+    } else if (m_signalType == FILE_DATA) {
+        m_generatedData = m_fileData;
+    } else {
+        int numSamples = static_cast<int>(m_samplingRate) * 2;
+        m_generatedData.resize(numSamples);
+        generateBlock(m_generatedData.data(), numSamples);
+        appendToLog(QString("生成%1信号, 样本数: %2").arg(signalTypeName(m_signalType)).arg(numSamples));
     }
     
     // 发送生成的信号数据
-    emit signalGenerated(m_generatedData);
+    if (m_sampleFormat == INT16_SAMPLES) {
+        m_generatedData16.resize(m_generatedData.size());
+        SimdKernels::convertToInt16(m_generatedData.constData(), m_generatedData16.data(), m_generatedData.size());
+        m_generatedData.clear();
+        emit signalGenerated16(m_generatedData16);
+    } else {
+        emit signalGenerated(m_generatedData);
+    }
 }
 
 void SignalGenerator::stopGeneration()
@@ -94,6 +388,18 @@ void SignalGenerator::stopGeneration()
     }
     
     m_isGenerating = false;
+    
+    if (m_worker) {
+        m_worker->requestInterruption();
+        m_worker->wait();
+        delete m_worker;
+        m_worker = nullptr;
+        
+        // 丢弃已排队但尚未处理的数据块
+        QCoreApplication::removePostedEvents(this, QEvent::MetaCall);
+    }
+    
+    m_fileSource.close();
     appendToLog("停止生成信号");
 }
 
@@ -107,117 +413,210 @@ QVector<double> SignalGenerator::getGeneratedData() const
     return m_generatedData;
 }
 
+QVector<qint16> SignalGenerator::getGeneratedData16() const
+{
+    return m_generatedData16;
+}
+
 void SignalGenerator::appendToLog(const QString &message)
 {
-    QString timeStamp = QDateTime::currentDateTime().toString("[yyyy-MM-dd hh:mm:ss.zzz] ");
-    QString logEntry = timeStamp + message;
-    m_log.append(logEntry + "\n");
-    emit logUpdated(m_log);
-    qDebug() << logEntry;
+    m_logBuffer.append(message);
 }
 
 QString SignalGenerator::getLog() const
 {
-    return m_log;
+    return m_logBuffer.toString();
+}
+
+void SignalGenerator::setLogEchoToDebug(bool enabled)
+{
+    m_logBuffer.setEchoToDebug(enabled);
 }
 
-QVector<double> SignalGenerator::generateSineWave(int numSamples)
+void SignalGenerator::onBlockReady(int slot)
 {
-    QVector<double> data;
-    data.reserve(numSamples);
+    if (!m_worker) {
+        return;
+    }
     
-    double timeStep = 1.0 / m_samplingRate;
-    double angularFreq = 2.0 * M_PI * m_frequency;
+    // 新块换入 m_generatedData, 上一个块的缓冲区留给工作线程复用.
+    // 下游的槽函数不保留数据的引用 (需要时复制内容)
+    m_worker->takeBlock(slot, m_generatedData);
+    emit signalGenerated(m_generatedData);
     
-    for (int i = 0; i < numSamples; ++i) {
-        double time = i * timeStep;
-        double value = m_amplitude * qSin(angularFreq * time) + m_dcOffset;
-        
-        // 将值限制在16位有符号整数范围内 (-32768 到 32767)
-        value = qBound(-32768.0, value, 32767.0);
-        
-        data.append(value);
+    // 下游处理完成, 归还缓冲区 (下游可能已经停止了生成)
+    if (m_worker) {
+        m_worker->releaseBlock();
     }
-    
-    appendToLog(QString("生成正弦波信号, 样本数: %1").arg(numSamples));
-    return data;
 }
 
-QVector<double> SignalGenerator::generateSquareWave(int numSamples)
+void SignalGenerator::onBlockReady16(int slot)
 {
-    QVector<double> data;
-    data.reserve(numSamples);
-    
-    double timeStep = 1.0 / m_samplingRate;
-    double period = 1.0 / m_frequency;
-    
-    for (int i = 0; i < numSamples; ++i) {
-        double time = i * timeStep;
-        double phase = fmod(time, period) / period;
-        double value = (phase < 0.5 ? m_amplitude : -m_amplitude) + m_dcOffset;
-        
-        // 将值限制在16位有符号整数范围内
-        value = qBound(-32768.0, value, 32767.0);
-        
-        data.append(value);
+    if (!m_worker) {
+        return;
     }
     
-    appendToLog(QString("生成方波信号, 样本数: %1").arg(numSamples));
-    return data;
+    m_worker->takeBlock16(slot, m_generatedData16);
+    emit signalGenerated16(m_generatedData16);
+    if (m_worker) {
+        m_worker->releaseBlock();
+    }
 }
 
-QVector<double> SignalGenerator::generateTriangleWave(int numSamples)
+void SignalGenerator::generateBlock(double *output, int numSamples)
 {
-    QVector<double> data;
-    data.reserve(numSamples);
+    QMutexLocker locker(&m_mutex);
     
-    double timeStep = 1.0 / m_samplingRate;
-    double period = 1.0 / m_frequency;
-    
-    for (int i = 0; i < numSamples; ++i) {
-        double time = i * timeStep;
-        double phase = fmod(time, period) / period;
-        
-        double value;
-        if (phase < 0.5) {
-            value = (4.0 * phase - 1.0) * m_amplitude;
-        } else {
-            value = (3.0 - 4.0 * phase) * m_amplitude;
+    switch (m_signalType) {
+        case SINE_WAVE:
+            m_nco.generate(Nco::Sine, output, numSamples, m_amplitude, m_dcOffset);
+            break;
+        case SQUARE_WAVE:
+            m_nco.generate(Nco::Square, output, numSamples, m_amplitude, m_dcOffset);
+            break;
+        case TRIANGLE_WAVE:
+            m_nco.generate(Nco::Triangle, output, numSamples, m_amplitude, m_dcOffset);
+            break;
+        case SAWTOOTH_WAVE:
+            m_nco.generate(Nco::Sawtooth, output, numSamples, m_amplitude, m_dcOffset);
+            break;
+        case MULTI_TONE:
+            m_multiTone.generate(output, numSamples, m_dcOffset);
+            break;
+        case AM_SIGNAL:
+        case FM_SIGNAL:
+        case BPSK_SIGNAL:
+        case QPSK_SIGNAL:
+        case QAM16_SIGNAL:
+            m_modulator.generate(output, numSamples, m_amplitude, m_dcOffset);
+            break;
+        case FILE_DATA:
+            readFileBlock(output, numSamples);
+            break;
+    }
+}
+
+void SignalGenerator::generateBlock16(qint16 *output, int numSamples)
+{
+    double tile[CONVERT_TILE_SIZE];
+    for (int start = 0; start < numSamples; start += CONVERT_TILE_SIZE) {
+        const int count = qMin(CONVERT_TILE_SIZE, numSamples - start);
+        generateBlock(tile, count);
+        SimdKernels::convertToInt16(tile, output + start, count);
+    }
+}
+
+void SignalGenerator::readFileBlock(double *output, int numSamples)
+{
+    // 文件数据循环播放
+    if (m_fileSource.isOpen() && m_fileSource.getFrameCount() > 0) {
+        int written = 0;
+        bool rewound = false;
+        while (written < numSamples) {
+            const int count = m_fileSource.readBlock(output + written, numSamples - written);
+            if (count > 0) {
+                written += count;
+                rewound = false;
+                continue;
+            }
+            if (rewound || m_fileSource.getFrameCount() == 0) {
+                // 从头也读不出数据 (文件损坏), 停止文件源, 以后输出0
+                std::fill(output + written, output + numSamples, 0.0);
+                appendToLog(QString("读取文件失败, 停止播放: %1").arg(m_fileSource.errorString()));
+                m_fileSource.close();
+                break;
+            }
+            m_fileSource.seek(0);
+            rewound = true;
         }
-        value += m_dcOffset;
-        
-        // 将值限制在16位有符号整数范围内
-        value = qBound(-32768.0, value, 32767.0);
-        
-        data.append(value);
+        SimdKernels::clamp(output, numSamples, -32768.0, 32767.0);
+        return;
     }
     
-    appendToLog(QString("生成三角波信号, 样本数: %1").arg(numSamples));
-    return data;
+    if (m_fileData.isEmpty()) {
+        std::fill(output, output + numSamples, 0.0);
+        return;
+    }
+    
+    int written = 0;
+    while (written < numSamples) {
+        int count = qMin(numSamples - written, m_fileData.size() - m_fileReadPos);
+        std::copy(m_fileData.constData() + m_fileReadPos,
+                  m_fileData.constData() + m_fileReadPos + count,
+                  output + written);
+        written += count;
+        m_fileReadPos = (m_fileReadPos + count) % m_fileData.size();
+    }
 }
 
 QVector<double> SignalGenerator::loadDataFromFile()
 {
-    QVector<double> data;
+    TextSampleParser parser;
+    if (!parser.parseFile(m_filePath)) {
+        appendToLog(parser.errorString());
+        return QVector<double>();
+    }
+    
+    QVector<double> data = parser.getSamples();
     
-    QFile file(m_filePath);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        appendToLog(QString("无法打开文件: %1").arg(m_filePath));
-        return data;
+    // 将值限制在16位有符号整数范围内
+    SimdKernels::clamp(data.data(), data.size(), -32768.0, 32767.0);
+    appendToLog(QString("从文件加载数据, 样本数: %1, 注释行: %2, 无效行: %3")
+                .arg(data.size()).arg(parser.getCommentLineCount()).arg(parser.getRejectedLineCount()));
+    return data;
+}
+
+bool SignalGenerator::openFileSource()
+{
+    if (!m_fileSource.open(m_filePath)) {
+        appendToLog(QString("无法读取二进制文件 %1: %2").arg(m_filePath, m_fileSource.errorString()));
+        return false;
     }
     
-    QTextStream in(&file);
-    while (!in.atEnd()) {
-        bool ok;
-        double value = in.readLine().trimmed().toDouble(&ok);
-        if (ok) {
-            // 将值限制在16位有符号整数范围内
-            value = qBound(-32768.0, value, 32767.0);
-            data.append(value);
+    appendToLog(QString("映射二进制文件, 格式: %1, 通道数: %2, 帧数: %3")
+                .arg(sampleFormatName(m_fileSource.getSampleFormat()))
+                .arg(m_fileSource.getChannelCount())
+                .arg(m_fileSource.getFrameCount()));
+    
+    // 采样率取自文件头, 仅支持的采样率会被采用
+    int fileRate = m_fileSource.getSamplingRate();
+    if (fileRate == RATE_1KHZ || fileRate == RATE_2KHZ || fileRate == RATE_4KHZ || fileRate == RATE_8KHZ) {
+        m_samplingRate = static_cast<SamplingRate>(fileRate);
+        updateFrequencySettings();
+        appendToLog(QString("采样率按文件设置为: %1 Hz").arg(fileRate));
+    } else if (fileRate > 0) {
+        appendToLog(QString("文件采样率 %1 Hz 不受支持, 按 %2 Hz 播放")
+                    .arg(fileRate).arg(static_cast<int>(m_samplingRate)));
+    }
+    return true;
+}
+
+void SignalGenerator::updateFrequencySettings()
+{
+    // 调用者持有 m_mutex; 多音周期表由调用者解锁后用 updateToneTable() 更新
+    m_nco.setFrequency(m_frequency, m_samplingRate);
+    m_multiTone.setSamplingRate(m_samplingRate);
+    m_modulator.setCarrier(m_frequency, m_samplingRate);
+}
+
+void SignalGenerator::updateToneTable()
+{
+    // 周期表可能有上百万个样本, 合成期间不持有锁, 工作线程继续用振荡器组生成;
+    // 合成期间参数又被修改时按新参数重新合成
+    for (;;) {
+        m_mutex.lock();
+        const bool pending = m_multiTone.isPeriodTablePending();
+        const QVector<MultiToneGenerator::Tone> tones = m_multiTone.getTones();
+        const double samplingRate = m_multiTone.getSamplingRate();
+        m_mutex.unlock();
+        if (!pending) {
+            return;
+        }
+
+        const QVector<double> table = MultiToneGenerator::buildPeriodTable(tones, samplingRate);
+        QMutexLocker locker(&m_mutex);
+        if (m_multiTone.setPeriodTable(tones, samplingRate, table)) {
+            return;
         }
     }
-    
-    file.close();
-    appendToLog(QString("从文件加载数据, 样本数: %1").arg(data.size()));
-    return data;
-} 
\ No newline at end of file
+}
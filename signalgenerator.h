@@ -9,12 +9,26 @@
 #include <QDebug>
 #include <QtMath>
 #include <QRandomGenerator>
+#include <QMutex>
+
+#include "nco.h"
+#include "multitonegenerator.h"
+#include "modulator.h"
+#include "logbuffer.h"
+#include "samplefilesource.h"
 
 // 信号类型枚举
 enum SignalType {
     SINE_WAVE,      // 正弦波
     SQUARE_WAVE,    // 方波
     TRIANGLE_WAVE,  // 三角波
+    SAWTOOTH_WAVE,  // 锯齿波
+    MULTI_TONE,     // 多音复合信号
+    AM_SIGNAL,      // 调幅
+    FM_SIGNAL,      // 调频
+    BPSK_SIGNAL,    // 二进制相移键控
+    QPSK_SIGNAL,    // 四相相移键控
+    QAM16_SIGNAL,   // 16-QAM
     FILE_DATA       // 文件数据
 };
 
@@ -26,6 +40,14 @@ enum SamplingRate {
     RATE_8KHZ = 8000
 };
 
+// 数据通路的样本格式
+enum SampleFormat {
+    DOUBLE_SAMPLES, // double
+    INT16_SAMPLES   // 16位定点, 内存和带宽为double的1/4
+};
+
+class GeneratorWorker;
+
 class SignalGenerator : public QObject
 {
     Q_OBJECT
@@ -40,6 +62,32 @@ public:
     void setDCOffset(double offset);
     void setSamplingRate(SamplingRate rate);
     void setDataFromFile(const QString &filePath);
+    void setAntiAliasing(bool enabled);
+    bool isAntiAliasing() const;
+
+    // 多音复合信号的组成 (单音的幅度和DC偏置使用同一单位)
+    void setTones(const QVector<MultiToneGenerator::Tone> &tones);
+    void setChirp(double startFrequency, double stopFrequency, double duration, double amplitude);
+    void setCompositeNoise(double amplitude);
+
+    // 调制信号源参数, 载波频率使用 setFrequency() 设置的频率
+    void setSymbolRate(double symbolRate);
+    void setBitSource(Modulator::BitSource source);
+    void setCustomBits(const QVector<quint8> &bits);
+    void setRollOff(double rollOff);
+    void setModulationIndex(double index);
+    void setFrequencyDeviation(double deviation);
+
+    // 连续流模式: 按采样率持续输出固定大小的数据块, 直到stopGeneration()
+    void setStreamingMode(bool enabled);
+    bool isStreamingMode() const;
+    void setBlockSize(int blockSize);
+    int getBlockSize() const;
+
+    // 16位定点模式下输出 signalGenerated16(), 只能在未生成信号时切换
+    void setSampleFormat(SampleFormat format);
+    SampleFormat getSampleFormat() const;
+    SamplingRate getSamplingRate() const;
 
     // 开始/停止生成信号
     void startGeneration();
@@ -48,19 +96,46 @@ public:
     // 获取当前状态和数据
     bool isGenerating() const;
     QVector<double> getGeneratedData() const;
+    QVector<qint16> getGeneratedData16() const;
+
+    // 生成下一个数据块到调用者提供的缓冲区, 相位在块之间保持连续 (内部加锁, 可在任意线程调用).
+    // 不分配内存, 流模式的工作线程也通过这里生成数据
+    void generateBlock(double *output, int numSamples);
+    // 16位版本按 CONVERT_TILE_SIZE 个样本分段生成并转换, 中间结果留在栈上
+    void generateBlock16(qint16 *output, int numSamples);
+    // 日志: 可以在任意线程调用, 新增的条目通过 logEntriesAdded() 增量发送
     void appendToLog(const QString &message);
     QString getLog() const;
+    void setLogEchoToDebug(bool enabled);
+
+    // 块大小范围
+    static const int MIN_BLOCK_SIZE = 256;
+    static const int MAX_BLOCK_SIZE = 65536;
+    static const int CONVERT_TILE_SIZE = 1024;
+    // 单次模式从二进制文件读取的最多样本数, 更长的文件请用连续流模式播放
+    static const int MAX_ONE_SHOT_FILE_SAMPLES = 1 << 22;
 
 signals:
     void signalGenerated(const QVector<double> &data);
-    void logUpdated(const QString &log);
+    void signalGenerated16(const QVector<qint16> &data);
+    void logEntriesAdded(const QVector<LogEntry> &entries);
+    // 采样率按二进制文件头改变 (加载文件或开始播放时)
+    void samplingRateChanged(SamplingRate rate);
+
+private slots:
+    void onBlockReady(int slot);
+    void onBlockReady16(int slot);
 
 private:
+    friend class GeneratorWorker;
+
     // 生成数据的函数
-    QVector<double> generateSineWave(int numSamples);
-    QVector<double> generateSquareWave(int numSamples);
-    QVector<double> generateTriangleWave(int numSamples);
+    void readFileBlock(double *output, int numSamples);
     QVector<double> loadDataFromFile();
+    bool openFileSource();
+    void updateFrequencySettings();
+    // 在锁外为当前的单音和采样率合成多音周期表后装入; 不能在持有 m_mutex 时调用
+    void updateToneTable();
 
     // 属性
     SignalType m_signalType;
@@ -70,9 +145,24 @@ private:
     SamplingRate m_samplingRate;
     QString m_filePath;
     
+    // 块之间保持连续的状态
+    Nco m_nco;                  // 所有波形共享的相位累加器
+    MultiToneGenerator m_multiTone;
+    Modulator m_modulator;      // 调制信号源, 成形滤波器和载波状态在块之间保持
+    QVector<double> m_fileData; // 流模式下循环播放的文本文件数据
+    int m_fileReadPos;
+    SampleFileSource m_fileSource; // 二进制采样文件, 直接从映射内存读取
+
+    bool m_streamingMode;
+    int m_blockSize;
+    SampleFormat m_sampleFormat;
+    GeneratorWorker *m_worker;
+    mutable QMutex m_mutex;     // 保护参数和块间状态, 工作线程与界面线程共享
+
     bool m_isGenerating;
     QVector<double> m_generatedData;
-    QString m_log;
+    QVector<qint16> m_generatedData16;
+    LogBuffer m_logBuffer;
 };
 
 #endif // SIGNALGENERATOR_H 
\ No newline at end of file
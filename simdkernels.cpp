@@ -0,0 +1,231 @@
+#include "simdkernels_p.h"
+
+#include <QByteArray>
+
+#if defined(SIGNAL_GENERATOR_X86_SIMD) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace SimdKernels {
+
+// 标量实现: 宽度为1的通用内核, 也是非x86平台上唯一的实现
+namespace ScalarImpl {
+
+SIMD_KERNELS_DEFINE_TABLE(ScalarIsa, Scalar)
+
+} // namespace ScalarImpl
+
+//
+// 运行时指令集检测
+//
+#ifdef SIGNAL_GENERATOR_X86_SIMD
+static InstructionSet detectInstructionSet()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+
+    __cpuid(info, 1);
+    const bool hasSse2 = (info[3] & (1 << 26)) != 0;
+    const bool hasOsxsave = (info[2] & (1 << 27)) != 0;
+    const bool hasAvx = (info[2] & (1 << 28)) != 0;
+    if (!hasSse2) {
+        return Scalar;
+    }
+    if (!hasOsxsave || !hasAvx || maxLeaf < 7) {
+        return SSE2;
+    }
+
+    // 操作系统必须保存 YMM (以及 AVX-512 的 opmask/ZMM) 寄存器状态
+    const unsigned long long xcr0 = _xgetbv(0);
+    __cpuidex(info, 7, 0);
+    const bool hasAvx2 = (info[1] & (1 << 5)) != 0 && (xcr0 & 0x6) == 0x6;
+    const bool hasAvx512f = (info[1] & (1 << 16)) != 0 && (xcr0 & 0xE6) == 0xE6;
+    if (hasAvx512f && hasAvx2) {
+        return AVX512;
+    }
+    return hasAvx2 ? AVX2 : SSE2;
+#else
+    // __builtin_cpu_supports 同时检查操作系统是否启用了对应的寄存器状态
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx2")) {
+        return AVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return AVX2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return SSE2;
+    }
+    return Scalar;
+#endif
+}
+#endif
+
+static const KernelTable &selectKernels()
+{
+    InstructionSet isa = Scalar;
+#ifdef SIGNAL_GENERATOR_X86_SIMD
+    isa = detectInstructionSet();
+#endif
+
+    // 允许通过环境变量限制最高指令集, 便于在同一台机器上对比各版本
+    const QByteArray limit = qgetenv("SIGNAL_GENERATOR_SIMD").toLower();
+    if (limit == "scalar") {
+        isa = Scalar;
+    } else if (limit == "sse2") {
+        isa = qMin(isa, SSE2);
+    } else if (limit == "avx2") {
+        isa = qMin(isa, AVX2);
+    }
+
+    switch (isa) {
+#ifdef SIGNAL_GENERATOR_X86_SIMD
+        case AVX512:
+            return Avx512Impl::kernelTable();
+        case AVX2:
+            return Avx2Impl::kernelTable();
+        case SSE2:
+            return Sse2Impl::kernelTable();
+#endif
+        default:
+            return ScalarImpl::kernelTable();
+    }
+}
+
+static const KernelTable &kernels()
+{
+    static const KernelTable &table = selectKernels();
+    return table;
+}
+
+//
+// 公共接口
+//
+InstructionSet activeInstructionSet()
+{
+    return kernels().isa;
+}
+
+const char *instructionSetName(InstructionSet isa)
+{
+    switch (isa) {
+        case SSE2:
+            return "SSE2";
+        case AVX2:
+            return "AVX2";
+        case AVX512:
+            return "AVX-512";
+        default:
+            return "Scalar";
+    }
+}
+
+void generateSine(quint64 &phase, quint64 increment, double amplitude, double offset,
+                  double *output, int numSamples)
+{
+    kernels().generateSine(phase, increment, amplitude, offset, output, numSamples);
+}
+
+void generateSquare(quint64 &phase, quint64 increment, double amplitude, double offset,
+                    double *output, int numSamples)
+{
+    kernels().generateSquare(phase, increment, amplitude, offset, output, numSamples);
+}
+
+void generateTriangle(quint64 &phase, quint64 increment, double amplitude, double offset,
+                      double *output, int numSamples)
+{
+    kernels().generateTriangle(phase, increment, amplitude, offset, output, numSamples);
+}
+
+void generateSawtooth(quint64 &phase, quint64 increment, double amplitude, double offset,
+                      double *output, int numSamples)
+{
+    kernels().generateSawtooth(phase, increment, amplitude, offset, output, numSamples);
+}
+
+void generateSquareBandLimited(quint64 &phase, quint64 increment, double amplitude, double offset,
+                               double *output, int numSamples)
+{
+    kernels().generateSquareBandLimited(phase, increment, amplitude, offset, output, numSamples);
+}
+
+void generateTriangleBandLimited(quint64 &phase, quint64 increment, double amplitude, double offset,
+                                 double *output, int numSamples)
+{
+    kernels().generateTriangleBandLimited(phase, increment, amplitude, offset, output, numSamples);
+}
+
+void generateSawtoothBandLimited(quint64 &phase, quint64 increment, double amplitude, double offset,
+                                 double *output, int numSamples)
+{
+    kernels().generateSawtoothBandLimited(phase, increment, amplitude, offset, output, numSamples);
+}
+
+void addScaledNoise(const double *input, const double *noise, double scale,
+                    double *output, int numSamples)
+{
+    kernels().addScaledNoise(input, noise, scale, output, numSamples);
+}
+
+void clamp(double *data, int numSamples, double lower, double upper)
+{
+    kernels().clamp(data, numSamples, lower, upper);
+}
+
+void convertToInt16(const double *input, qint16 *output, int numSamples)
+{
+    kernels().convertToInt16(input, output, numSamples);
+}
+
+void convertFromInt16(const qint16 *input, double *output, int numSamples)
+{
+    kernels().convertFromInt16(input, output, numSamples);
+}
+
+void addScaledNoiseInt16(const qint16 *input, const double *noise, double scale,
+                         qint16 *output, int numSamples)
+{
+    kernels().addScaledNoiseInt16(input, noise, scale, output, numSamples);
+}
+
+int gaussianCandidates(const quint32 *key, quint64 firstBlock, const double *layerAccept,
+                       const double *layerWidth, double *output, int numSamples, int *rejected)
+{
+    return kernels().gaussianCandidates(key, firstBlock, layerAccept, layerWidth, output, numSamples, rejected);
+}
+
+void accumulateTone(double &re, double &im, double stepRe, double stepIm,
+                    double *output, int numSamples)
+{
+    kernels().accumulateTone(re, im, stepRe, stepIm, output, numSamples);
+}
+
+void multiplyAccumulate(const double *input, double gain, double *output, int numSamples)
+{
+    kernels().multiplyAccumulate(input, gain, output, numSamples);
+}
+
+void multiplyComplex(double *re, double *im, const double *gainRe, const double *gainIm, int numSamples)
+{
+    kernels().multiplyComplex(re, im, gainRe, gainIm, numSamples);
+}
+
+void rotatePhase(double *re, double *im, const double *phase, int numSamples)
+{
+    kernels().rotatePhase(re, im, phase, numSamples);
+}
+
+void interpolateCubic(const double *input, double position, double step, double *output, int numOutputs)
+{
+    kernels().interpolateCubic(input, position, step, output, numOutputs);
+}
+
+void convolve(const double *input, const double *taps, int numTaps, double *output, int numOutputs)
+{
+    kernels().convolve(input, taps, numTaps, output, numOutputs);
+}
+
+} // namespace SimdKernels
@@ -0,0 +1,97 @@
+#ifndef SIMDKERNELS_H
+#define SIMDKERNELS_H
+
+#include <QtGlobal>
+
+// 信号处理热点内核 (波形生成, 多音合成, 叠加噪声, 限幅)
+// 提供标量, SSE2, AVX2, AVX-512 四种实现, 首次调用时根据CPUID选择当前CPU支持的最高版本,
+// 同一个可执行文件可以在不同代的x86服务器上运行.
+// 设置环境变量 SIGNAL_GENERATOR_SIMD=scalar|sse2|avx2|avx512 可以限制使用的最高指令集.
+namespace SimdKernels {
+
+enum InstructionSet {
+    Scalar,
+    SSE2,
+    AVX2,
+    AVX512
+};
+
+InstructionSet activeInstructionSet();
+const char *instructionSetName(InstructionSet isa);
+
+// NCO波形生成: 输出 amplitude * waveform + offset 并限制在16位范围内,
+// phase 为64位相位累加器, 返回时已前进 numSamples 个样本
+void generateSine(quint64 &phase, quint64 increment, double amplitude, double offset,
+                  double *output, int numSamples);
+void generateSquare(quint64 &phase, quint64 increment, double amplitude, double offset,
+                    double *output, int numSamples);
+void generateTriangle(quint64 &phase, quint64 increment, double amplitude, double offset,
+                      double *output, int numSamples);
+void generateSawtooth(quint64 &phase, quint64 increment, double amplitude, double offset,
+                      double *output, int numSamples);
+
+// 带限 (PolyBLEP/PolyBLAMP) 版本, 直接在目标采样率下抑制方波, 三角波, 锯齿波的混叠
+void generateSquareBandLimited(quint64 &phase, quint64 increment, double amplitude, double offset,
+                               double *output, int numSamples);
+void generateTriangleBandLimited(quint64 &phase, quint64 increment, double amplitude, double offset,
+                                 double *output, int numSamples);
+void generateSawtoothBandLimited(quint64 &phase, quint64 increment, double amplitude, double offset,
+                                 double *output, int numSamples);
+
+// output[i] = clamp(input[i] + noise[i] * scale), 限制在16位范围内, output 可以与 input 或 noise 相同
+void addScaledNoise(const double *input, const double *noise, double scale,
+                    double *output, int numSamples);
+
+// 将数据限制在 [lower, upper] 范围内
+void clamp(double *data, int numSamples, double lower, double upper);
+
+// 16位定点数据通路: double 与 int16 之间的转换 (四舍五入, 饱和到16位范围)
+void convertToInt16(const double *input, qint16 *output, int numSamples);
+void convertFromInt16(const qint16 *input, double *output, int numSamples);
+
+// output[i] = saturate16(input[i] + noise[i] * scale), output 可以与 input 相同
+void addScaledNoiseInt16(const qint16 *input, const double *noise, double scale,
+                         qint16 *output, int numSamples);
+
+// 高斯噪声 (Ziggurat) 的向量化快速路径, 均匀随机数来自以 key 为密钥的 Philox4x32-10
+// 生成从第 firstBlock 组开始的 numSamples 个样本 (numSamples 必须是 GAUSSIAN_BLOCK 的倍数),
+// 每组 GAUSSIAN_BLOCK 个样本由 GAUSSIAN_LANES 个计数器产生; 结果只取决于密钥和样本位置, 与指令集无关.
+// layerAccept / layerWidth 为 256 层 Ziggurat 的快速接受边界和宽度表 (见 GaussianNoise).
+// 约99%的样本在这里直接得到; 落在楔形区或尾部的样本写为 NaN, 载荷低8位为层号, 第8位为符号,
+// 其下标按升序写入 rejected (容量至少 numSamples), 返回个数, 由调用者走精确的慢速路径补齐.
+static const int GAUSSIAN_LANES = 8;
+static const int GAUSSIAN_BLOCK = 2 * GAUSSIAN_LANES;
+int gaussianCandidates(const quint32 *key, quint64 firstBlock, const double *layerAccept,
+                       const double *layerWidth, double *output, int numSamples, int *rejected);
+
+// 复数旋转因子振荡器: output[i] += Re(z * w^i), z = re + j*im, w = stepRe + j*stepIm,
+// 返回时 z 已前进 numSamples 个样本. 用于多音合成, 每个样本只需几次乘加而不是一次正弦计算
+void accumulateTone(double &re, double &im, double stepRe, double stepIm,
+                    double *output, int numSamples);
+
+//
+// 信道损伤 (多径, 衰落, 载波频偏/相位噪声, 采样时钟漂移)
+//
+// output[i] += input[i] * gain, 稀疏FIR (多径, 希尔伯特变换) 逐抽头累加
+void multiplyAccumulate(const double *input, double gain, double *output, int numSamples);
+
+// (re[i] + j*im[i]) *= (gainRe[i] + j*gainIm[i])
+void multiplyComplex(double *re, double *im, const double *gainRe, const double *gainIm, int numSamples);
+
+// (re[i] + j*im[i]) *= e^(j*2*pi*phase[i]), phase 以周期为单位, 可以是任意实数
+void rotatePhase(double *re, double *im, const double *phase, int numSamples);
+
+// output[k] = input 在位置 position + k * step 处的4点三次拉格朗日插值.
+// 调用者保证所有位置 t 满足 2 <= t < inputSize - 2
+void interpolateCubic(const double *input, double position, double step, double *output, int numOutputs);
+
+//
+// 滤波
+//
+// FIR卷积: output[i] = sum(taps[k] * input[i + k]), k = 0..numTaps-1.
+// taps 按时间倒序存放 (taps[numTaps - 1] 乘当前样本), input 包含 numOutputs + numTaps - 1 个样本, output 不能与 input 重叠
+void convolve(const double *input, const double *taps, int numTaps, double *output, int numOutputs);
+
+} // namespace SimdKernels
+
+#endif // SIMDKERNELS_H
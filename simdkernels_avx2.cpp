@@ -0,0 +1,97 @@
+// 本文件中的函数以 AVX2 指令集编译, 只在运行时检测到CPU支持时才会被调用.
+// 标准库和Qt头文件必须在切换目标指令集之前包含, 以免其内联函数被编译成高指令集版本.
+#include "simdkernels.h"
+#include "nco.h"
+#include "philox.h"
+
+#include <algorithm>
+#include <cmath>
+#include <immintrin.h>
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+#include "simdkernels_p.h"
+
+namespace SimdKernels {
+namespace Avx2Impl {
+
+namespace {
+
+struct Isa {
+    typedef __m256d Vec;
+    typedef __m256i PhaseVec;
+    static const int WIDTH = 4;
+
+    static inline Vec set1(double v) { return _mm256_set1_pd(v); }
+    static inline Vec load(const double *p) { return _mm256_loadu_pd(p); }
+    static inline void store(double *p, Vec v) { _mm256_storeu_pd(p, v); }
+    static inline Vec add(Vec a, Vec b) { return _mm256_add_pd(a, b); }
+    static inline Vec sub(Vec a, Vec b) { return _mm256_sub_pd(a, b); }
+    static inline Vec mul(Vec a, Vec b) { return _mm256_mul_pd(a, b); }
+    static inline Vec min(Vec a, Vec b) { return _mm256_min_pd(a, b); }
+    static inline Vec max(Vec a, Vec b) { return _mm256_max_pd(a, b); }
+    static inline Vec abs(Vec v) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), v); }
+    static inline Vec copySign(Vec magnitude, Vec sign)
+    {
+        const Vec signMask = _mm256_set1_pd(-0.0);
+        return _mm256_or_pd(_mm256_andnot_pd(signMask, magnitude), _mm256_and_pd(signMask, sign));
+    }
+    static inline Vec selectNonNegative(Vec x, Vec a, Vec b)
+    {
+        return _mm256_blendv_pd(b, a, _mm256_cmp_pd(x, _mm256_setzero_pd(), _CMP_GE_OQ));
+    }
+
+    static inline PhaseVec phaseSet1(quint64 v) { return _mm256_set1_epi64x(static_cast<qint64>(v)); }
+    static inline PhaseVec phaseRamp(quint64 phase, quint64 increment)
+    {
+        return _mm256_set_epi64x(static_cast<qint64>(phase + 3 * increment),
+                                 static_cast<qint64>(phase + 2 * increment),
+                                 static_cast<qint64>(phase + increment),
+                                 static_cast<qint64>(phase));
+    }
+    static inline PhaseVec phaseAdd(PhaseVec a, PhaseVec b) { return _mm256_add_epi64(a, b); }
+    static inline Vec phaseToCycles(PhaseVec p)
+    {
+        // 取每个64位相位的高32位, 收拢为4个32位整数后转换
+        __m256i high = _mm256_srli_epi64(p, 32);
+        high = _mm256_permutevar8x32_epi32(high, _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6));
+        return _mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(high)),
+                             _mm256_set1_pd(CYCLES_PER_LSB32));
+    }
+
+    static inline Vec selectLess(Vec x, Vec y, Vec a, Vec b)
+    {
+        return _mm256_blendv_pd(b, a, _mm256_cmp_pd(x, y, _CMP_LT_OQ));
+    }
+    static inline int lessMask(Vec x, Vec y) { return _mm256_movemask_pd(_mm256_cmp_pd(x, y, _CMP_LT_OQ)); }
+    static inline Vec gather(const double *table, PhaseVec index) { return _mm256_i64gather_pd(table, index, 8); }
+
+    static inline PhaseVec intLoad(const quint64 *p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)); }
+    static inline void intStore(quint64 *p, PhaseVec v) { _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v); }
+    static inline PhaseVec intAnd(PhaseVec a, PhaseVec b) { return _mm256_and_si256(a, b); }
+    static inline PhaseVec intOr(PhaseVec a, PhaseVec b) { return _mm256_or_si256(a, b); }
+    static inline PhaseVec intXor(PhaseVec a, PhaseVec b) { return _mm256_xor_si256(a, b); }
+    static inline PhaseVec intMulU32(PhaseVec a, PhaseVec b) { return _mm256_mul_epu32(a, b); }
+    template <int K> static inline PhaseVec intShiftLeft(PhaseVec v) { return _mm256_slli_epi64(v, K); }
+    template <int K> static inline PhaseVec intShiftRight(PhaseVec v) { return _mm256_srli_epi64(v, K); }
+    static inline Vec intAsDouble(PhaseVec v) { return _mm256_castsi256_pd(v); }
+    static inline PhaseVec doubleAsInt(Vec v) { return _mm256_castpd_si256(v); }
+};
+
+} // namespace
+
+SIMD_KERNELS_DEFINE_TABLE(Isa, AVX2)
+
+} // namespace Avx2Impl
+} // namespace SimdKernels
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
@@ -0,0 +1,102 @@
+// 本文件中的函数以 AVX-512F 指令集编译, 只在运行时检测到CPU支持时才会被调用.
+// 标准库和Qt头文件必须在切换目标指令集之前包含, 以免其内联函数被编译成高指令集版本.
+#include "simdkernels.h"
+#include "nco.h"
+#include "philox.h"
+
+#include <algorithm>
+#include <cmath>
+#include <immintrin.h>
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx512f"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+#endif
+
+#include "simdkernels_p.h"
+
+namespace SimdKernels {
+namespace Avx512Impl {
+
+namespace {
+
+struct Isa {
+    typedef __m512d Vec;
+    typedef __m512i PhaseVec;
+    static const int WIDTH = 8;
+
+    static inline Vec set1(double v) { return _mm512_set1_pd(v); }
+    static inline Vec load(const double *p) { return _mm512_loadu_pd(p); }
+    static inline void store(double *p, Vec v) { _mm512_storeu_pd(p, v); }
+    static inline Vec add(Vec a, Vec b) { return _mm512_add_pd(a, b); }
+    static inline Vec sub(Vec a, Vec b) { return _mm512_sub_pd(a, b); }
+    static inline Vec mul(Vec a, Vec b) { return _mm512_mul_pd(a, b); }
+    static inline Vec min(Vec a, Vec b) { return _mm512_min_pd(a, b); }
+    static inline Vec max(Vec a, Vec b) { return _mm512_max_pd(a, b); }
+    static inline Vec abs(Vec v) { return _mm512_abs_pd(v); }
+    static inline Vec copySign(Vec magnitude, Vec sign)
+    {
+        // 浮点按位运算需要 AVX-512DQ, 这里用整数指令实现
+        const __m512i signMask = _mm512_set1_epi64(static_cast<qint64>(0x8000000000000000ULL));
+        __m512i bits = _mm512_or_si512(_mm512_andnot_si512(signMask, _mm512_castpd_si512(magnitude)),
+                                       _mm512_and_si512(signMask, _mm512_castpd_si512(sign)));
+        return _mm512_castsi512_pd(bits);
+    }
+    static inline Vec selectNonNegative(Vec x, Vec a, Vec b)
+    {
+        return _mm512_mask_blend_pd(_mm512_cmp_pd_mask(x, _mm512_setzero_pd(), _CMP_GE_OQ), b, a);
+    }
+
+    static inline PhaseVec phaseSet1(quint64 v) { return _mm512_set1_epi64(static_cast<qint64>(v)); }
+    static inline PhaseVec phaseRamp(quint64 phase, quint64 increment)
+    {
+        return _mm512_setr_epi64(static_cast<qint64>(phase),
+                                 static_cast<qint64>(phase + increment),
+                                 static_cast<qint64>(phase + 2 * increment),
+                                 static_cast<qint64>(phase + 3 * increment),
+                                 static_cast<qint64>(phase + 4 * increment),
+                                 static_cast<qint64>(phase + 5 * increment),
+                                 static_cast<qint64>(phase + 6 * increment),
+                                 static_cast<qint64>(phase + 7 * increment));
+    }
+    static inline PhaseVec phaseAdd(PhaseVec a, PhaseVec b) { return _mm512_add_epi64(a, b); }
+    static inline Vec phaseToCycles(PhaseVec p)
+    {
+        // 取每个64位相位的高32位, 截断为8个32位整数后转换
+        __m256i high = _mm512_cvtepi64_epi32(_mm512_srli_epi64(p, 32));
+        return _mm512_mul_pd(_mm512_cvtepi32_pd(high), _mm512_set1_pd(CYCLES_PER_LSB32));
+    }
+
+    static inline Vec selectLess(Vec x, Vec y, Vec a, Vec b)
+    {
+        return _mm512_mask_blend_pd(_mm512_cmp_pd_mask(x, y, _CMP_LT_OQ), b, a);
+    }
+    static inline int lessMask(Vec x, Vec y) { return _mm512_cmp_pd_mask(x, y, _CMP_LT_OQ); }
+    static inline Vec gather(const double *table, PhaseVec index) { return _mm512_i64gather_pd(index, table, 8); }
+
+    static inline PhaseVec intLoad(const quint64 *p) { return _mm512_loadu_si512(p); }
+    static inline void intStore(quint64 *p, PhaseVec v) { _mm512_storeu_si512(p, v); }
+    static inline PhaseVec intAnd(PhaseVec a, PhaseVec b) { return _mm512_and_si512(a, b); }
+    static inline PhaseVec intOr(PhaseVec a, PhaseVec b) { return _mm512_or_si512(a, b); }
+    static inline PhaseVec intXor(PhaseVec a, PhaseVec b) { return _mm512_xor_si512(a, b); }
+    static inline PhaseVec intMulU32(PhaseVec a, PhaseVec b) { return _mm512_mul_epu32(a, b); }
+    template <int K> static inline PhaseVec intShiftLeft(PhaseVec v) { return _mm512_slli_epi64(v, K); }
+    template <int K> static inline PhaseVec intShiftRight(PhaseVec v) { return _mm512_srli_epi64(v, K); }
+    static inline Vec intAsDouble(PhaseVec v) { return _mm512_castsi512_pd(v); }
+    static inline PhaseVec doubleAsInt(Vec v) { return _mm512_castpd_si512(v); }
+};
+
+} // namespace
+
+SIMD_KERNELS_DEFINE_TABLE(Isa, AVX512)
+
+} // namespace Avx512Impl
+} // namespace SimdKernels
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
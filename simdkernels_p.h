@@ -0,0 +1,797 @@
+#ifndef SIMDKERNELS_P_H
+#define SIMDKERNELS_P_H
+
+//
+// 内部头文件, 只由 simdkernels*.cpp 包含
+//
+// 各指令集版本的源文件在包含本文件之前切换目标指令集, 这里的模板随之以对应指令集编译,
+// 因此模板和辅助函数都必须是内部链接, 避免链接器把高指令集编译出的副本合并到标量路径中.
+// 下面的 nco.h 和 philox.h 含有外部链接的内联函数, 各指令集版本的源文件要在切换目标指令集之前包含它们.
+//
+
+#include "simdkernels.h"
+#include "nco.h"
+#include "philox.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace SimdKernels {
+
+typedef void (*WaveformKernel)(quint64 &phase, quint64 increment, double amplitude, double offset,
+                               double *output, int numSamples);
+typedef void (*AddNoiseKernel)(const double *input, const double *noise, double scale,
+                               double *output, int numSamples);
+typedef void (*ClampKernel)(double *data, int numSamples, double lower, double upper);
+typedef void (*AccumulateToneKernel)(double &re, double &im, double stepRe, double stepIm,
+                                     double *output, int numSamples);
+typedef void (*ToInt16Kernel)(const double *input, qint16 *output, int numSamples);
+typedef void (*FromInt16Kernel)(const qint16 *input, double *output, int numSamples);
+typedef void (*AddNoiseInt16Kernel)(const qint16 *input, const double *noise, double scale,
+                                    qint16 *output, int numSamples);
+typedef void (*MultiplyAccumulateKernel)(const double *input, double gain, double *output, int numSamples);
+typedef void (*MultiplyComplexKernel)(double *re, double *im, const double *gainRe, const double *gainIm,
+                                      int numSamples);
+typedef void (*RotatePhaseKernel)(double *re, double *im, const double *phase, int numSamples);
+typedef void (*InterpolateKernel)(const double *input, double position, double step,
+                                  double *output, int numOutputs);
+typedef void (*ConvolveKernel)(const double *input, const double *taps, int numTaps,
+                               double *output, int numOutputs);
+typedef int (*GaussianKernel)(const quint32 *key, quint64 firstBlock, const double *layerAccept,
+                              const double *layerWidth, double *output, int numSamples, int *rejected);
+
+struct KernelTable {
+    InstructionSet isa;
+    WaveformKernel generateSine;
+    WaveformKernel generateSquare;
+    WaveformKernel generateTriangle;
+    WaveformKernel generateSawtooth;
+    WaveformKernel generateSquareBandLimited;
+    WaveformKernel generateTriangleBandLimited;
+    WaveformKernel generateSawtoothBandLimited;
+    AddNoiseKernel addScaledNoise;
+    ClampKernel clamp;
+    AccumulateToneKernel accumulateTone;
+    ToInt16Kernel convertToInt16;
+    FromInt16Kernel convertFromInt16;
+    AddNoiseInt16Kernel addScaledNoiseInt16;
+    GaussianKernel gaussianCandidates;
+    MultiplyAccumulateKernel multiplyAccumulate;
+    MultiplyComplexKernel multiplyComplex;
+    RotatePhaseKernel rotatePhase;
+    InterpolateKernel interpolateCubic;
+    ConvolveKernel convolve;
+};
+
+namespace ScalarImpl { const KernelTable &kernelTable(); }
+#ifdef SIGNAL_GENERATOR_X86_SIMD
+namespace Sse2Impl { const KernelTable &kernelTable(); }
+namespace Avx2Impl { const KernelTable &kernelTable(); }
+namespace Avx512Impl { const KernelTable &kernelTable(); }
+#endif
+
+// 2^-32, 相位累加器 (PHASE_SCALE 见 nco.h) 高32位按有符号数解释即为 [-0.5, 0.5) 周期
+static const double CYCLES_PER_LSB32 = 1.0 / 4294967296.0;
+
+// sin(2*pi*x) 多项式系数, 折叠到 [-0.25, 0.25] 周期后使用15阶奇次泰勒多项式, 误差小于1e-11
+static const double SIN_COEFFS[8] = {
+    1.0,
+    -1.0 / 6.0,
+    1.0 / 120.0,
+    -1.0 / 5040.0,
+    1.0 / 362880.0,
+    -1.0 / 39916800.0,
+    1.0 / 6227020800.0,
+    -1.0 / 1307674368000.0
+};
+
+static const double TWO_PI = 6.283185307179586476925286766559;
+
+// 加上再减去 1.5 * 2^52 即按当前舍入模式 (就近) 取整, |x| < 2^51 时精确
+static const double ROUND_MAGIC = 6755399441055744.0;
+static const double TWO_POW_52 = 4503599627370496.0;
+
+namespace {
+
+// 宽度为1的"向量", 用于标量实现以及向量版本的尾部样本
+struct ScalarIsa {
+    typedef double Vec;
+    typedef quint64 PhaseVec;
+    static const int WIDTH = 1;
+
+    static inline Vec set1(double v) { return v; }
+    static inline Vec load(const double *p) { return *p; }
+    static inline void store(double *p, Vec v) { *p = v; }
+    static inline Vec add(Vec a, Vec b) { return a + b; }
+    static inline Vec sub(Vec a, Vec b) { return a - b; }
+    static inline Vec mul(Vec a, Vec b) { return a * b; }
+    static inline Vec min(Vec a, Vec b) { return b < a ? b : a; }
+    static inline Vec max(Vec a, Vec b) { return a < b ? b : a; }
+    static inline Vec abs(Vec v) { return std::fabs(v); }
+    static inline Vec copySign(Vec magnitude, Vec sign) { return std::copysign(magnitude, sign); }
+    static inline Vec selectNonNegative(Vec x, Vec a, Vec b) { return x >= 0.0 ? a : b; }
+
+    static inline PhaseVec phaseSet1(quint64 v) { return v; }
+    static inline PhaseVec phaseRamp(quint64 phase, quint64) { return phase; }
+    static inline PhaseVec phaseAdd(PhaseVec a, PhaseVec b) { return a + b; }
+    static inline Vec phaseToCycles(PhaseVec p)
+    {
+        return static_cast<qint32>(static_cast<quint32>(p >> 32)) * CYCLES_PER_LSB32;
+    }
+
+    static inline Vec selectLess(Vec x, Vec y, Vec a, Vec b) { return x < y ? a : b; }
+    static inline int lessMask(Vec x, Vec y) { return x < y ? 1 : 0; }
+    static inline Vec gather(const double *table, PhaseVec index) { return table[index]; }
+
+    static inline PhaseVec intLoad(const quint64 *p) { return *p; }
+    static inline void intStore(quint64 *p, PhaseVec v) { *p = v; }
+    static inline PhaseVec intAnd(PhaseVec a, PhaseVec b) { return a & b; }
+    static inline PhaseVec intOr(PhaseVec a, PhaseVec b) { return a | b; }
+    static inline PhaseVec intXor(PhaseVec a, PhaseVec b) { return a ^ b; }
+    static inline PhaseVec intMulU32(PhaseVec a, PhaseVec b) { return (a & 0xffffffffu) * (b & 0xffffffffu); }
+    template <int K> static inline PhaseVec intShiftLeft(PhaseVec v) { return v << K; }
+    template <int K> static inline PhaseVec intShiftRight(PhaseVec v) { return v >> K; }
+    static inline Vec intAsDouble(PhaseVec v)
+    {
+        double d;
+        std::memcpy(&d, &v, sizeof(d));
+        return d;
+    }
+    static inline PhaseVec doubleAsInt(Vec v)
+    {
+        quint64 bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        return bits;
+    }
+};
+
+} // namespace
+
+//
+// 通用内核, Isa 提供向量类型和基本运算:
+//   Vec / PhaseVec, WIDTH, set1, load, store, add, sub, mul, min, max, abs, copySign,
+//   selectNonNegative(x, a, b) = x >= 0 ? a : b,
+//   phaseRamp(phase, increment) = {phase, phase + inc, ...}, phaseSet1, phaseAdd, phaseToCycles,
+//   selectLess(x, y, a, b) = x < y ? a : b, lessMask(x, y) = 各通道 x < y 的位掩码, gather(table, index) = table[index],
+//   PhaseVec 上的64位整数运算 intLoad, intStore, intAnd, intOr, intXor, intShiftLeft<K>, intShiftRight<K>,
+//   intMulU32 (两个64位通道的低32位相乘得到64位积),
+//   以及按位重新解释 intAsDouble / doubleAsInt
+//
+template <typename Isa>
+static inline typename Isa::Vec clampInt16(typename Isa::Vec v)
+{
+    return Isa::min(Isa::max(v, Isa::set1(-32768.0)), Isa::set1(32767.0));
+}
+
+template <typename Isa>
+static inline typename Isa::Vec sinCycles(typename Isa::Vec x)
+{
+    typedef typename Isa::Vec Vec;
+    Vec a = Isa::abs(x);
+    Vec folded = Isa::copySign(Isa::min(a, Isa::sub(Isa::set1(0.5), a)), x);
+    Vec t = Isa::mul(Isa::set1(TWO_PI), folded);
+    Vec t2 = Isa::mul(t, t);
+    Vec p = Isa::set1(SIN_COEFFS[7]);
+    for (int k = 6; k >= 0; --k) {
+        p = Isa::add(Isa::mul(p, t2), Isa::set1(SIN_COEFFS[k]));
+    }
+    return Isa::mul(t, p);
+}
+
+//
+// 带限波形 (PolyBLEP / PolyBLAMP)
+// 在每个跳变 (或斜率突变) 前后各一个样本内加上二阶多项式残差, 相当于用两个样本宽的
+// 三角核平滑不连续点, 直接在目标采样率下大幅抑制混叠, 不需要过采样后再滤波.
+// x 为 [-0.5, 0.5) 周期, d 为到不连续点的有符号距离 (单位: 样本), u = max(0, 1 - |d|):
+//   单位阶跃残差 = -sign(d) * u^2 / 2
+//   单位斜率突变残差 = u^3 / 6
+//
+struct ShapeContext {
+    double dt;      // 每个样本前进的周期数
+    double invDt;
+};
+
+// 相位0处不连续点的 u
+template <typename Isa>
+static inline typename Isa::Vec blepWindow(typename Isa::Vec x, typename Isa::Vec invDt)
+{
+    return Isa::max(Isa::set1(0.0), Isa::sub(Isa::set1(1.0), Isa::abs(Isa::mul(x, invDt))));
+}
+
+// 相位移动半个周期, 用于相位0.5处的不连续点
+template <typename Isa>
+static inline typename Isa::Vec halfCycleShift(typename Isa::Vec x)
+{
+    return Isa::sub(x, Isa::copySign(Isa::set1(0.5), x));
+}
+
+struct SineShape {
+    template <typename Isa>
+    static inline typename Isa::Vec apply(typename Isa::Vec x, typename Isa::Vec, typename Isa::Vec)
+    {
+        return sinCycles<Isa>(x);
+    }
+};
+
+// 相位 [0, 0.5) 输出正半周
+struct SquareShape {
+    template <typename Isa>
+    static inline typename Isa::Vec apply(typename Isa::Vec x, typename Isa::Vec, typename Isa::Vec)
+    {
+        return Isa::selectNonNegative(x, Isa::set1(1.0), Isa::set1(-1.0));
+    }
+};
+
+// 相位0处为 -1, 0.5处为 +1
+struct TriangleShape {
+    template <typename Isa>
+    static inline typename Isa::Vec apply(typename Isa::Vec x, typename Isa::Vec, typename Isa::Vec)
+    {
+        return Isa::sub(Isa::mul(Isa::set1(4.0), Isa::abs(x)), Isa::set1(1.0));
+    }
+};
+
+// 相位0处从 +1 跳变到 -1, 之后线性上升
+struct SawtoothShape {
+    template <typename Isa>
+    static inline typename Isa::Vec apply(typename Isa::Vec x, typename Isa::Vec, typename Isa::Vec)
+    {
+        return Isa::sub(Isa::mul(Isa::set1(2.0), x), Isa::copySign(Isa::set1(1.0), x));
+    }
+};
+
+// 相位0处 +2 阶跃, 0.5处 -2 阶跃
+struct SquareBandLimitedShape {
+    template <typename Isa>
+    static inline typename Isa::Vec apply(typename Isa::Vec x, typename Isa::Vec, typename Isa::Vec invDt)
+    {
+        typedef typename Isa::Vec Vec;
+        Vec x1 = halfCycleShift<Isa>(x);
+        Vec u0 = blepWindow<Isa>(x, invDt);
+        Vec u1 = blepWindow<Isa>(x1, invDt);
+        Vec naive = SquareShape::apply<Isa>(x, invDt, invDt);
+        return Isa::add(Isa::sub(naive, Isa::copySign(Isa::mul(u0, u0), x)),
+                        Isa::copySign(Isa::mul(u1, u1), x1));
+    }
+};
+
+// 斜率每个样本 4*dt, 相位0处突变 +8*dt, 0.5处突变 -8*dt
+struct TriangleBandLimitedShape {
+    template <typename Isa>
+    static inline typename Isa::Vec apply(typename Isa::Vec x, typename Isa::Vec dt, typename Isa::Vec invDt)
+    {
+        typedef typename Isa::Vec Vec;
+        Vec u0 = blepWindow<Isa>(x, invDt);
+        Vec u1 = blepWindow<Isa>(halfCycleShift<Isa>(x), invDt);
+        Vec blamp = Isa::sub(Isa::mul(Isa::mul(u0, u0), u0), Isa::mul(Isa::mul(u1, u1), u1));
+        Vec naive = TriangleShape::apply<Isa>(x, dt, invDt);
+        return Isa::add(naive, Isa::mul(Isa::mul(Isa::set1(4.0 / 3.0), dt), blamp));
+    }
+};
+
+// 相位0处 -2 阶跃
+struct SawtoothBandLimitedShape {
+    template <typename Isa>
+    static inline typename Isa::Vec apply(typename Isa::Vec x, typename Isa::Vec dt, typename Isa::Vec invDt)
+    {
+        typedef typename Isa::Vec Vec;
+        Vec u0 = blepWindow<Isa>(x, invDt);
+        Vec naive = SawtoothShape::apply<Isa>(x, dt, invDt);
+        return Isa::add(naive, Isa::copySign(Isa::mul(u0, u0), x));
+    }
+};
+
+template <typename Isa, typename Shape>
+static inline void waveformLoop(quint64 phase, quint64 increment, double amplitude, double offset,
+                                const ShapeContext &context, double *output, int numSamples)
+{
+    typedef typename Isa::Vec Vec;
+    typedef typename Isa::PhaseVec PhaseVec;
+
+    const Vec amp = Isa::set1(amplitude);
+    const Vec off = Isa::set1(offset);
+    const Vec dt = Isa::set1(context.dt);
+    const Vec invDt = Isa::set1(context.invDt);
+    const PhaseVec step = Isa::phaseSet1(increment * Isa::WIDTH);
+    PhaseVec lanes = Isa::phaseRamp(phase, increment);
+
+    for (int i = 0; i < numSamples; i += Isa::WIDTH) {
+        Vec x = Isa::phaseToCycles(lanes);
+        lanes = Isa::phaseAdd(lanes, step);
+        Vec y = Isa::add(Isa::mul(amp, Shape::template apply<Isa>(x, dt, invDt)), off);
+        Isa::store(output + i, clampInt16<Isa>(y));
+    }
+}
+
+template <typename Isa, typename Shape>
+static void generateWaveform(quint64 &phase, quint64 increment, double amplitude, double offset,
+                             double *output, int numSamples)
+{
+    ShapeContext context;
+    context.dt = increment / PHASE_SCALE;
+    context.invDt = 1.0 / (context.dt > 1e-12 ? context.dt : 1e-12);
+
+    const int vectorEnd = numSamples - numSamples % Isa::WIDTH;
+    waveformLoop<Isa, Shape>(phase, increment, amplitude, offset, context, output, vectorEnd);
+    phase += static_cast<quint64>(vectorEnd) * increment;
+
+    waveformLoop<ScalarIsa, Shape>(phase, increment, amplitude, offset, context,
+                                   output + vectorEnd, numSamples - vectorEnd);
+    phase += static_cast<quint64>(numSamples - vectorEnd) * increment;
+}
+
+template <typename Isa>
+static inline void addScaledNoiseLoop(const double *input, const double *noise, double scale,
+                                      double *output, int numSamples)
+{
+    typedef typename Isa::Vec Vec;
+
+    const Vec s = Isa::set1(scale);
+    for (int i = 0; i < numSamples; i += Isa::WIDTH) {
+        Vec y = Isa::add(Isa::load(input + i), Isa::mul(Isa::load(noise + i), s));
+        Isa::store(output + i, clampInt16<Isa>(y));
+    }
+}
+
+template <typename Isa>
+static void addScaledNoiseKernel(const double *input, const double *noise, double scale,
+                           double *output, int numSamples)
+{
+    const int vectorEnd = numSamples - numSamples % Isa::WIDTH;
+    addScaledNoiseLoop<Isa>(input, noise, scale, output, vectorEnd);
+    addScaledNoiseLoop<ScalarIsa>(input + vectorEnd, noise + vectorEnd, scale,
+                                  output + vectorEnd, numSamples - vectorEnd);
+}
+
+template <typename Isa>
+static inline void clampLoop(double *data, int numSamples, double lower, double upper)
+{
+    typedef typename Isa::Vec Vec;
+
+    const Vec lo = Isa::set1(lower);
+    const Vec hi = Isa::set1(upper);
+    for (int i = 0; i < numSamples; i += Isa::WIDTH) {
+        Isa::store(data + i, Isa::min(Isa::max(Isa::load(data + i), lo), hi));
+    }
+}
+
+template <typename Isa>
+static void clampKernel(double *data, int numSamples, double lower, double upper)
+{
+    const int vectorEnd = numSamples - numSamples % Isa::WIDTH;
+    clampLoop<Isa>(data, vectorEnd, lower, upper);
+    clampLoop<ScalarIsa>(data + vectorEnd, numSamples - vectorEnd, lower, upper);
+}
+
+//
+// 旋转因子振荡器: output[i] += Re(z * w^i)
+// 每个通道保存 z * w^j, 每次迭代乘以 w^(2*WIDTH); 两组通道交替更新, 缩短乘法的依赖链
+//
+static inline void rotate(double &re, double &im, double stepRe, double stepIm)
+{
+    double r = re * stepRe - im * stepIm;
+    im = re * stepIm + im * stepRe;
+    re = r;
+}
+
+template <typename Isa>
+static inline void rotateVec(typename Isa::Vec &re, typename Isa::Vec &im,
+                             typename Isa::Vec stepRe, typename Isa::Vec stepIm)
+{
+    typename Isa::Vec r = Isa::sub(Isa::mul(re, stepRe), Isa::mul(im, stepIm));
+    im = Isa::add(Isa::mul(re, stepIm), Isa::mul(im, stepRe));
+    re = r;
+}
+
+template <typename Isa>
+static inline void accumulateToneLoop(double &re, double &im, double stepRe, double stepIm,
+                                      double *output, int numSamples)
+{
+    typedef typename Isa::Vec Vec;
+    const int width = Isa::WIDTH;
+
+    double laneRe[2 * Isa::WIDTH];
+    double laneIm[2 * Isa::WIDTH];
+    double r = re;
+    double m = im;
+    double wr = 1.0;
+    double wi = 0.0;
+    for (int j = 0; j < 2 * width; ++j) {
+        laneRe[j] = r;
+        laneIm[j] = m;
+        rotate(r, m, stepRe, stepIm);
+        rotate(wr, wi, stepRe, stepIm);
+    }
+
+    Vec re0 = Isa::load(laneRe);
+    Vec im0 = Isa::load(laneIm);
+    Vec re1 = Isa::load(laneRe + width);
+    Vec im1 = Isa::load(laneIm + width);
+    const Vec sr = Isa::set1(wr);
+    const Vec si = Isa::set1(wi);
+
+    for (int i = 0; i < numSamples; i += 2 * width) {
+        Isa::store(output + i, Isa::add(Isa::load(output + i), re0));
+        Isa::store(output + i + width, Isa::add(Isa::load(output + i + width), re1));
+        rotateVec<Isa>(re0, im0, sr, si);
+        rotateVec<Isa>(re1, im1, sr, si);
+    }
+
+    Isa::store(laneRe, re0);
+    Isa::store(laneIm, im0);
+    re = laneRe[0];
+    im = laneIm[0];
+}
+
+template <typename Isa>
+static void accumulateToneKernel(double &re, double &im, double stepRe, double stepIm,
+                                 double *output, int numSamples)
+{
+    const int vectorEnd = numSamples - numSamples % (2 * Isa::WIDTH);
+    accumulateToneLoop<Isa>(re, im, stepRe, stepIm, output, vectorEnd);
+    for (int i = vectorEnd; i < numSamples; ++i) {
+        output[i] += re;
+        rotate(re, im, stepRe, stepIm);
+    }
+}
+
+//
+// 信道损伤内核
+//
+template <typename Isa>
+static inline void multiplyAccumulateLoop(const double *input, double gain, double *output, int numSamples)
+{
+    typedef typename Isa::Vec Vec;
+
+    const Vec g = Isa::set1(gain);
+    for (int i = 0; i < numSamples; i += Isa::WIDTH) {
+        Isa::store(output + i, Isa::add(Isa::load(output + i), Isa::mul(Isa::load(input + i), g)));
+    }
+}
+
+template <typename Isa>
+static void multiplyAccumulateKernel(const double *input, double gain, double *output, int numSamples)
+{
+    const int vectorEnd = numSamples - numSamples % Isa::WIDTH;
+    multiplyAccumulateLoop<Isa>(input, gain, output, vectorEnd);
+    multiplyAccumulateLoop<ScalarIsa>(input + vectorEnd, gain, output + vectorEnd, numSamples - vectorEnd);
+}
+
+template <typename Isa>
+static inline void multiplyComplexLoop(double *re, double *im, const double *gainRe, const double *gainIm,
+                                       int numSamples)
+{
+    typedef typename Isa::Vec Vec;
+
+    for (int i = 0; i < numSamples; i += Isa::WIDTH) {
+        Vec r = Isa::load(re + i);
+        Vec m = Isa::load(im + i);
+        rotateVec<Isa>(r, m, Isa::load(gainRe + i), Isa::load(gainIm + i));
+        Isa::store(re + i, r);
+        Isa::store(im + i, m);
+    }
+}
+
+template <typename Isa>
+static void multiplyComplexKernel(double *re, double *im, const double *gainRe, const double *gainIm,
+                                  int numSamples)
+{
+    const int vectorEnd = numSamples - numSamples % Isa::WIDTH;
+    multiplyComplexLoop<Isa>(re, im, gainRe, gainIm, vectorEnd);
+    multiplyComplexLoop<ScalarIsa>(re + vectorEnd, im + vectorEnd, gainRe + vectorEnd, gainIm + vectorEnd,
+                                   numSamples - vectorEnd);
+}
+
+// 相位先折叠到 [-0.5, 0.5] 周期, cos(2*pi*x) 由 sin(2*pi*(x + 0.25)) 得到
+template <typename Isa>
+static inline typename Isa::Vec wrapCycles(typename Isa::Vec x)
+{
+    const typename Isa::Vec magic = Isa::set1(ROUND_MAGIC);
+    return Isa::sub(x, Isa::sub(Isa::add(x, magic), magic));
+}
+
+template <typename Isa>
+static inline void rotatePhaseLoop(double *re, double *im, const double *phase, int numSamples)
+{
+    typedef typename Isa::Vec Vec;
+
+    for (int i = 0; i < numSamples; i += Isa::WIDTH) {
+        const Vec x = wrapCycles<Isa>(Isa::load(phase + i));
+        const Vec s = sinCycles<Isa>(x);
+        const Vec c = sinCycles<Isa>(wrapCycles<Isa>(Isa::add(x, Isa::set1(0.25))));
+        Vec r = Isa::load(re + i);
+        Vec m = Isa::load(im + i);
+        rotateVec<Isa>(r, m, c, s);
+        Isa::store(re + i, r);
+        Isa::store(im + i, m);
+    }
+}
+
+template <typename Isa>
+static void rotatePhaseKernel(double *re, double *im, const double *phase, int numSamples)
+{
+    const int vectorEnd = numSamples - numSamples % Isa::WIDTH;
+    rotatePhaseLoop<Isa>(re, im, phase, vectorEnd);
+    rotatePhaseLoop<ScalarIsa>(re + vectorEnd, im + vectorEnd, phase + vectorEnd, numSamples - vectorEnd);
+}
+
+// 4点三次拉格朗日插值, 输出 [begin, end) 对应位置 position + k * step.
+// 整数部分用 t - 0.5 加 2^52 取整得到: 恰为整数的位置可能取到前一个样本 (mu = 1), 插值结果不变
+static const double SAMPLE_RAMP[8] = { 0.0, 1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0 };
+
+template <typename Isa>
+static inline void interpolateCubicLoop(const double *input, double position, double step,
+                                        double *output, int begin, int end)
+{
+    typedef typename Isa::Vec Vec;
+    typedef typename Isa::PhaseVec Bits;
+
+    const Vec magic = Isa::set1(TWO_POW_52);
+    const Vec stepVec = Isa::set1(step);
+    const Vec pos = Isa::set1(position);
+    const Bits mantissa = Isa::phaseSet1(Q_UINT64_C(0x000fffffffffffff));
+    const Bits minusOne = Isa::phaseSet1(~Q_UINT64_C(0));
+    const Bits one = Isa::phaseSet1(1);
+    const Bits two = Isa::phaseSet1(2);
+    Vec k = Isa::add(Isa::set1(begin), Isa::load(SAMPLE_RAMP));
+
+    for (int i = begin; i < end; i += Isa::WIDTH) {
+        const Vec t = Isa::add(pos, Isa::mul(k, stepVec));
+        const Vec rounded = Isa::add(Isa::sub(t, Isa::set1(0.5)), magic);
+        const Bits index = Isa::intAnd(Isa::doubleAsInt(rounded), mantissa);
+        const Vec mu = Isa::sub(t, Isa::sub(rounded, magic));
+
+        const Vec xm1 = Isa::gather(input, Isa::phaseAdd(index, minusOne));
+        const Vec x0 = Isa::gather(input, index);
+        const Vec x1 = Isa::gather(input, Isa::phaseAdd(index, one));
+        const Vec x2 = Isa::gather(input, Isa::phaseAdd(index, two));
+
+        const Vec muMinus1 = Isa::sub(mu, Isa::set1(1.0));
+        const Vec muMinus2 = Isa::sub(mu, Isa::set1(2.0));
+        const Vec muPlus1 = Isa::add(mu, Isa::set1(1.0));
+        const Vec a = Isa::mul(mu, muMinus1);
+        const Vec b = Isa::mul(muPlus1, muMinus2);
+
+        Vec y = Isa::mul(Isa::mul(Isa::mul(a, muMinus2), Isa::set1(-1.0 / 6.0)), xm1);
+        y = Isa::add(y, Isa::mul(Isa::mul(Isa::mul(b, muMinus1), Isa::set1(0.5)), x0));
+        y = Isa::add(y, Isa::mul(Isa::mul(Isa::mul(b, mu), Isa::set1(-0.5)), x1));
+        y = Isa::add(y, Isa::mul(Isa::mul(Isa::mul(a, muPlus1), Isa::set1(1.0 / 6.0)), x2));
+        Isa::store(output + i, y);
+
+        k = Isa::add(k, Isa::set1(Isa::WIDTH));
+    }
+}
+
+template <typename Isa>
+static void interpolateCubicKernel(const double *input, double position, double step,
+                                   double *output, int numOutputs)
+{
+    const int vectorEnd = numOutputs - numOutputs % Isa::WIDTH;
+    interpolateCubicLoop<Isa>(input, position, step, output, 0, vectorEnd);
+    interpolateCubicLoop<ScalarIsa>(input, position, step, output, vectorEnd, numOutputs);
+}
+
+//
+// 16位定点内核
+// 写成简单的逐样本循环, 由各指令集版本的源文件按各自的目标指令集自动向量化,
+// 模板参数只用于区分各指令集的实例. 舍入方式为四舍五入 (远离0), 结果饱和到16位范围.
+//
+static inline qint16 saturateToInt16(double v)
+{
+    // 先加 ±0.5 再截断; 用 std::min/max 而不是条件分支, 编译器才能向量化
+    v = std::min(std::max(v + std::copysign(0.5, v), -32768.0), 32767.0);
+    return static_cast<qint16>(static_cast<qint32>(v));
+}
+
+template <typename Isa>
+static void convertToInt16Kernel(const double *input, qint16 *output, int numSamples)
+{
+    for (int i = 0; i < numSamples; ++i) {
+        output[i] = saturateToInt16(input[i]);
+    }
+}
+
+template <typename Isa>
+static void convertFromInt16Kernel(const qint16 *input, double *output, int numSamples)
+{
+    for (int i = 0; i < numSamples; ++i) {
+        output[i] = input[i];
+    }
+}
+
+template <typename Isa>
+static void addScaledNoiseInt16Kernel(const qint16 *input, const double *noise, double scale,
+                                      qint16 *output, int numSamples)
+{
+    for (int i = 0; i < numSamples; ++i) {
+        output[i] = saturateToInt16(input[i] + noise[i] * scale);
+    }
+}
+
+//
+// Ziggurat 快速路径, 随机数来自 Philox4x32-10
+// 每个64位通道的低32位存放一个 Philox 字, 32x32 位乘法直接用无符号32位乘64位积的指令.
+// 第 b 组 (GAUSSIAN_BLOCK 个样本) 使用计数器 b * GAUSSIAN_LANES + l (l < GAUSSIAN_LANES),
+// 每个计数器输出128位: 低64位给样本 l, 高64位给样本 GAUSSIAN_LANES + l.
+// 每个64位随机数中低8位选层, 第8位为符号, 高52位为层内位置. 样本只取决于密钥和它在序列中的位置.
+//
+template <typename Isa>
+static inline void philoxRounds(const typename Isa::PhaseVec *roundKey0, const typename Isa::PhaseVec *roundKey1,
+                                typename Isa::PhaseVec &x0, typename Isa::PhaseVec &x1,
+                                typename Isa::PhaseVec &x2, typename Isa::PhaseVec &x3)
+{
+    typedef typename Isa::PhaseVec Bits;
+
+    const Bits low32 = Isa::phaseSet1(0xffffffffu);
+    const Bits multiplier0 = Isa::phaseSet1(Philox::MULTIPLIER0);
+    const Bits multiplier1 = Isa::phaseSet1(Philox::MULTIPLIER1);
+    for (int round = 0; round < Philox::ROUNDS; ++round) {
+        const Bits p0 = Isa::intMulU32(x0, multiplier0);
+        const Bits p1 = Isa::intMulU32(x2, multiplier1);
+        x0 = Isa::intXor(Isa::intXor(Isa::template intShiftRight<32>(p1), x1), roundKey0[round]);
+        x1 = Isa::intAnd(p1, low32);
+        x2 = Isa::intXor(Isa::intXor(Isa::template intShiftRight<32>(p0), x3), roundKey1[round]);
+        x3 = Isa::intAnd(p0, low32);
+    }
+}
+
+// 64位随机数映射为 Ziggurat 候选点, 未通过快速接受的写为带层号和符号的 NaN, 其通道序号追加到 rejected
+template <typename Isa>
+static inline void storeZigguratCandidate(typename Isa::PhaseVec r, const double *layerAccept,
+                                          const double *layerWidth, double *output, int index,
+                                          int *rejected, int &rejectedCount)
+{
+    typedef typename Isa::Vec Vec;
+    typedef typename Isa::PhaseVec Bits;
+
+    // 52位整数与 2^52 的指数位按位或后减去 2^52 即得到对应的 double, 避免64位整数转换指令
+    const Bits layer = Isa::intAnd(r, Isa::phaseSet1(0xff));
+    const Vec position = Isa::sub(Isa::intAsDouble(Isa::intOr(Isa::template intShiftRight<12>(r),
+                                                              Isa::phaseSet1(Q_UINT64_C(0x4330000000000000)))),
+                                  Isa::set1(TWO_POW_52));
+    const Vec magnitude = Isa::mul(position, Isa::gather(layerWidth, layer));
+    const Vec bound = Isa::gather(layerAccept, layer);
+    const Bits sign = Isa::template intShiftLeft<55>(Isa::intAnd(r, Isa::phaseSet1(0x100)));
+    const Vec candidate = Isa::intAsDouble(Isa::intXor(Isa::doubleAsInt(magnitude), sign));
+    const Vec nan = Isa::intAsDouble(Isa::intOr(Isa::intAnd(r, Isa::phaseSet1(0x1ff)),
+                                                Isa::phaseSet1(Q_UINT64_C(0x7ff8000000000000))));
+    Isa::store(output + index, Isa::selectLess(magnitude, bound, candidate, nan));
+
+    // 大约每9个向量才有一个通道未被接受
+    const int rejectedLanes = ~Isa::lessMask(magnitude, bound) & ((1 << Isa::WIDTH) - 1);
+    if (rejectedLanes != 0) {
+        for (int l = 0; l < Isa::WIDTH; ++l) {
+            if (rejectedLanes & (1 << l)) {
+                rejected[rejectedCount++] = index + l;
+            }
+        }
+    }
+}
+
+template <typename Isa>
+static int gaussianCandidatesKernel(const quint32 *key, quint64 firstBlock, const double *layerAccept,
+                                    const double *layerWidth, double *output, int numSamples, int *rejected)
+{
+    typedef typename Isa::PhaseVec Bits;
+    const int lanes = GAUSSIAN_LANES;
+
+    const Bits low32 = Isa::phaseSet1(0xffffffffu);
+    const Bits zero = Isa::phaseSet1(0);
+    quint64 counter = firstBlock * lanes;
+    int rejectedCount = 0;
+
+    // 每轮的密钥与样本无关, 预先广播
+    Bits roundKey0[Philox::ROUNDS];
+    Bits roundKey1[Philox::ROUNDS];
+    quint32 k0 = key[0];
+    quint32 k1 = key[1];
+    for (int round = 0; round < Philox::ROUNDS; ++round) {
+        roundKey0[round] = Isa::phaseSet1(k0);
+        roundKey1[round] = Isa::phaseSet1(k1);
+        k0 += Philox::KEY_STEP0;
+        k1 += Philox::KEY_STEP1;
+    }
+
+    for (int i = 0; i < numSamples; i += GAUSSIAN_BLOCK) {
+        for (int g = 0; g < lanes; g += Isa::WIDTH) {
+            const Bits c = Isa::phaseRamp(counter + g, 1);
+            Bits x0 = Isa::intAnd(c, low32);
+            Bits x1 = Isa::template intShiftRight<32>(c);
+            Bits x2 = zero;
+            Bits x3 = zero;
+            philoxRounds<Isa>(roundKey0, roundKey1, x0, x1, x2, x3);
+
+            const Bits low = Isa::intOr(x0, Isa::template intShiftLeft<32>(x1));
+            const Bits high = Isa::intOr(x2, Isa::template intShiftLeft<32>(x3));
+            storeZigguratCandidate<Isa>(low, layerAccept, layerWidth, output, i + g,
+                                        rejected, rejectedCount);
+            storeZigguratCandidate<Isa>(high, layerAccept, layerWidth, output, i + lanes + g,
+                                        rejected, rejectedCount);
+        }
+        counter += lanes;
+    }
+    return rejectedCount;
+}
+
+//
+// 滤波内核
+//
+// 每次计算 4 个向量的输出, 累加器留在寄存器中, 每个抽头只广播一次, 输入按非对齐方式逐抽头错位读取
+template <typename Isa>
+static inline int convolveBlocks(const double *input, const double *taps, int numTaps,
+                                 double *output, int numOutputs)
+{
+    typedef typename Isa::Vec Vec;
+
+    const int step = 4 * Isa::WIDTH;
+    int i = 0;
+    for (; i + step <= numOutputs; i += step) {
+        const double *x = input + i;
+        Vec acc0 = Isa::set1(0.0);
+        Vec acc1 = acc0;
+        Vec acc2 = acc0;
+        Vec acc3 = acc0;
+        for (int k = 0; k < numTaps; ++k) {
+            const Vec t = Isa::set1(taps[k]);
+            acc0 = Isa::add(acc0, Isa::mul(t, Isa::load(x + k)));
+            acc1 = Isa::add(acc1, Isa::mul(t, Isa::load(x + k + Isa::WIDTH)));
+            acc2 = Isa::add(acc2, Isa::mul(t, Isa::load(x + k + 2 * Isa::WIDTH)));
+            acc3 = Isa::add(acc3, Isa::mul(t, Isa::load(x + k + 3 * Isa::WIDTH)));
+        }
+        Isa::store(output + i, acc0);
+        Isa::store(output + i + Isa::WIDTH, acc1);
+        Isa::store(output + i + 2 * Isa::WIDTH, acc2);
+        Isa::store(output + i + 3 * Isa::WIDTH, acc3);
+    }
+    for (; i + Isa::WIDTH <= numOutputs; i += Isa::WIDTH) {
+        const double *x = input + i;
+        Vec acc = Isa::set1(0.0);
+        for (int k = 0; k < numTaps; ++k) {
+            acc = Isa::add(acc, Isa::mul(Isa::set1(taps[k]), Isa::load(x + k)));
+        }
+        Isa::store(output + i, acc);
+    }
+    return i;
+}
+
+template <typename Isa>
+static void convolveKernel(const double *input, const double *taps, int numTaps,
+                           double *output, int numOutputs)
+{
+    const int done = convolveBlocks<Isa>(input, taps, numTaps, output, numOutputs);
+    convolveBlocks<ScalarIsa>(input + done, taps, numTaps, output + done, numOutputs - done);
+}
+
+// 为指定指令集实例化全部内核
+#define SIMD_KERNELS_DEFINE_TABLE(Isa, isaId) \
+    const KernelTable &kernelTable() \
+    { \
+        static const KernelTable table = { \
+            isaId, \
+            generateWaveform<Isa, SineShape>, \
+            generateWaveform<Isa, SquareShape>, \
+            generateWaveform<Isa, TriangleShape>, \
+            generateWaveform<Isa, SawtoothShape>, \
+            generateWaveform<Isa, SquareBandLimitedShape>, \
+            generateWaveform<Isa, TriangleBandLimitedShape>, \
+            generateWaveform<Isa, SawtoothBandLimitedShape>, \
+            addScaledNoiseKernel<Isa>, \
+            clampKernel<Isa>, \
+            accumulateToneKernel<Isa>, \
+            convertToInt16Kernel<Isa>, \
+            convertFromInt16Kernel<Isa>, \
+            addScaledNoiseInt16Kernel<Isa>, \
+            gaussianCandidatesKernel<Isa>, \
+            multiplyAccumulateKernel<Isa>, \
+            multiplyComplexKernel<Isa>, \
+            rotatePhaseKernel<Isa>, \
+            interpolateCubicKernel<Isa>, \
+            convolveKernel<Isa> \
+        }; \
+        return table; \
+    }
+
+} // namespace SimdKernels
+
+#endif // SIMDKERNELS_P_H
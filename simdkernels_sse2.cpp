@@ -0,0 +1,101 @@
+// 本文件中的函数以 SSE2 指令集编译, 只在运行时检测到CPU支持时才会被调用.
+// 标准库和Qt头文件必须在切换目标指令集之前包含, 以免其内联函数被编译成高指令集版本.
+#include "simdkernels.h"
+#include "nco.h"
+#include "philox.h"
+
+#include <algorithm>
+#include <cmath>
+#include <emmintrin.h>
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("sse2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+#include "simdkernels_p.h"
+
+namespace SimdKernels {
+namespace Sse2Impl {
+
+namespace {
+
+struct Isa {
+    typedef __m128d Vec;
+    typedef __m128i PhaseVec;
+    static const int WIDTH = 2;
+
+    static inline Vec set1(double v) { return _mm_set1_pd(v); }
+    static inline Vec load(const double *p) { return _mm_loadu_pd(p); }
+    static inline void store(double *p, Vec v) { _mm_storeu_pd(p, v); }
+    static inline Vec add(Vec a, Vec b) { return _mm_add_pd(a, b); }
+    static inline Vec sub(Vec a, Vec b) { return _mm_sub_pd(a, b); }
+    static inline Vec mul(Vec a, Vec b) { return _mm_mul_pd(a, b); }
+    static inline Vec min(Vec a, Vec b) { return _mm_min_pd(a, b); }
+    static inline Vec max(Vec a, Vec b) { return _mm_max_pd(a, b); }
+    static inline Vec abs(Vec v) { return _mm_andnot_pd(_mm_set1_pd(-0.0), v); }
+    static inline Vec copySign(Vec magnitude, Vec sign)
+    {
+        const Vec signMask = _mm_set1_pd(-0.0);
+        return _mm_or_pd(_mm_andnot_pd(signMask, magnitude), _mm_and_pd(signMask, sign));
+    }
+    static inline Vec selectNonNegative(Vec x, Vec a, Vec b)
+    {
+        Vec mask = _mm_cmpge_pd(x, _mm_setzero_pd());
+        return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b));
+    }
+
+    static inline PhaseVec phaseSet1(quint64 v) { return _mm_set1_epi64x(static_cast<qint64>(v)); }
+    static inline PhaseVec phaseRamp(quint64 phase, quint64 increment)
+    {
+        return _mm_set_epi64x(static_cast<qint64>(phase + increment), static_cast<qint64>(phase));
+    }
+    static inline PhaseVec phaseAdd(PhaseVec a, PhaseVec b) { return _mm_add_epi64(a, b); }
+    static inline Vec phaseToCycles(PhaseVec p)
+    {
+        // 每个64位相位的高32位移到低位, 再把两个32位整数收拢到低64位后转换
+        __m128i high = _mm_srli_epi64(p, 32);
+        high = _mm_shuffle_epi32(high, _MM_SHUFFLE(3, 1, 2, 0));
+        return _mm_mul_pd(_mm_cvtepi32_pd(high), _mm_set1_pd(CYCLES_PER_LSB32));
+    }
+
+    static inline Vec selectLess(Vec x, Vec y, Vec a, Vec b)
+    {
+        Vec mask = _mm_cmplt_pd(x, y);
+        return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b));
+    }
+    static inline int lessMask(Vec x, Vec y) { return _mm_movemask_pd(_mm_cmplt_pd(x, y)); }
+    static inline Vec gather(const double *table, PhaseVec index)
+    {
+        // SSE2 没有 gather 指令, 逐个取出下标
+        quint64 i[2];
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(i), index);
+        return _mm_set_pd(table[i[1]], table[i[0]]);
+    }
+
+    static inline PhaseVec intLoad(const quint64 *p) { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)); }
+    static inline void intStore(quint64 *p, PhaseVec v) { _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v); }
+    static inline PhaseVec intAnd(PhaseVec a, PhaseVec b) { return _mm_and_si128(a, b); }
+    static inline PhaseVec intOr(PhaseVec a, PhaseVec b) { return _mm_or_si128(a, b); }
+    static inline PhaseVec intXor(PhaseVec a, PhaseVec b) { return _mm_xor_si128(a, b); }
+    static inline PhaseVec intMulU32(PhaseVec a, PhaseVec b) { return _mm_mul_epu32(a, b); }
+    template <int K> static inline PhaseVec intShiftLeft(PhaseVec v) { return _mm_slli_epi64(v, K); }
+    template <int K> static inline PhaseVec intShiftRight(PhaseVec v) { return _mm_srli_epi64(v, K); }
+    static inline Vec intAsDouble(PhaseVec v) { return _mm_castsi128_pd(v); }
+    static inline PhaseVec doubleAsInt(Vec v) { return _mm_castpd_si128(v); }
+};
+
+} // namespace
+
+SIMD_KERNELS_DEFINE_TABLE(Isa, SSE2)
+
+} // namespace Sse2Impl
+} // namespace SimdKernels
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
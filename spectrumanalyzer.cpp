@@ -0,0 +1,308 @@
+#include "spectrumanalyzer.h"
+
+#include "simdkernels.h"
+
+#include <QtMath>
+#include <algorithm>
+#include <cstring>
+
+SpectrumAnalyzer::Settings::Settings() :
+    fftSize(1024),
+    overlap(0.5),
+    window(WindowFunction::Hann),
+    averaging(SpectrumAnalyzer::Welch),
+    averages(8),
+    spectrogramDepth(256),
+    samplingRate(8000.0)
+{
+}
+
+SpectrumAnalyzer::SpectrumAnalyzer() :
+    m_hopSize(0),
+    m_bins(0),
+    m_coherentGain(1.0),
+    m_powerGain(1.0),
+    m_welchHead(0),
+    m_sinceResum(0),
+    m_frameCount(0),
+    m_spectrogramHead(0)
+{
+    setSettings(Settings());
+}
+
+bool SpectrumAnalyzer::Settings::operator==(const Settings &other) const
+{
+    return fftSize == other.fftSize && overlap == other.overlap && window == other.window &&
+            averaging == other.averaging && averages == other.averages &&
+            spectrogramDepth == other.spectrogramDepth && samplingRate == other.samplingRate;
+}
+
+bool SpectrumAnalyzer::checkSettings(const Settings &settings, QString *errorString)
+{
+    QString error;
+    if (settings.fftSize < MIN_FFT_SIZE || settings.fftSize > MAX_FFT_SIZE) {
+        error = QString("FFT长度应在 %1 到 %2 之间").arg(MIN_FFT_SIZE).arg(MAX_FFT_SIZE);
+    } else if (!(settings.overlap >= 0.0 && settings.overlap < 1.0)) {
+        error = "帧重叠比例应在 [0, 1) 之间";
+    } else if (settings.averages < 1 || settings.averages > 1000 ||
+               settings.spectrogramDepth < 0 || settings.spectrogramDepth > 4096) {
+        error = "平均帧数或语谱图帧数超出范围";
+    } else if (settings.samplingRate <= 0.0) {
+        error = "采样率必须为正";
+    }
+
+    if (errorString) {
+        *errorString = error;
+    }
+    return error.isEmpty();
+}
+
+bool SpectrumAnalyzer::setSettings(const Settings &settings)
+{
+    if (!checkSettings(settings, &m_errorString)) {
+        return false;
+    }
+
+    m_settings = settings;
+    m_hopSize = qMax(1, qRound(settings.fftSize * (1.0 - settings.overlap)));
+    m_fft = RealFft::plan(settings.fftSize);
+    m_bins = m_fft->getOutputSize();
+    m_frame.resize(settings.fftSize);
+    m_spectrum.resize(m_bins);
+    m_workspace.resize(m_fft->getWorkspaceSize());
+
+    m_window = WindowFunction::generatePeriodic(settings.window, settings.fftSize);
+    m_coherentGain = 0.0;
+    m_powerGain = 0.0;
+    for (double w : m_window) {
+        m_coherentGain += w;
+        m_powerGain += w * w;
+    }
+
+    reset();
+    return true;
+}
+
+SpectrumAnalyzer::Settings SpectrumAnalyzer::getSettings() const
+{
+    return m_settings;
+}
+
+QString SpectrumAnalyzer::errorString() const
+{
+    return m_errorString;
+}
+
+void SpectrumAnalyzer::reset()
+{
+    m_buffer.clear();
+    m_average.fill(0.0, m_bins);
+    m_welchFrames.fill(0.0, m_settings.averaging == Welch ? m_settings.averages * m_bins : 0);
+    m_welchHead = 0;
+    m_sinceResum = 0;
+    m_frameCount = 0;
+    m_spectrogram.fill(0.0, m_settings.spectrogramDepth * m_bins);
+    m_spectrogramHead = 0;
+}
+
+int SpectrumAnalyzer::process(const double *input, int numSamples)
+{
+    if (numSamples <= 0) {
+        return 0;
+    }
+
+    const int pending = m_buffer.size();
+    m_buffer.resize(pending + numSamples);
+    std::memcpy(m_buffer.data() + pending, input, sizeof(double) * numSamples);
+    return analyzeBuffered();
+}
+
+int SpectrumAnalyzer::process(const qint16 *input, int numSamples)
+{
+    if (numSamples <= 0) {
+        return 0;
+    }
+
+    // 16位样本直接转换到缓冲区末尾
+    const int pending = m_buffer.size();
+    m_buffer.resize(pending + numSamples);
+    SimdKernels::convertFromInt16(input, m_buffer.data() + pending, numSamples);
+    return analyzeBuffered();
+}
+
+int SpectrumAnalyzer::analyzeBuffered()
+{
+    // hop <= fftSize, 处理完后剩余不足一帧
+    const int size = m_buffer.size();
+    const double *buffer = m_buffer.constData();
+    int position = 0;
+    int frames = 0;
+    for (; position + m_settings.fftSize <= size; position += m_hopSize) {
+        analyzeFrame(buffer + position);
+        ++frames;
+    }
+
+    position = qMin(position, size);
+    double *data = m_buffer.data();
+    std::memmove(data, data + position, sizeof(double) * (size - position));
+    m_buffer.resize(size - position);
+    return frames;
+}
+
+void SpectrumAnalyzer::analyzeFrame(const double *frame)
+{
+    const int size = m_settings.fftSize;
+    const double *window = m_window.constData();
+    double *windowed = m_frame.data();
+    for (int n = 0; n < size; ++n) {
+        windowed[n] = frame[n] * window[n];
+    }
+    m_fft->forward(windowed, m_spectrum.data(), m_workspace.data());
+
+    const std::complex<double> *bins = m_spectrum.constData();
+    double *average = m_average.data();
+    ++m_frameCount;
+
+    switch (m_settings.averaging) {
+    case Welch: {
+        // m_average 为环形缓冲区中各帧之和: 加入新帧, 减去被替换的最早一帧
+        double *slot = m_welchFrames.data() + m_welchHead * m_bins;
+        for (int k = 0; k < m_bins; ++k) {
+            const double power = std::norm(bins[k]);
+            average[k] += power - slot[k];
+            slot[k] = power;
+        }
+        m_welchHead = (m_welchHead + 1) % m_settings.averages;
+        if (++m_sinceResum >= m_settings.averages) {
+            m_sinceResum = 0;
+            std::fill(m_average.begin(), m_average.end(), 0.0);
+            for (int f = 0; f < m_settings.averages; ++f) {
+                const double *power = m_welchFrames.constData() + f * m_bins;
+                for (int k = 0; k < m_bins; ++k) {
+                    average[k] += power[k];
+                }
+            }
+        }
+        break;
+    }
+    case Exponential: {
+        const double a = 1.0 / qMin<qint64>(m_frameCount, m_settings.averages);
+        for (int k = 0; k < m_bins; ++k) {
+            average[k] += a * (std::norm(bins[k]) - average[k]);
+        }
+        break;
+    }
+    default:
+        for (int k = 0; k < m_bins; ++k) {
+            average[k] = std::norm(bins[k]);
+        }
+        break;
+    }
+
+    if (m_settings.spectrogramDepth > 0) {
+        double *row = m_spectrogram.data() + m_spectrogramHead * m_bins;
+        for (int k = 0; k < m_bins; ++k) {
+            row[k] = std::norm(bins[k]);
+        }
+        powerSpectralDensityRow(row);
+        m_spectrogramHead = (m_spectrogramHead + 1) % m_settings.spectrogramDepth;
+    }
+}
+
+int SpectrumAnalyzer::getHopSize() const
+{
+    return m_hopSize;
+}
+
+int SpectrumAnalyzer::getBinCount() const
+{
+    return m_bins;
+}
+
+qint64 SpectrumAnalyzer::getFrameCount() const
+{
+    return m_frameCount;
+}
+
+QVector<double> SpectrumAnalyzer::getFrequencyAxis() const
+{
+    QVector<double> axis(m_bins);
+    for (int k = 0; k < m_bins; ++k) {
+        axis[k] = k * m_settings.samplingRate / m_settings.fftSize;
+    }
+    return axis;
+}
+
+QVector<double> SpectrumAnalyzer::getPowerSpectralDensity() const
+{
+    QVector<double> psd(m_bins);
+    powerSpectralDensity(psd.data());
+    return psd;
+}
+
+QVector<double> SpectrumAnalyzer::getAmplitudeSpectrum() const
+{
+    QVector<double> amplitude(m_bins);
+    amplitudeSpectrum(amplitude.data());
+    return amplitude;
+}
+
+void SpectrumAnalyzer::powerSpectralDensity(double *output) const
+{
+    const double scale = averageScale();
+    for (int k = 0; k < m_bins; ++k) {
+        output[k] = m_average[k] * scale;
+    }
+    powerSpectralDensityRow(output);
+}
+
+void SpectrumAnalyzer::amplitudeSpectrum(double *output) const
+{
+    // 正弦分量 A*cos 在频点中心处 |X| = A/2 * sum(w), 直流和奈奎斯特频点不折叠
+    const double scale = averageScale();
+    for (int k = 0; k < m_bins; ++k) {
+        const double fold = isFolded(k) ? 2.0 : 1.0;
+        output[k] = fold * std::sqrt(m_average[k] * scale) / m_coherentGain;
+    }
+}
+
+int SpectrumAnalyzer::getSpectrogramFrames() const
+{
+    return static_cast<int>(qMin<qint64>(m_frameCount, m_settings.spectrogramDepth));
+}
+
+QVector<double> SpectrumAnalyzer::getLatestFrames(int count) const
+{
+    count = qBound(0, count, getSpectrogramFrames());
+    QVector<double> frames(count * m_bins);
+    const int depth = m_settings.spectrogramDepth;
+    for (int i = 0; i < count; ++i) {
+        const int row = (m_spectrogramHead - count + i + depth) % depth;
+        std::memcpy(frames.data() + i * m_bins, m_spectrogram.constData() + row * m_bins,
+                    sizeof(double) * m_bins);
+    }
+    return frames;
+}
+
+double SpectrumAnalyzer::averageScale() const
+{
+    if (m_settings.averaging == Welch) {
+        return 1.0 / qMax<qint64>(1, qMin<qint64>(m_frameCount, m_settings.averages));
+    }
+    return 1.0;
+}
+
+bool SpectrumAnalyzer::isFolded(int bin) const
+{
+    // 负频率折叠到正频率, 直流和 (偶数长度的) 奈奎斯特频点没有对应的负频率
+    return bin > 0 && 2 * bin != m_settings.fftSize;
+}
+
+void SpectrumAnalyzer::powerSpectralDensityRow(double *power) const
+{
+    // 单边功率谱密度 = fold * |X[k]|^2 / (fs * sum(w^2))
+    const double scale = 1.0 / (m_settings.samplingRate * m_powerGain);
+    for (int k = 0; k < m_bins; ++k) {
+        power[k] *= (isFolded(k) ? 2.0 : 1.0) * scale;
+    }
+}
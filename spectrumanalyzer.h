@@ -0,0 +1,113 @@
+#ifndef SPECTRUMANALYZER_H
+#define SPECTRUMANALYZER_H
+
+#include <QString>
+#include <QVector>
+#include <complex>
+#include <memory>
+
+#include "realfft.h"
+#include "windowfunction.h"
+
+// 流式短时傅里叶分析 (STFT)
+// 输入按任意长度分块送入, 每凑够一帧 (fftSize 个样本, 相邻帧间隔 hop 个样本) 就加窗做一次实数FFT,
+// 得到该帧的功率谱 |X[k]|^2, 再做平均:
+//  - Welch: 最近 averages 帧的算术平均, 滑动和实现, 每 averages 帧重新求和一次以消除舍入误差的累积
+//  - 指数: P = (1 - a) * P + a * |X|^2, a = 1 / averages (不足 averages 帧时按已有帧数的算术平均)
+// 每帧的功率谱密度同时写入最近 spectrogramDepth 帧的语谱图环形缓冲区.
+// 只保留不足一帧的剩余样本和固定大小的平均/语谱图缓冲区, 内存与输入总长度无关.
+class SpectrumAnalyzer
+{
+public:
+    enum Averaging {
+        NoAveraging,    // 只用最近一帧
+        Welch,
+        Exponential
+    };
+
+    struct Settings {
+        int fftSize;                    // 帧长 (任意长度)
+        double overlap;                 // 相邻帧重叠比例, [0, 1)
+        WindowFunction::Type window;
+        Averaging averaging;
+        int averages;                   // Welch 的平均帧数 / 指数平均的时间常数 (帧)
+        int spectrogramDepth;           // 语谱图保留的帧数
+        double samplingRate;
+
+        Settings();
+        bool operator==(const Settings &other) const;
+        bool operator!=(const Settings &other) const { return !(*this == other); }
+    };
+
+    SpectrumAnalyzer();
+
+    // 参数超出范围时返回 false (errorString 给出原因), 原有设置不变; 设置改变后清空状态
+    bool setSettings(const Settings &settings);
+    Settings getSettings() const;
+    QString errorString() const;
+    // 只检查参数, 不改变任何状态
+    static bool checkSettings(const Settings &settings, QString *errorString = nullptr);
+
+    // 清空剩余样本, 平均结果和语谱图
+    void reset();
+
+    // 送入一块样本, 返回这一块完成的帧数
+    int process(const double *input, int numSamples);
+    int process(const qint16 *input, int numSamples);
+
+    int getHopSize() const;
+    int getBinCount() const;            // fftSize / 2 + 1
+    qint64 getFrameCount() const;       // reset 以来完成的帧数
+    QVector<double> getFrequencyAxis() const;
+
+    // 平均后的单边功率谱密度 (V^2/Hz), 已按窗的等效噪声带宽归一化
+    QVector<double> getPowerSpectralDensity() const;
+    // 平均后的幅度谱: 按窗的相干增益归一化, 频点中心上幅度为 A 的正弦分量读数为 A
+    QVector<double> getAmplitudeSpectrum() const;
+    // 无拷贝版本, 写入 getBinCount() 个点
+    void powerSpectralDensity(double *output) const;
+    void amplitudeSpectrum(double *output) const;
+
+    // 语谱图: 最近 count 帧 (不超过保留的帧数) 的单边功率谱密度, 按时间先后依次存放, 每帧 getBinCount() 个点
+    int getSpectrogramFrames() const;
+    QVector<double> getLatestFrames(int count) const;
+
+    static const int MIN_FFT_SIZE = 16;
+    static const int MAX_FFT_SIZE = 1 << 20;
+
+private:
+    void analyzeFrame(const double *frame);
+    // 分析 m_buffer 中完整的帧, 剩余样本移到开头
+    int analyzeBuffered();
+    // Welch 的 m_average 为各帧之和, 输出时乘以 1 / 帧数
+    double averageScale() const;
+    bool isFolded(int bin) const;
+    // |X[k]|^2 原地换算为单边功率谱密度
+    void powerSpectralDensityRow(double *power) const;
+
+    Settings m_settings;
+    QString m_errorString;
+    int m_hopSize;
+    int m_bins;
+
+    std::shared_ptr<const RealFft> m_fft;
+    QVector<double> m_window;
+    double m_coherentGain;              // sum(w)
+    double m_powerGain;                 // sum(w^2)
+    QVector<double> m_frame;            // 加窗后的帧
+    QVector<std::complex<double>> m_spectrum;
+    QVector<std::complex<double>> m_workspace;
+
+    QVector<double> m_buffer;           // [不足一帧的剩余样本 | 当前块]
+
+    QVector<double> m_average;          // 平均后的 |X[k]|^2 (Welch 为最近各帧之和)
+    QVector<double> m_welchFrames;      // Welch: 最近 averages 帧的 |X[k]|^2, 环形缓冲区
+    int m_welchHead;
+    int m_sinceResum;
+    qint64 m_frameCount;
+
+    QVector<double> m_spectrogram;      // 最近 spectrogramDepth 帧的功率谱密度, 环形缓冲区
+    int m_spectrogramHead;              // 下一帧写入的位置
+};
+
+#endif // SPECTRUMANALYZER_H
@@ -0,0 +1,199 @@
+#include "streamrecorder.h"
+
+#include <QDateTime>
+
+static const char *const TAP_NAMES[StreamRecorder::TAP_COUNT] = {"generator", "channel", "filtered"};
+
+StreamRecorder::Settings::Settings() :
+    taps(GeneratorTap | ChannelTap | FilteredTap),
+    sampleFormat(CaptureFormat::Float32),
+    compressed(true),
+    samplingRate(8000.0),
+    filteredSamplingRate(0.0),
+    bufferCount(8),
+    bufferSamples(1 << 16),
+    timeout(0)
+{
+}
+
+StreamRecorder::StreamRecorder(QObject *parent) : QObject(parent),
+    m_taps(0),
+    m_timeout(0),
+    m_pendingWriters(0),
+    m_ok(true)
+{
+    for (int i = 0; i < TAP_COUNT; ++i) {
+        connect(&m_writers[i], &CaptureWriter::finished, this, [this, i](bool ok) {
+            onWriterFinished(i, ok);
+        });
+    }
+}
+
+StreamRecorder::~StreamRecorder()
+{
+    stop();
+}
+
+bool StreamRecorder::start(const QString &basePath, const Settings &settings)
+{
+    if (isRecording()) {
+        m_errorString = "正在录制";
+        return false;
+    }
+    if ((settings.taps & (GeneratorTap | ChannelTap | FilteredTap)) == 0) {
+        m_errorString = "没有选择要录制的数据";
+        return false;
+    }
+
+    CaptureWriter::Settings writerSettings;
+    writerSettings.sampleFormat = settings.sampleFormat;
+    writerSettings.startTime = QDateTime::currentMSecsSinceEpoch();
+    writerSettings.compressed = settings.compressed;
+    writerSettings.bufferCount = settings.bufferCount;
+    writerSettings.bufferSamples = settings.bufferSamples;
+
+    int opened = 0;
+    for (int i = 0; i < TAP_COUNT; ++i) {
+        const Tap tap = static_cast<Tap>(1 << i);
+        if (!(settings.taps & tap)) {
+            continue;
+        }
+        writerSettings.samplingRate = tap == FilteredTap && settings.filteredSamplingRate > 0.0
+                ? settings.filteredSamplingRate : settings.samplingRate;
+        if (!m_writers[i].open(tapFilePath(basePath, tap), writerSettings)) {
+            m_errorString = m_writers[i].errorString();
+            // 已经创建的文件 (还没有数据) 正常关闭
+            for (int j = 0; j < i; ++j) {
+                if (opened & (1 << j)) {
+                    m_writers[j].close();
+                }
+            }
+            return false;
+        }
+        opened |= tap;
+    }
+
+    m_taps = opened;
+    m_timeout = settings.timeout;
+    m_pendingWriters = opened;
+    m_ok = true;
+    m_errorString.clear();
+    return true;
+}
+
+void StreamRecorder::stop()
+{
+    for (int i = 0; i < TAP_COUNT; ++i) {
+        if (m_taps & (1 << i)) {
+            m_writers[i].close();
+        }
+    }
+    m_taps = 0;
+}
+
+bool StreamRecorder::isRecording() const
+{
+    return m_taps != 0;
+}
+
+QString StreamRecorder::errorString() const
+{
+    return m_errorString;
+}
+
+StreamRecorder::Statistics StreamRecorder::getStatistics(Tap tap) const
+{
+    const CaptureWriter &writer = m_writers[tapIndex(tap)];
+    Statistics statistics;
+    statistics.framesWritten = writer.getFramesWritten();
+    statistics.bytesWritten = writer.getBytesWritten();
+    statistics.droppedBlocks = writer.getDroppedBlocks();
+    statistics.droppedSamples = writer.getDroppedSamples();
+    return statistics;
+}
+
+StreamRecorder::Statistics StreamRecorder::getTotalStatistics() const
+{
+    Statistics total = {0, 0, 0, 0};
+    for (int i = 0; i < TAP_COUNT; ++i) {
+        const Statistics statistics = getStatistics(static_cast<Tap>(1 << i));
+        total.framesWritten += statistics.framesWritten;
+        total.bytesWritten += statistics.bytesWritten;
+        total.droppedBlocks += statistics.droppedBlocks;
+        total.droppedSamples += statistics.droppedSamples;
+    }
+    return total;
+}
+
+QString StreamRecorder::tapFilePath(const QString &basePath, Tap tap)
+{
+    QString path = basePath;
+    if (path.endsWith(".sgc", Qt::CaseInsensitive)) {
+        path.chop(4);
+    }
+    return QString("%1_%2.sgc").arg(path, TAP_NAMES[tapIndex(tap)]);
+}
+
+void StreamRecorder::onGeneratorData(const QVector<double> &data)
+{
+    record(GeneratorTap, data);
+}
+
+void StreamRecorder::onGeneratorData16(const QVector<qint16> &data)
+{
+    record(GeneratorTap, data);
+}
+
+void StreamRecorder::onChannelData(const QVector<double> &data)
+{
+    record(ChannelTap, data);
+}
+
+void StreamRecorder::onChannelData16(const QVector<qint16> &data)
+{
+    record(ChannelTap, data);
+}
+
+void StreamRecorder::onFilteredData(const QVector<double> &data, qint64 missingSamples)
+{
+    record(FilteredTap, data, missingSamples);
+}
+
+void StreamRecorder::onFilteredData16(const QVector<qint16> &data, qint64 missingSamples)
+{
+    record(FilteredTap, data, missingSamples);
+}
+
+template <typename T>
+void StreamRecorder::record(Tap tap, const QVector<T> &data, qint64 missingSamples)
+{
+    // 复制到缓冲区池, 不持有发送方的缓冲区 (例如 GeneratorWorker 轮转使用的块)
+    if (m_taps & tap) {
+        CaptureWriter &writer = m_writers[tapIndex(tap)];
+        writer.writeGap(missingSamples);
+        writer.write(data.constData(), data.size(), m_timeout);
+    }
+}
+
+void StreamRecorder::onWriterFinished(int index, bool ok)
+{
+    // 只处理这次录制的文件; 启动失败时关闭的文件也会发出 finished()
+    const int bit = 1 << index;
+    if (!(m_pendingWriters & bit) || m_writers[index].isOpen()) {
+        return;
+    }
+
+    if (!ok && m_ok) {
+        m_ok = false;
+        m_errorString = QString("%1: %2").arg(TAP_NAMES[index], m_writers[index].errorString());
+    }
+    m_pendingWriters &= ~bit;
+    if (m_pendingWriters == 0) {
+        emit finished(m_ok);
+    }
+}
+
+int StreamRecorder::tapIndex(Tap tap)
+{
+    return tap == GeneratorTap ? 0 : tap == ChannelTap ? 1 : 2;
+}
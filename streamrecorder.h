@@ -0,0 +1,92 @@
+#ifndef STREAMRECORDER_H
+#define STREAMRECORDER_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+
+#include "capturewriter.h"
+
+// 连续录制: 把选中的数据通路节点 (信号发生器输出, 信道输出, 滤波输出) 分别写入采集文件
+// 每个节点一个 CaptureWriter, 收到的块复制到写入器的缓冲区池中由后台线程写盘,
+// 磁盘跟不上时按 Settings::timeout 等待 (背压), 仍然没有空闲缓冲区就丢弃整块并计数.
+// 丢弃的块和上游报告丢失的样本在文件中记为缺口 (读出为0), 文件的帧序号与采集时间保持对应.
+// 内存占用只取决于缓冲区池大小, 与录制时长无关.
+class StreamRecorder : public QObject
+{
+    Q_OBJECT
+public:
+    enum Tap {
+        GeneratorTap = 0x1,
+        ChannelTap = 0x2,
+        FilteredTap = 0x4
+    };
+
+    struct Settings {
+        int taps;                               // Tap 按位组合
+        CaptureFormat::SampleFormat sampleFormat;
+        bool compressed;
+        double samplingRate;
+        double filteredSamplingRate;            // 滤波输出的采样率 (接收分析抽取后), 0 表示与 samplingRate 相同
+        int bufferCount;                        // 每个节点的缓冲区池
+        int bufferSamples;
+        int timeout;                            // 没有空闲缓冲区时等待的毫秒数, 0 表示立即丢弃
+
+        Settings();
+    };
+
+    // 每个节点的统计
+    struct Statistics {
+        qint64 framesWritten;
+        qint64 bytesWritten;
+        qint64 droppedBlocks;
+        qint64 droppedSamples;
+    };
+
+    explicit StreamRecorder(QObject *parent = nullptr);
+    ~StreamRecorder();
+
+    // 为每个选中的节点创建 tapFilePath(basePath, tap) 并开始录制; 失败时已创建的文件被关闭, 原因见 errorString()
+    bool start(const QString &basePath, const Settings &settings);
+    // 停止录制, 立即返回; 所有文件写完后发出 finished()
+    void stop();
+    bool isRecording() const;
+    QString errorString() const;
+
+    Statistics getStatistics(Tap tap) const;
+    // 所有节点合计
+    Statistics getTotalStatistics() const;
+
+    // <basePath 去掉 .sgc 扩展名>_generator.sgc / _channel.sgc / _filtered.sgc
+    static QString tapFilePath(const QString &basePath, Tap tap);
+
+    static const int TAP_COUNT = 3;
+
+signals:
+    // ok 为 false 时原因见 errorString()
+    void finished(bool ok);
+
+public slots:
+    void onGeneratorData(const QVector<double> &data);
+    void onGeneratorData16(const QVector<qint16> &data);
+    void onChannelData(const QVector<double> &data);
+    void onChannelData16(const QVector<qint16> &data);
+    // 连接 ReceiveAnalyzer::filteredBlockReady, 只录制新的块; missingSamples 记为缺口
+    void onFilteredData(const QVector<double> &data, qint64 missingSamples);
+    void onFilteredData16(const QVector<qint16> &data, qint64 missingSamples);
+
+private:
+    void onWriterFinished(int index, bool ok);
+    static int tapIndex(Tap tap);
+    template <typename T>
+    void record(Tap tap, const QVector<T> &data, qint64 missingSamples = 0);
+
+    CaptureWriter m_writers[TAP_COUNT];
+    int m_taps;                     // 正在录制的节点
+    int m_timeout;
+    int m_pendingWriters;           // 这次录制中还没写完的节点, 按位
+    bool m_ok;
+    QString m_errorString;
+};
+
+#endif // STREAMRECORDER_H
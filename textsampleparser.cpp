@@ -0,0 +1,208 @@
+#include "textsampleparser.h"
+
+#include <QFile>
+#include <QThread>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+static inline bool isBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+// 解析 [begin, end) 中的一个数值, 整段都必须被消耗
+static bool parseDouble(const char *begin, const char *end, double &value)
+{
+    // 与 QString::toDouble 一致, 接受前导 '+'
+    if (*begin == '+' && end - begin > 1 && begin[1] != '-' && begin[1] != '+') {
+        ++begin;
+    }
+
+#if defined(__cpp_lib_to_chars)
+    std::from_chars_result result = std::from_chars(begin, end, value);
+    return result.ec == std::errc() && result.ptr == end;
+#else
+    // 标准库没有浮点 from_chars 时退回 strtod, 只在行很短时拷贝到栈上
+    char buffer[64];
+    std::string longLine;
+    const size_t length = static_cast<size_t>(end - begin);
+    char *text = buffer;
+    if (length >= sizeof(buffer)) {
+        longLine.assign(begin, end);
+        text = &longLine[0];
+    } else {
+        std::memcpy(buffer, begin, length);
+        buffer[length] = '\0';
+    }
+    char *parsedEnd = nullptr;
+    value = std::strtod(text, &parsedEnd);
+    return parsedEnd == text + length;
+#endif
+}
+
+TextSampleParser::TextSampleParser() :
+    m_threadCount(0),
+    m_commentLines(0),
+    m_rejectedLines(0)
+{
+}
+
+bool TextSampleParser::parseFile(const QString &filePath)
+{
+    m_samples.clear();
+    m_commentLines = 0;
+    m_rejectedLines = 0;
+    m_errorString.clear();
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        m_errorString = QString("无法打开文件: %1").arg(filePath);
+        return false;
+    }
+
+    const qint64 size = file.size();
+    if (size == 0) {
+        return true;
+    }
+
+    // 优先映射文件, 映射失败 (例如非普通文件) 时整体读取
+    uchar *mapping = file.map(0, size);
+    if (mapping) {
+        parse(reinterpret_cast<const char *>(mapping), size);
+        file.unmap(mapping);
+    } else {
+        QByteArray contents = file.readAll();
+        parse(contents.constData(), contents.size());
+    }
+
+    file.close();
+    return true;
+}
+
+void TextSampleParser::parse(const char *data, qint64 size)
+{
+    m_samples.clear();
+    m_commentLines = 0;
+    m_rejectedLines = 0;
+    if (size <= 0) {
+        return;
+    }
+
+    int threadCount = m_threadCount > 0 ? m_threadCount : QThread::idealThreadCount();
+    threadCount = static_cast<int>(qBound<qint64>(1, size / MIN_CHUNK_BYTES, qMax(1, threadCount)));
+
+    // 按换行边界切分, 每段从某一行的开头开始
+    const char *end = data + size;
+    std::vector<Chunk> chunks(static_cast<size_t>(threadCount));
+    const char *begin = data;
+    for (int i = 0; i < threadCount; ++i) {
+        const char *chunkEnd = end;
+        if (i < threadCount - 1) {
+            chunkEnd = qMax(begin, data + size * (i + 1) / threadCount);
+            const void *newline = std::memchr(chunkEnd, '\n', static_cast<size_t>(end - chunkEnd));
+            chunkEnd = newline ? static_cast<const char *>(newline) + 1 : end;
+        }
+
+        Chunk &chunk = chunks[static_cast<size_t>(i)];
+        chunk.begin = begin;
+        chunk.end = chunkEnd;
+        chunk.commentLines = 0;
+        chunk.rejectedLines = 0;
+        begin = chunkEnd;
+    }
+
+    // 第一段在当前线程解析, 其余各段各用一个线程
+    std::vector<std::thread> threads;
+    threads.reserve(chunks.size() - 1);
+    for (size_t i = 1; i < chunks.size(); ++i) {
+        threads.emplace_back(&TextSampleParser::parseChunk, std::ref(chunks[i]));
+    }
+    parseChunk(chunks[0]);
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    int total = 0;
+    for (const Chunk &chunk : chunks) {
+        total += chunk.samples.size();
+        m_commentLines += chunk.commentLines;
+        m_rejectedLines += chunk.rejectedLines;
+    }
+
+    m_samples.resize(total);
+    double *output = m_samples.data();
+    for (const Chunk &chunk : chunks) {
+        std::memcpy(output, chunk.samples.constData(), sizeof(double) * chunk.samples.size());
+        output += chunk.samples.size();
+    }
+}
+
+void TextSampleParser::setThreadCount(int threadCount)
+{
+    m_threadCount = qMax(0, threadCount);
+}
+
+int TextSampleParser::getThreadCount() const
+{
+    return m_threadCount;
+}
+
+QVector<double> TextSampleParser::getSamples() const
+{
+    return m_samples;
+}
+
+qint64 TextSampleParser::getCommentLineCount() const
+{
+    return m_commentLines;
+}
+
+qint64 TextSampleParser::getRejectedLineCount() const
+{
+    return m_rejectedLines;
+}
+
+QString TextSampleParser::errorString() const
+{
+    return m_errorString;
+}
+
+void TextSampleParser::parseChunk(Chunk &chunk)
+{
+    // 按平均每行约8字节预估样本数, 减少扩容次数
+    chunk.samples.reserve(static_cast<int>((chunk.end - chunk.begin) / 8));
+
+    const char *line = chunk.begin;
+    while (line < chunk.end) {
+        const void *newline = std::memchr(line, '\n', static_cast<size_t>(chunk.end - line));
+        const char *lineEnd = newline ? static_cast<const char *>(newline) : chunk.end;
+        const char *next = newline ? lineEnd + 1 : chunk.end;
+
+        // 去掉首尾空白 (包括 Windows 换行的 '\r')
+        while (line < lineEnd && isBlank(*line)) {
+            ++line;
+        }
+        while (lineEnd > line && isBlank(lineEnd[-1])) {
+            --lineEnd;
+        }
+
+        if (line == lineEnd) {
+            // 空行
+        } else if (*line == '#') {
+            ++chunk.commentLines;
+        } else {
+            double value;
+            if (parseDouble(line, lineEnd, value)) {
+                chunk.samples.append(value);
+            } else {
+                ++chunk.rejectedLines;
+            }
+        }
+
+        line = next;
+    }
+}
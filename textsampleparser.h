@@ -0,0 +1,49 @@
+#ifndef TEXTSAMPLEPARSER_H
+#define TEXTSAMPLEPARSER_H
+
+#include <QString>
+#include <QVector>
+
+// 文本采样文件解析器 (每行一个数值)
+// 文件映射到内存后按换行边界切分成若干段, 由多个线程并行解析 (std::from_chars),
+// 结果按原顺序拼接. 以 '#' 开头的注释行 (例如 saveDataToFile 写入的文件头) 和空行被跳过,
+// 无法解析为数值的行计入无效行数.
+class TextSampleParser
+{
+public:
+    TextSampleParser();
+
+    bool parseFile(const QString &filePath);
+    void parse(const char *data, qint64 size);
+
+    // 线程数, 0 表示按CPU核数自动选择
+    void setThreadCount(int threadCount);
+    int getThreadCount() const;
+
+    QVector<double> getSamples() const;
+    qint64 getCommentLineCount() const;
+    qint64 getRejectedLineCount() const;
+    QString errorString() const;
+
+    // 每个线程至少处理的字节数, 小文件不值得启动额外线程
+    static const qint64 MIN_CHUNK_BYTES = 1 << 20;
+
+private:
+    struct Chunk {
+        const char *begin;
+        const char *end;
+        QVector<double> samples;
+        qint64 commentLines;
+        qint64 rejectedLines;
+    };
+
+    static void parseChunk(Chunk &chunk);
+
+    int m_threadCount;
+    QVector<double> m_samples;
+    qint64 m_commentLines;
+    qint64 m_rejectedLines;
+    QString m_errorString;
+};
+
+#endif // TEXTSAMPLEPARSER_H
@@ -0,0 +1,79 @@
+#include "windowfunction.h"
+
+#include <QtMath>
+
+namespace WindowFunction {
+
+// 第一类零阶修正贝塞尔函数, 级数求和直到项小于和的 1e-16
+static double besselI0(double x)
+{
+    const double quarterSquare = 0.25 * x * x;
+    double term = 1.0;
+    double sum = 1.0;
+    for (int k = 1; term > 1e-16 * sum; ++k) {
+        term *= quarterSquare / (static_cast<double>(k) * k);
+        sum += term;
+    }
+    return sum;
+}
+
+QVector<double> generate(Type type, int length, double beta)
+{
+    QVector<double> window(qMax(length, 0), 1.0);
+    if (length <= 1 || type == Rectangular) {
+        return window;
+    }
+
+    const double scale = 1.0 / (length - 1);
+    const double kaiserNorm = 1.0 / besselI0(beta);
+    for (int n = 0; n < length; ++n) {
+        const double x = n * scale;     // 0..1
+        switch (type) {
+        case Hann:
+            window[n] = 0.5 - 0.5 * std::cos(2.0 * M_PI * x);
+            break;
+        case Hamming:
+            window[n] = 0.54 - 0.46 * std::cos(2.0 * M_PI * x);
+            break;
+        case Blackman:
+            window[n] = 0.42 - 0.5 * std::cos(2.0 * M_PI * x) + 0.08 * std::cos(4.0 * M_PI * x);
+            break;
+        case BlackmanHarris:
+            window[n] = 0.35875 - 0.48829 * std::cos(2.0 * M_PI * x) + 0.14128 * std::cos(4.0 * M_PI * x)
+                    - 0.01168 * std::cos(6.0 * M_PI * x);
+            break;
+        case FlatTop:
+            window[n] = 0.21557895 - 0.41663158 * std::cos(2.0 * M_PI * x) + 0.277263158 * std::cos(4.0 * M_PI * x)
+                    - 0.083578947 * std::cos(6.0 * M_PI * x) + 0.006947368 * std::cos(8.0 * M_PI * x);
+            break;
+        case Kaiser: {
+            const double r = 2.0 * x - 1.0;
+            window[n] = besselI0(beta * std::sqrt(qMax(0.0, 1.0 - r * r))) * kaiserNorm;
+            break;
+        }
+        default:
+            break;
+        }
+    }
+    return window;
+}
+
+QVector<double> generatePeriodic(Type type, int length, double beta)
+{
+    QVector<double> window = generate(type, qMax(length, 0) + 1, beta);
+    window.removeLast();
+    return window;
+}
+
+double kaiserBeta(double attenuationDb)
+{
+    if (attenuationDb > 50.0) {
+        return 0.1102 * (attenuationDb - 8.7);
+    }
+    if (attenuationDb >= 21.0) {
+        return 0.5842 * std::pow(attenuationDb - 21.0, 0.4) + 0.07886 * (attenuationDb - 21.0);
+    }
+    return 0.0;
+}
+
+} // namespace WindowFunction
@@ -0,0 +1,29 @@
+#ifndef WINDOWFUNCTION_H
+#define WINDOWFUNCTION_H
+
+#include <QVector>
+
+// 窗函数: FIR滤波器设计用对称窗 (两端点 n = 0 和 n = L-1 对称),
+// 频谱分析 (STFT) 用周期窗 (长度 L+1 的对称窗去掉最后一点, 按 L 点周期延拓后连续)
+namespace WindowFunction {
+
+enum Type {
+    Rectangular,
+    Hann,
+    Hamming,
+    Blackman,
+    Kaiser,
+    BlackmanHarris,     // 4项, 旁瓣 -92 dB
+    FlatTop             // 5项, 幅度误差小于 0.01 dB, 用于读取正弦分量的幅度
+};
+
+// 长度为 length 的窗, Kaiser 窗的形状由 beta 决定 (其他窗忽略)
+QVector<double> generate(Type type, int length, double beta = 8.6);
+QVector<double> generatePeriodic(Type type, int length, double beta = 8.6);
+
+// Kaiser 窗达到 attenuationDb 阻带衰减所需的 beta (Kaiser 经验公式)
+double kaiserBeta(double attenuationDb);
+
+} // namespace WindowFunction
+
+#endif // WINDOWFUNCTION_H